@@ -13,9 +13,16 @@
 #include "erin_next/erin_next_utils.h"
 #include "erin_next/erin_next_validation.h"
 #include "erin_next/erin_next_graph.h"
+#include "erin_next/erin_next_profile.h"
+#include "erin_next/erin_next_trace.h"
+#include "erin_next/erin_next_synthetic.h"
+#include <chrono>
+#include <cmath>
 #include <cstdlib>
+#include <fstream>
 #include <iostream>
 #include <limits>
+#include <optional>
 #include <string>
 #include <filesystem>
 #include <unordered_map>
@@ -105,6 +112,56 @@ add_limits(CLI::App& app)
     return subcommand;
 }
 
+// writes the resource use of a run as JSON for the regression harness;
+// values are integers so the CMake harness can compare them with math()
+bool
+write_run_metrics(
+    std::string const& metricsFilename,
+    std::string const& inputFilename,
+    double wallTime_s,
+    erin::SimulationRunMetrics const& metrics,
+    std::vector<std::string> const& outputPaths
+)
+{
+    uint64_t outputBytes = 0;
+    for (std::string const& path : outputPaths)
+    {
+        std::error_code ec;
+        uintmax_t size = std::filesystem::file_size(path, ec);
+        if (!ec)
+        {
+            outputBytes += static_cast<uint64_t>(size);
+        }
+    }
+    std::ofstream ofs(metricsFilename, std::ios_base::binary);
+    if (!ofs.good())
+    {
+        return false;
+    }
+    ofs << "{\n"
+        << fmt::format(
+               "  \"input\": \"{}\",\n",
+               std::filesystem::path(inputFilename).filename().string()
+           )
+        << fmt::format(
+               "  \"wall_time_us\": {},\n", std::llround(wallTime_s * 1e6)
+           )
+        << fmt::format(
+               "  \"cpu_time_us\": {},\n",
+               std::llround(erin::GetProcessCpuTime_s() * 1e6)
+           )
+        << fmt::format(
+               "  \"peak_rss_bytes\": {},\n",
+               erin::GetPeakResidentSetSize_bytes()
+           )
+        << fmt::format(
+               "  \"occurrences\": {},\n", metrics.OccurrencesSimulated
+           )
+        << fmt::format("  \"events\": {},\n", metrics.EventsSimulated)
+        << fmt::format("  \"output_bytes\": {}\n", outputBytes) << "}\n";
+    return true;
+}
+
 CLI::App*
 add_run(CLI::App& app)
 {
@@ -135,6 +192,16 @@ add_run(CLI::App& app)
         )
         ->check(CLI::PositiveNumber);
 
+    static std::string time_step_mode = "sample";
+    subcommand
+        ->add_option(
+            "--time_step_mode",
+            time_step_mode,
+            "How flows are reported with a uniform time step: sample, mean, "
+            "energy, or max; default: sample"
+        )
+        ->check(CLI::IsMember({"sample", "mean", "energy", "max"}));
+
     static bool verbose = false;
     subcommand->add_flag("-v,--verbose", verbose, "Verbose output");
 
@@ -150,12 +217,120 @@ add_run(CLI::App& app)
         "Save reliability curves"
     );
 
+    static bool changes_only = false;
+    subcommand->add_flag(
+        "--changes-only",
+        changes_only,
+        "Only write event rows whose reported values changed"
+    );
+
+    static bool reduce_model = false;
+    subcommand->add_flag(
+        "--reduce",
+        reduce_model,
+        "Collapse chains of pass-throughs and of converters in series and "
+        "merge loads on muxer outports that cannot fail before simulating"
+    );
+
+    static double coarsen_h = -1.0;
+    subcommand
+        ->add_option(
+            "--coarsen",
+            coarsen_h,
+            "Resample load and supply schedules to a coarser time step "
+            "(hours) before simulating"
+        )
+        ->check(CLI::PositiveNumber);
+
+    static std::string coarsen_mode = "mean";
+    subcommand
+        ->add_option(
+            "--coarsen_mode",
+            coarsen_mode,
+            "Amount used for each coarsened time step: mean or max; "
+            "default: mean"
+        )
+        ->check(CLI::IsMember({"mean", "max"}));
+
+    static bool compact_schedules = false;
+    subcommand->add_flag(
+        "--compact-schedules",
+        compact_schedules,
+        "Drop load and supply schedule entries that repeat the amount before "
+        "them"
+    );
+
+    static std::string shardText;
+    subcommand->add_option(
+        "--shard",
+        shardText,
+        "Run shard i of N (given as i/N) and write partial output files; "
+        "merged shards match an unsharded run with the same seed"
+    );
+
+    static std::string profileFilename;
+    subcommand->add_option(
+        "--profile",
+        profileFilename,
+        "Write time per phase and engine counters, per occurrence, to a JSON "
+        "file"
+    );
+
+    static std::string traceFilename;
+    subcommand->add_option(
+        "--trace",
+        traceFilename,
+        "Write a Chrome/Perfetto trace of scenarios, occurrences, events, "
+        "and iterations to a JSON file"
+    );
+
+    static std::string hotspotsFilename;
+    subcommand->add_option(
+        "--hotspots",
+        hotspotsFilename,
+        "Write kernel runs, re-activations, oscillations, and switch flips "
+        "per component and connection, ranked by solver work, to a CSV file"
+    );
+
+    static std::string metricsFilename;
+    subcommand->add_option(
+        "--metrics",
+        metricsFilename,
+        "Write wall time, CPU time, peak memory, events, and output size "
+        "to a JSON file"
+    );
+
     auto run = [&]()
     {
         using namespace erin;
+        auto startTime = std::chrono::steady_clock::now();
         Logger logger{};
         Log log = get_standard_log(logger);
+        if (!profileFilename.empty())
+        {
+            Profile_Enable();
+        }
+        if (!traceFilename.empty())
+        {
+            Trace_Enable();
+        }
+        if (!hotspotsFilename.empty())
+        {
+            Hotspots_Enable();
+        }
         bool aggregate_groups = !no_aggregate_groups;
+        std::optional<ShardSpec> shard = {};
+        if (!shardText.empty())
+        {
+            shard = ShardSpec_Parse(shardText);
+            if (!shard.has_value())
+            {
+                Log_Error(
+                    log, fmt::format("Invalid shard '{}'; use i/N", shardText)
+                );
+                return EXIT_FAILURE;
+            }
+        }
         if (verbose)
         {
             std::cout << "input file: " << tomlFilename << std::endl;
@@ -164,6 +339,8 @@ add_run(CLI::App& app)
             if (time_step_h > 0.0)
             {
                 std::cout << "time step (h): " << time_step_h << std::endl;
+                std::cout << "time step mode: " << time_step_mode
+                          << std::endl;
             }
             std::cout << "save reliability curves: "
                       << (save_reliability_curves ? "true" : "false")
@@ -172,6 +349,22 @@ add_run(CLI::App& app)
                       << std::endl;
             std::cout << "groups: " << (aggregate_groups ? "true" : "false")
                       << std::endl;
+            std::cout << "changes only: " << (changes_only ? "true" : "false")
+                      << std::endl;
+            std::cout << "reduce: " << (reduce_model ? "true" : "false")
+                      << std::endl;
+            if (coarsen_h > 0.0)
+            {
+                std::cout << "coarsen (h): " << coarsen_h << std::endl;
+                std::cout << "coarsen mode: " << coarsen_mode << std::endl;
+            }
+            std::cout << "compact schedules: "
+                      << (compact_schedules ? "true" : "false") << std::endl;
+            if (shard.has_value())
+            {
+                std::cout << "shard: " << shard->Index << "/" << shard->Count
+                          << std::endl;
+            }
         }
         std::ifstream ifs(tomlFilename, std::ios_base::binary);
         if (!ifs.good())
@@ -180,7 +373,11 @@ add_run(CLI::App& app)
             return EXIT_FAILURE;
         }
         auto nameOnly = std::filesystem::path(tomlFilename).filename();
-        toml::value data = toml::parse(ifs, nameOnly.string());
+        toml::value data;
+        {
+            ProfileTimer timer{ProfilePhase::ParseToml};
+            data = toml::parse(ifs, nameOnly.string());
+        }
         ifs.close();
         std::unordered_set<std::string> componentTagsInUse =
             TOMLTable_ParseComponentTagsInUse(data);
@@ -199,7 +396,48 @@ add_run(CLI::App& app)
             Simulation_Print(s);
             Log_Info(log, "-----------------");
         }
-        Simulation_Run(
+        if (coarsen_h > 0.0)
+        {
+            ScheduleCoarsening coarsening = Simulation_CoarsenSchedules(
+                s, coarsen_h, TagToResampleMode(coarsen_mode).value()
+            );
+            Log_Info(
+                log,
+                fmt::format(
+                    "schedule coarsening reduced {} entries to {}",
+                    coarsening.NumEntries,
+                    coarsening.NumCoarseEntries
+                )
+            );
+        }
+        if (compact_schedules)
+        {
+            ScheduleCompaction compaction = Simulation_CompactSchedules(s);
+            Log_Info(
+                log,
+                fmt::format(
+                    "schedule compaction removed {} of {} entries; {} "
+                    "uniform-step schedules kept as they are",
+                    compaction.NumEntriesRemoved,
+                    compaction.NumEntries,
+                    compaction.NumUniformSchedulesKept
+                )
+            );
+        }
+        if (reduce_model)
+        {
+            size_t numConnections = s.TheModel.Connections.size();
+            size_t numEliminated = Simulation_ReduceModel(s);
+            Log_Info(
+                log,
+                fmt::format(
+                    "model reduction eliminated {} of {} connections",
+                    numEliminated,
+                    numConnections
+                )
+            );
+        }
+        SimulationRunMetrics metrics = Simulation_Run(
             s,
             log,
             eventsFilename,
@@ -207,8 +445,82 @@ add_run(CLI::App& app)
             time_step_h,
             aggregate_groups,
             save_reliability_curves,
-            verbose
+            verbose,
+            shard,
+            TagToResampleMode(time_step_mode).value(),
+            changes_only
         );
+        if (coarsen_h > 0.0)
+        {
+            Log_Info(
+                log,
+                fmt::format("simulated {} events", metrics.EventsSimulated)
+            );
+        }
+        if (verbose && !profileFilename.empty())
+        {
+            Profile_PrintCounters(TheProfile);
+        }
+        if (!profileFilename.empty()
+            && Profile_WriteJson(TheProfile, profileFilename)
+                == Result::Failure)
+        {
+            Log_Error(
+                log,
+                fmt::format("Could not open '{}' for writing", profileFilename)
+            );
+            return EXIT_FAILURE;
+        }
+        if (!traceFilename.empty()
+            && Trace_WriteJson(traceFilename) == Result::Failure)
+        {
+            Log_Error(
+                log,
+                fmt::format("Could not open '{}' for writing", traceFilename)
+            );
+            return EXIT_FAILURE;
+        }
+        if (!hotspotsFilename.empty()
+            && Hotspots_WriteCsv(TheHotspots, s.TheModel, hotspotsFilename)
+                == Result::Failure)
+        {
+            Log_Error(
+                log,
+                fmt::format("Could not open '{}' for writing", hotspotsFilename)
+            );
+            return EXIT_FAILURE;
+        }
+        if (!metricsFilename.empty())
+        {
+            std::chrono::duration<double> wallTime =
+                std::chrono::steady_clock::now() - startTime;
+            std::vector<std::string> outputPaths{
+                eventsFilename, statsFilename
+            };
+            if (shard.has_value())
+            {
+                for (std::string& path : outputPaths)
+                {
+                    path = ShardSpec_FilePath(path, *shard);
+                }
+            }
+            if (!write_run_metrics(
+                    metricsFilename,
+                    tomlFilename,
+                    wallTime.count(),
+                    metrics,
+                    outputPaths
+                ))
+            {
+                Log_Error(
+                    log,
+                    fmt::format(
+                        "Could not open '{}' for writing", metricsFilename
+                    )
+                );
+                return EXIT_FAILURE;
+            }
+        }
         return EXIT_SUCCESS;
     };
 
@@ -217,6 +529,177 @@ add_run(CLI::App& app)
     return subcommand;
 }
 
+CLI::App*
+add_merge(CLI::App& app)
+{
+    auto subcommand = app.add_subcommand(
+        "merge",
+        "Merge the partial output files of a sharded run; the result matches "
+        "an unsharded run with the same seed"
+    );
+
+    static size_t numShards = 0;
+    subcommand->add_option("num_shards", numShards, "Number of shards")
+        ->required();
+
+    static std::string eventsFilename = "out.csv";
+    subcommand->add_option(
+        "-e,--events", eventsFilename, "Events csv filename; default:out.csv"
+    );
+
+    static std::string statsFilename = "stats.csv";
+    subcommand->add_option(
+        "-s,--statistics",
+        statsFilename,
+        "Statistics csv filename; default:stats.csv"
+    );
+
+    auto merge = [&]()
+    {
+        using namespace erin;
+        Logger logger{};
+        Log log = get_standard_log(logger);
+        Result result = Simulation_MergeShards(
+            eventsFilename, statsFilename, numShards, log
+        );
+        return result == Result::Success ? EXIT_SUCCESS : EXIT_FAILURE;
+    };
+
+    subcommand->callback(
+        [&]()
+        {
+            int exitCode = merge();
+            if (exitCode != EXIT_SUCCESS)
+            {
+                throw CLI::RuntimeError(exitCode);
+            }
+        }
+    );
+
+    return subcommand;
+}
+
+CLI::App*
+add_generate(CLI::App& app)
+{
+    auto subcommand = app.add_subcommand(
+        "generate", "Generate a synthetic district model for stress testing"
+    );
+
+    static std::string tomlFilename;
+    subcommand->add_option("toml_file", tomlFilename, "TOML output filename")
+        ->required();
+
+    static erin::SyntheticModelOptions options{};
+    subcommand->add_option(
+        "-b,--buildings", options.NumBuildings, "Number of buildings"
+    );
+    subcommand->add_option(
+        "-d,--depth", options.NetworkDepth, "Levels of muxes above buildings"
+    );
+    subcommand
+        ->add_option(
+            "--storage-fraction",
+            options.StorageFraction,
+            "Fraction of buildings with a battery"
+        )
+        ->check(CLI::Range(0.0, 1.0));
+    subcommand
+        ->add_option(
+            "--failure-density",
+            options.FailureModeDensity,
+            "Probability of a component having failure/fragility modes"
+        )
+        ->check(CLI::Range(0.0, 1.0));
+    subcommand->add_option(
+        "--scenarios", options.NumScenarios, "Number of scenarios"
+    );
+    subcommand->add_option(
+        "--occurrences",
+        options.NumOccurrences,
+        "Maximum occurrences per scenario"
+    );
+    subcommand->add_option(
+        "--profiles", options.NumLoadProfiles, "Number of load profiles"
+    );
+    subcommand
+        ->add_option(
+            "--duration_h",
+            options.ScenarioDuration_h,
+            "Scenario duration (hours)"
+        )
+        ->check(CLI::PositiveNumber);
+    subcommand->add_option("--seed", options.Seed, "Random seed");
+
+    static bool writeLoadFiles = false;
+    subcommand->add_flag(
+        "-l,--load-files",
+        writeLoadFiles,
+        "Write load profiles to csv files next to the TOML file"
+    );
+
+    auto generate = [&]()
+    {
+        using namespace erin;
+        Logger logger{};
+        Log log = get_standard_log(logger);
+        if (options.NumBuildings == 0 || options.NetworkDepth == 0
+            || options.NumScenarios == 0 || options.NumLoadProfiles == 0)
+        {
+            Log_Error(
+                log,
+                "buildings, depth, scenarios, and profiles must be positive"
+            );
+            return EXIT_FAILURE;
+        }
+        std::string loadFilePrefix = "";
+        if (writeLoadFiles)
+        {
+            std::filesystem::path path{tomlFilename};
+            loadFilePrefix =
+                (path.parent_path() / (path.stem().string() + "-")).string();
+        }
+        SyntheticModel model = SyntheticModel_Generate(options, loadFilePrefix);
+        for (LoadProfileFile const& file : model.LoadFiles)
+        {
+            std::ofstream ofs(file.Path, std::ios_base::binary);
+            if (!ofs.good())
+            {
+                Log_Error(
+                    log,
+                    fmt::format("Could not open '{}' for writing", file.Path)
+                );
+                return EXIT_FAILURE;
+            }
+            ofs << file.Contents;
+        }
+        std::ofstream ofs(tomlFilename, std::ios_base::binary);
+        if (!ofs.good())
+        {
+            Log_Error(
+                log,
+                fmt::format("Could not open '{}' for writing", tomlFilename)
+            );
+            return EXIT_FAILURE;
+        }
+        ofs << model.Toml;
+        return EXIT_SUCCESS;
+    };
+
+    subcommand->callback(
+        [&]()
+        {
+            int exitCode = generate();
+            if (exitCode != EXIT_SUCCESS)
+            {
+                throw CLI::RuntimeError(exitCode);
+            }
+        }
+    );
+
+    return subcommand;
+}
+
 CLI::App*
 add_graph(CLI::App& app)
 {
@@ -628,6 +1111,8 @@ main(int argc, char** argv)
     add_version(app);
     add_limits(app);
     add_run(app);
+    add_merge(app);
+    add_generate(app);
     add_graph(app);
     add_checkNetwork(app);
     add_update(app);
@@ -0,0 +1,519 @@
+/* Copyright (c) 2024 Big Ladder Software LLC. All rights reserved.
+ * See the LICENSE.txt file for additional terms and conditions. */
+#include "erin_next/erin_next.h"
+#include "erin_next/erin_next_distribution.h"
+#include "erin_next/erin_next_random.h"
+#include "erin_next/erin_next_simulation.h"
+#include "erin_next/erin_next_units.h"
+#include "erin_next/erin_next_utils.h"
+#include "erin_next/erin_next_validation.h"
+#include "erin_next/erin_next_toml.h"
+#include <benchmark/benchmark.h>
+#include <toml.hpp>
+#include <sstream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+using namespace erin;
+
+// NOTE: every benchmark takes a scaling parameter, state.range(0), which is
+// the number of components (or items) in the problem; run with
+// --benchmark_filter=<regex> to measure one hot path in isolation
+
+static std::vector<TimeAndAmount>
+HourlyLoads(size_t numHours, flow_t peak_W)
+{
+    std::vector<TimeAndAmount> timesAndLoads;
+    timesAndLoads.reserve(numHours + 1);
+    for (size_t i = 0; i <= numHours; ++i)
+    {
+        flow_t load_W = (i % 2 == 0) ? peak_W : peak_W / 2;
+        timesAndLoads.push_back(
+            TimeAndAmount{static_cast<double>(i) * seconds_per_hour, load_W}
+        );
+    }
+    return timesAndLoads;
+}
+
+// source -> n pass-throughs -> load
+static void
+AddChain(Model& m, size_t n)
+{
+    size_t srcId = Model_AddConstantSource(m, 1'000);
+    size_t prevId = srcId;
+    for (size_t i = 0; i < n; ++i)
+    {
+        size_t ptId = Model_AddPassThrough(m);
+        Model_AddConnection(m, prevId, 0, ptId, 0);
+        prevId = ptId;
+    }
+    size_t loadId = Model_AddScheduleBasedLoad(m, HourlyLoads(24, 800));
+    Model_AddConnection(m, prevId, 0, loadId, 0);
+}
+
+// n sources -> mux -> load
+static void
+AddFanInMux(Model& m, size_t n)
+{
+    size_t muxId = Model_AddMux(m, n, 1);
+    for (size_t i = 0; i < n; ++i)
+    {
+        size_t srcId = Model_AddConstantSource(m, 10);
+        Model_AddConnection(m, srcId, 0, muxId, i);
+    }
+    size_t loadId = Model_AddScheduleBasedLoad(
+        m, HourlyLoads(24, static_cast<flow_t>(8 * n))
+    );
+    Model_AddConnection(m, muxId, 0, loadId, 0);
+}
+
+// n of: source -> store -> load
+static void
+AddStores(Model& m, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        size_t srcId = Model_AddConstantSource(m, 50);
+        size_t storeId = Model_AddStore(m, 3'600'000, 100, 100, 1'800'000, 0);
+        size_t loadId = Model_AddScheduleBasedLoad(m, HourlyLoads(24, 80));
+        Model_AddConnection(m, srcId, 0, storeId, 0);
+        Model_AddConnection(m, storeId, 0, loadId, 0);
+    }
+}
+
+// n of: (primary, secondary) sources -> switch -> load
+static void
+AddSwitches(Model& m, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        size_t primaryId = Model_AddConstantSource(m, 50, 0, "");
+        size_t secondaryId = Model_AddConstantSource(m, 100, 0, "");
+        size_t switchId = Model_AddSwitch(m, 0, "");
+        size_t loadId = Model_AddScheduleBasedLoad(m, HourlyLoads(24, 80));
+        Model_AddConnection(m, primaryId, 0, switchId, 0);
+        Model_AddConnection(m, secondaryId, 0, switchId, 1);
+        Model_AddConnection(m, switchId, 0, loadId, 0);
+    }
+}
+
+static Model
+MakeModel(void (*addTopology)(Model&, size_t), size_t n)
+{
+    Model m{};
+    m.RandFn = []() { return 0.4; };
+    m.FinalTime = 24.0 * seconds_per_hour;
+    addTopology(m, n);
+    return m;
+}
+
+static void
+ActivateLoadsAtStart(Model const& m, SimulationState& ss)
+{
+    ActivateConnectionsForConstantLoads(m, ss);
+    ActivateConnectionsForScheduleBasedLoads(m, ss, 0.0);
+}
+
+static void
+ActivateSourcesAtStart(Model& m, SimulationState& ss)
+{
+    ActivateConnectionsForConstantSources(m, ss);
+    ActivateConnectionsForScheduleBasedSources(m, ss, 0.0);
+    ActivateConnectionsForStores(m, ss, 0.0);
+}
+
+static void
+RunBackward(benchmark::State& state, void (*addTopology)(Model&, size_t))
+{
+    size_t n = static_cast<size_t>(state.range(0));
+    Model m = MakeModel(addTopology, n);
+    SimulationState initial{};
+    Model_SetupSimulationState(m, initial);
+    ActivateLoadsAtStart(m, initial);
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        SimulationState ss = initial;
+        state.ResumeTiming();
+        RunConnectionsBackward(m, ss);
+        benchmark::DoNotOptimize(ss.Flows.data());
+    }
+    state.SetComplexityN(state.range(0));
+}
+
+static void
+RunForward(benchmark::State& state, void (*addTopology)(Model&, size_t))
+{
+    size_t n = static_cast<size_t>(state.range(0));
+    Model m = MakeModel(addTopology, n);
+    SimulationState initial{};
+    Model_SetupSimulationState(m, initial);
+    ActivateLoadsAtStart(m, initial);
+    RunConnectionsBackward(m, initial);
+    ActivateSourcesAtStart(m, initial);
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        SimulationState ss = initial;
+        state.ResumeTiming();
+        RunConnectionsForward(m, ss);
+        benchmark::DoNotOptimize(ss.Flows.data());
+    }
+    state.SetComplexityN(state.range(0));
+}
+
+BENCHMARK_CAPTURE(RunBackward, chain, AddChain)
+    ->RangeMultiplier(8)
+    ->Range(8, 4'096)
+    ->Complexity();
+BENCHMARK_CAPTURE(RunBackward, fan_in_mux, AddFanInMux)
+    ->RangeMultiplier(8)
+    ->Range(8, 4'096)
+    ->Complexity();
+BENCHMARK_CAPTURE(RunBackward, stores, AddStores)
+    ->RangeMultiplier(8)
+    ->Range(8, 4'096)
+    ->Complexity();
+BENCHMARK_CAPTURE(RunBackward, switches, AddSwitches)
+    ->RangeMultiplier(8)
+    ->Range(8, 4'096)
+    ->Complexity();
+BENCHMARK_CAPTURE(RunForward, chain, AddChain)
+    ->RangeMultiplier(8)
+    ->Range(8, 4'096)
+    ->Complexity();
+BENCHMARK_CAPTURE(RunForward, fan_in_mux, AddFanInMux)
+    ->RangeMultiplier(8)
+    ->Range(8, 4'096)
+    ->Complexity();
+BENCHMARK_CAPTURE(RunForward, stores, AddStores)
+    ->RangeMultiplier(8)
+    ->Range(8, 4'096)
+    ->Complexity();
+BENCHMARK_CAPTURE(RunForward, switches, AddSwitches)
+    ->RangeMultiplier(8)
+    ->Range(8, 4'096)
+    ->Complexity();
+
+static void
+BM_EarliestNextEvent(benchmark::State& state)
+{
+    Model m = MakeModel(AddStores, static_cast<size_t>(state.range(0)));
+    SimulationState ss{};
+    Model_SetupSimulationState(m, ss);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(EarliestNextEvent(m, ss, 0.0));
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_EarliestNextEvent)
+    ->RangeMultiplier(8)
+    ->Range(8, 4'096)
+    ->Complexity();
+
+static void
+BM_MuxBalanceRequestFlows(benchmark::State& state)
+{
+    size_t n = static_cast<size_t>(state.range(0));
+    SimulationState ss{};
+    ss.Flows.resize(n);
+    std::vector<size_t> inflowConns(n, 0);
+    for (size_t i = 0; i < n; ++i)
+    {
+        ss.Flows[i].Available_W = 10;
+        inflowConns[i] = i;
+    }
+    flow_t request_W = static_cast<flow_t>(8 * n);
+    for (auto _ : state)
+    {
+        Mux_BalanceRequestFlows(ss, inflowConns, request_W, false);
+        benchmark::DoNotOptimize(ss.Flows.data());
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_MuxBalanceRequestFlows)
+    ->RangeMultiplier(8)
+    ->Range(8, 4'096)
+    ->Complexity();
+
+// a simulated store model along with what is needed to report on it
+struct SimulatedStores
+{
+    Simulation S;
+    std::vector<TimeAndFlows> Results;
+    std::vector<size_t> ConnOrder;
+    std::vector<size_t> StoreOrder;
+    std::vector<size_t> CompOrder;
+};
+
+static SimulatedStores
+SimulateStores(size_t n)
+{
+    SimulatedStores sim{};
+    Simulation_Init(sim.S);
+    sim.S.TheModel = MakeModel(AddStores, n);
+    sim.Results = Simulate(sim.S.TheModel, false);
+    for (size_t i = 0; i < sim.S.TheModel.Connections.size(); ++i)
+    {
+        sim.ConnOrder.push_back(i);
+    }
+    for (size_t i = 0; i < sim.S.TheModel.Stores.size(); ++i)
+    {
+        sim.StoreOrder.push_back(i);
+    }
+    for (size_t i = 0; i < sim.S.TheModel.ComponentMap.Tag.size(); ++i)
+    {
+        sim.CompOrder.push_back(i);
+    }
+    return sim;
+}
+
+static void
+BM_CalculateScenarioOccurrenceStats(benchmark::State& state)
+{
+    SimulatedStores sim = SimulateStores(static_cast<size_t>(state.range(0)));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(ModelResults_CalculateScenarioOccurrenceStats(
+            0, 1, sim.S.TheModel, sim.S.FlowTypeMap, sim.Results
+        ));
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_CalculateScenarioOccurrenceStats)
+    ->RangeMultiplier(8)
+    ->Range(8, 1'024)
+    ->Complexity();
+
+static void
+BM_WriteResultsToEventFile(benchmark::State& state)
+{
+    SimulatedStores sim = SimulateStores(static_cast<size_t>(state.range(0)));
+    for (auto _ : state)
+    {
+        std::ostringstream out{};
+        WriteResultsToEventFile(
+            out,
+            sim.Results,
+            sim.S,
+            "blue_sky",
+            "P0D",
+            sim.ConnOrder,
+            sim.StoreOrder,
+            sim.CompOrder,
+            TimeUnit::Hour
+        );
+        benchmark::DoNotOptimize(out.str().size());
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_WriteResultsToEventFile)
+    ->RangeMultiplier(8)
+    ->Range(8, 1'024)
+    ->Complexity();
+
+// n buildings, each a utility source feeding a load through a
+// pass-through, with a shared load profile and one scenario
+static std::string
+MakeTomlInput(size_t n)
+{
+    std::ostringstream oss{};
+    oss << "[simulation_info]\n"
+        << "input_format_version = \"0.2\"\n"
+        << "rate_unit = \"kW\"\n"
+        << "quantity_unit = \"kJ\"\n"
+        << "time_unit = \"hours\"\n"
+        << "max_time = 24\n"
+        << "[loads.building]\n"
+        << "time_unit = \"hours\"\n"
+        << "rate_unit = \"kW\"\n"
+        << "time_rate_pairs = [[0.0,1.0],[12.0,2.0],[24.0,0.0]]\n"
+        << "[dist.immediately]\n"
+        << "type = \"fixed\"\n"
+        << "value = 0\n"
+        << "time_unit = \"hours\"\n"
+        << "[scenarios.blue_sky]\n"
+        << "time_unit = \"hours\"\n"
+        << "occurrence_distribution = \"immediately\"\n"
+        << "duration = 24\n"
+        << "max_occurrences = 1\n";
+    for (size_t i = 0; i < n; ++i)
+    {
+        oss << "[components.utility_" << i << "]\n"
+            << "type = \"source\"\n"
+            << "outflow = \"electricity\"\n"
+            << "[components.panel_" << i << "]\n"
+            << "type = \"pass_through\"\n"
+            << "flow = \"electricity\"\n"
+            << "[components.building_" << i << "]\n"
+            << "type = \"load\"\n"
+            << "inflow = \"electricity\"\n"
+            << "loads_by_scenario.blue_sky = \"building\"\n";
+    }
+    oss << "[network]\n"
+        << "connections = [\n";
+    for (size_t i = 0; i < n; ++i)
+    {
+        oss << "  [\"utility_" << i << ":OUT(0)\", \"panel_" << i
+            << ":IN(0)\", \"electricity\"],\n"
+            << "  [\"panel_" << i << ":OUT(0)\", \"building_" << i
+            << ":IN(0)\", \"electricity\"],\n";
+    }
+    oss << "]\n";
+    return oss.str();
+}
+
+static void
+BM_ReadFromToml(benchmark::State& state)
+{
+    std::string input = MakeTomlInput(static_cast<size_t>(state.range(0)));
+    InputValidationMap validationInfo = SetupGlobalValidationInfo();
+    Log log{};
+    for (auto _ : state)
+    {
+        std::istringstream iss{input};
+        toml::value data = toml::parse(iss, "benchmark.toml");
+        std::unordered_set<std::string> componentTagsInUse =
+            TOMLTable_ParseComponentTagsInUse(data);
+        auto maybeSim = Simulation_ReadFromToml(
+            data, validationInfo, componentTagsInUse, log
+        );
+        if (!maybeSim.has_value())
+        {
+            state.SkipWithError("could not read the generated input");
+            break;
+        }
+        benchmark::DoNotOptimize(maybeSim->TheModel.Connections.size());
+    }
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK(BM_ReadFromToml)->RangeMultiplier(8)->Range(8, 1'024)->Complexity();
+
+// NOTE: each distribution type gets its own benchmark family (via
+// BENCHMARK_CAPTURE) so that the complexity fit is per type
+static size_t
+AddDistributionOfType(DistributionSystem& ds, DistType distType)
+{
+    std::string tag = dist_type_to_tag(distType);
+    switch (distType)
+    {
+        case DistType::Fixed:
+            return ds.add_fixed(tag, 3'600.0);
+        case DistType::Uniform:
+            return ds.add_uniform(tag, 0.0, 7'200.0);
+        case DistType::Normal:
+            return ds.add_normal(tag, 36'000.0, 3'600.0);
+        case DistType::Weibull:
+            return ds.add_weibull(tag, 1.5, 36'000.0, 600.0);
+        case DistType::QuantileTable:
+            return ds.add_quantile_table(
+                tag,
+                {0.0, 0.1, 0.2, 0.3, 0.4, 0.5, 0.6, 0.7, 0.8, 0.9, 1.0},
+                {0.0,
+                 100.0,
+                 300.0,
+                 600.0,
+                 1'000.0,
+                 1'500.0,
+                 2'100.0,
+                 2'800.0,
+                 3'600.0,
+                 4'500.0,
+                 5'500.0}
+            );
+    }
+    return ds.add_fixed(tag, 3'600.0);
+}
+
+static void
+BM_DistributionSampleN(benchmark::State& state, DistType distType)
+{
+    size_t n = static_cast<size_t>(state.range(0));
+    DistributionSystem ds{};
+    size_t distId = AddDistributionOfType(ds, distType);
+    Random random = CreateRandomWithSeed(17);
+    std::vector<double> fractions(n, 0.0);
+    for (double& fraction : fractions)
+    {
+        fraction = random();
+    }
+    std::vector<double> out(n, 0.0);
+    for (auto _ : state)
+    {
+        ds.sample_n(distId, fractions, out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK_CAPTURE(BM_DistributionSampleN, fixed, DistType::Fixed)
+    ->RangeMultiplier(8)
+    ->Range(8, 32'768)
+    ->Complexity();
+BENCHMARK_CAPTURE(BM_DistributionSampleN, uniform, DistType::Uniform)
+    ->RangeMultiplier(8)
+    ->Range(8, 32'768)
+    ->Complexity();
+BENCHMARK_CAPTURE(BM_DistributionSampleN, normal, DistType::Normal)
+    ->RangeMultiplier(8)
+    ->Range(8, 32'768)
+    ->Complexity();
+BENCHMARK_CAPTURE(
+    BM_DistributionSampleN,
+    quantile_table,
+    DistType::QuantileTable
+)
+    ->RangeMultiplier(8)
+    ->Range(8, 32'768)
+    ->Complexity();
+BENCHMARK_CAPTURE(BM_DistributionSampleN, weibull, DistType::Weibull)
+    ->RangeMultiplier(8)
+    ->Range(8, 32'768)
+    ->Complexity();
+
+static void
+BM_DistributionNextTimeAdvance(benchmark::State& state, DistType distType)
+{
+    size_t n = static_cast<size_t>(state.range(0));
+    DistributionSystem ds{};
+    size_t distId = AddDistributionOfType(ds, distType);
+    for (auto _ : state)
+    {
+        double sum = 0.0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            sum += ds.next_time_advance(distId);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetComplexityN(state.range(0));
+}
+BENCHMARK_CAPTURE(BM_DistributionNextTimeAdvance, fixed, DistType::Fixed)
+    ->RangeMultiplier(8)
+    ->Range(8, 32'768)
+    ->Complexity();
+BENCHMARK_CAPTURE(BM_DistributionNextTimeAdvance, uniform, DistType::Uniform)
+    ->RangeMultiplier(8)
+    ->Range(8, 32'768)
+    ->Complexity();
+BENCHMARK_CAPTURE(BM_DistributionNextTimeAdvance, normal, DistType::Normal)
+    ->RangeMultiplier(8)
+    ->Range(8, 32'768)
+    ->Complexity();
+BENCHMARK_CAPTURE(
+    BM_DistributionNextTimeAdvance,
+    quantile_table,
+    DistType::QuantileTable
+)
+    ->RangeMultiplier(8)
+    ->Range(8, 32'768)
+    ->Complexity();
+BENCHMARK_CAPTURE(BM_DistributionNextTimeAdvance, weibull, DistType::Weibull)
+    ->RangeMultiplier(8)
+    ->Range(8, 32'768)
+    ->Complexity();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,140 @@
+# Copyright (c) 2024 Big Ladder Software LLC. All rights reserved.
+# See the LICENSE.txt file for additional terms and conditions.
+# Timed regression harness: runs every docs/examples/ex*.toml plus the packed
+# Fort Illinois example with `erin run --metrics`, collects the metrics into
+# one JSON file, and compares them against a checked-in baseline.
+#
+# Usage:
+#   cmake -DERIN_EXE=<path to erin> -DEXAMPLES_DIR=<docs/examples>
+#         -DWORK_DIR=<scratch dir> -DBASELINE=<baseline json>
+#         [-DRESULTS=<results json>] [-DTOLERANCE_PERCENT=25]
+#         [-DTIME_SLACK_US=50000] [-DUPDATE_BASELINE=ON]
+#         -P erin-perf-regress.cmake
+#
+# A metric regresses when it exceeds baseline * (1 + TOLERANCE_PERCENT / 100);
+# times get an extra TIME_SLACK_US of absolute slack as the small examples
+# finish in well under a millisecond. With UPDATE_BASELINE=ON the results
+# replace the baseline instead.
+cmake_minimum_required(VERSION 3.19) # string(JSON)
+
+foreach(required ERIN_EXE EXAMPLES_DIR WORK_DIR BASELINE)
+  if(NOT DEFINED ${required})
+    message(FATAL_ERROR "${required} must be defined")
+  endif()
+endforeach()
+if(NOT DEFINED RESULTS)
+  set(RESULTS "${WORK_DIR}/perf-results.json")
+endif()
+if(NOT DEFINED TOLERANCE_PERCENT)
+  set(TOLERANCE_PERCENT 25)
+endif()
+if(NOT DEFINED TIME_SLACK_US)
+  set(TIME_SLACK_US 50000)
+endif()
+
+set(metric_names
+  wall_time_us cpu_time_us peak_rss_bytes events output_bytes)
+set(time_metric_names wall_time_us cpu_time_us)
+
+# NOTE: examples write their outputs next to their inputs and the packed
+# example needs its loads packed first, so work on a copy
+file(REMOVE_RECURSE "${WORK_DIR}")
+file(MAKE_DIRECTORY "${WORK_DIR}")
+file(COPY "${EXAMPLES_DIR}/" DESTINATION "${WORK_DIR}"
+  PATTERN "*-out.csv" EXCLUDE
+  PATTERN "*-stats.csv" EXCLUDE
+  PATTERN "*.png" EXCLUDE)
+
+# run_example(<name> <dir> <toml>): runs one example and appends its metrics
+# to the `results` JSON object
+function(run_example name dir toml)
+  set(metrics_file "${WORK_DIR}/${name}-metrics.json")
+  execute_process(
+    COMMAND "${ERIN_EXE}" run "${toml}"
+      -e "${WORK_DIR}/${name}-out.csv"
+      -s "${WORK_DIR}/${name}-stats.csv"
+      --metrics "${metrics_file}"
+    WORKING_DIRECTORY "${dir}"
+    RESULT_VARIABLE exit_code
+    OUTPUT_QUIET
+    ERROR_QUIET)
+  if(NOT exit_code EQUAL 0 OR NOT EXISTS "${metrics_file}")
+    message(FATAL_ERROR "erin run failed for ${name}")
+  endif()
+  file(READ "${metrics_file}" metrics)
+  string(JSON updated SET "${results}" examples "${name}" "${metrics}")
+  set(results "${updated}" PARENT_SCOPE)
+endfunction()
+
+set(results "{\"examples\": {}}")
+file(GLOB example_tomls RELATIVE "${WORK_DIR}" "${WORK_DIR}/ex*.toml")
+list(SORT example_tomls)
+foreach(toml IN LISTS example_tomls)
+  get_filename_component(name "${toml}" NAME_WE)
+  message(STATUS "Running ${name}")
+  run_example(${name} "${WORK_DIR}" "${toml}")
+endforeach()
+
+message(STATUS "Packing Fort Illinois loads")
+execute_process(
+  COMMAND "${ERIN_EXE}" pack-loads exft-illinois.toml
+    -o "${WORK_DIR}/ft-illinois_packed/exft-illinois_packed-loads.csv"
+  WORKING_DIRECTORY "${WORK_DIR}/ft-illinois"
+  RESULT_VARIABLE exit_code
+  OUTPUT_QUIET
+  ERROR_QUIET)
+if(NOT exit_code EQUAL 0)
+  message(FATAL_ERROR "erin pack-loads failed for exft-illinois")
+endif()
+message(STATUS "Running exft-illinois_packed")
+run_example(exft-illinois_packed
+  "${WORK_DIR}/ft-illinois_packed" exft-illinois_packed.toml)
+
+file(WRITE "${RESULTS}" "${results}\n")
+message(STATUS "Wrote ${RESULTS}")
+
+if(UPDATE_BASELINE)
+  file(WRITE "${BASELINE}" "${results}\n")
+  message(STATUS "Updated baseline ${BASELINE}")
+  return()
+endif()
+
+if(NOT EXISTS "${BASELINE}")
+  message(FATAL_ERROR "Baseline ${BASELINE} not found; run with UPDATE_BASELINE=ON")
+endif()
+file(READ "${BASELINE}" baseline)
+
+set(num_regressions 0)
+string(JSON num_examples LENGTH "${results}" examples)
+math(EXPR last_example "${num_examples} - 1")
+foreach(idx RANGE ${last_example})
+  string(JSON name MEMBER "${results}" examples ${idx})
+  string(JSON baseline_example ERROR_VARIABLE missing
+    GET "${baseline}" examples "${name}")
+  if(missing)
+    message(STATUS "${name}: not in baseline")
+    continue()
+  endif()
+  foreach(metric IN LISTS metric_names)
+    string(JSON current GET "${results}" examples "${name}" ${metric})
+    string(JSON expected ERROR_VARIABLE missing
+      GET "${baseline_example}" ${metric})
+    if(missing)
+      continue()
+    endif()
+    math(EXPR limit "${expected} + ${expected} * ${TOLERANCE_PERCENT} / 100")
+    if(metric IN_LIST time_metric_names)
+      math(EXPR limit "${limit} + ${TIME_SLACK_US}")
+    endif()
+    if(current GREATER limit)
+      message(STATUS
+        "REGRESSION ${name} ${metric}: ${current} > ${limit} (baseline ${expected})")
+      math(EXPR num_regressions "${num_regressions} + 1")
+    endif()
+  endforeach()
+endforeach()
+
+if(num_regressions GREATER 0)
+  message(FATAL_ERROR "${num_regressions} performance regression(s) found")
+endif()
+message(STATUS "No performance regressions beyond ${TOLERANCE_PERCENT}%")
@@ -11,6 +11,7 @@
 #include "erin_next/erin_next_units.h"
 #include "erin_next/erin_next_result.h"
 #include "erin_next/erin_next_lookup_table.h"
+#include "erin_next/erin_next_profile.h"
 #include "erin/logging.h"
 #include "../vendor/toml11/toml.hpp"
 #include <iostream>
@@ -83,7 +84,7 @@ namespace erin
     struct LoadDict
     {
         std::vector<std::string> Tags;
-        std::vector<std::vector<TimeAndAmount>> Loads;
+        std::vector<AmountSchedule> Loads;
     };
 
     // TODO: enable this in the future. Idea is to return
@@ -169,6 +170,9 @@ namespace erin
         double Downtime_s = 0.0;
         double MaxSEDT_s = 0.0;
         double Availability_s = 0.0;
+        // likelihood ratio of the occurrence's draws under importance
+        // sampling; 1.0 otherwise
+        double Weight = 1.0;
         std::map<size_t, double> AvailabilityByCompId_s;
         // Event Counts
         std::map<size_t, size_t> EventCountByFailureModeId;
@@ -201,7 +205,7 @@ namespace erin
 
     struct ScheduleBasedLoad
     {
-        std::vector<TimeAndAmount> TimesAndLoads;
+        AmountSchedule TimesAndLoads;
         size_t InflowConn;
         std::map<size_t, size_t> ScenarioIdToLoadId;
     };
@@ -220,7 +224,7 @@ namespace erin
 
     struct ScheduleBasedSource
     {
-        std::vector<TimeAndAmount> TimeAndAvails;
+        AmountSchedule TimeAndAvails;
         size_t OutflowConn;
         size_t WasteflowConn;
         std::map<size_t, size_t> ScenarioIdToSourceId;
@@ -237,6 +241,9 @@ namespace erin
         size_t WasteflowConn;
         flow_t MaxOutflow_W = max_flow_W;
         flow_t MaxLossflow_W = max_flow_W;
+        // NOTE: set on both ends of a run of converters collapsed by
+        // Model_Reduce; indexes Model::ReducedChains
+        std::optional<size_t> ReducedChainIdx = {};
     };
 
     struct VariableEfficiencyConverter
@@ -251,6 +258,9 @@ namespace erin
         std::vector<double> InflowsForEfficiency_W;
         // Efficiencies corresponding to the outflows and inflows
         std::vector<double> Efficiencies;
+        // Efficiency lookups prepared from the above
+        LookupTable EfficiencyByOutflow;
+        LookupTable EfficiencyByInflow;
     };
 
     struct Mover
@@ -275,6 +285,9 @@ namespace erin
         std::vector<double> InflowsForCop_W;
         // Coefficient of Performances -- indexed by above two vectors
         std::vector<double> COPs;
+        // COP lookups prepared from the above
+        LookupTable CopByOutflow;
+        LookupTable CopByInflow;
     };
 
     struct Connection
@@ -418,6 +431,39 @@ namespace erin
         flow_t MaxOutflow_W = max_flow_W;
     };
 
+    // A chain of pass-throughs or of constant efficiency converters in
+    // series collapsed by Model_Reduce. The solver only runs the first
+    // (forward) and last (backward) components on the two end connections;
+    // the flows of the connections in between are rebuilt from those.
+    struct ReducedChain
+    {
+        ComponentType Type = ComponentType::PassThroughType;
+        // connections in flow order; stage i goes from ConnIds[i] to
+        // ConnIds[i + 1]
+        std::vector<size_t> ConnIds;
+        // per stage; efficiencies and wasteflows for converters only
+        std::vector<double> Efficiencies;
+        std::vector<flow_t> MaxOutflows_W;
+        std::vector<size_t> WasteflowConns;
+    };
+
+    // A run of schedule-based loads on consecutive unlimited outports of a
+    // mux merged by Model_MergeLoads. The first load carries the summed
+    // schedule on its own outport; the flows of all loads are expanded from
+    // it only while results are recorded.
+    struct LoadMerge
+    {
+        size_t MuxIdx = 0;
+        // schedule-based load indices and their inflow connections in
+        // outport order
+        std::vector<size_t> LoadIdxs;
+        std::vector<size_t> InflowConns;
+        // per load: its own schedule for the current scenario
+        std::vector<AmountSchedule> Schedules;
+        // where the loads' cursors start in SimulationState::MergedLoadIdx
+        size_t FirstCursor = 0;
+    };
+
     struct Flow
     {
         flow_t Requested_W = 0;
@@ -451,6 +497,39 @@ namespace erin
         std::vector<flow_t> StorageAmounts_J;
     };
 
+    // The connections and stores copied into the results at each event.
+    // Projected results hold Flows[k] for ConnIds[k] and StorageAmounts_J[k]
+    // for StoreIdxs[k].
+    struct ResultProjection
+    {
+        std::vector<size_t> ConnIds;
+        std::vector<size_t> StoreIdxs;
+    };
+
+    // Occurrence statistics accumulated one event at a time from the full
+    // simulation state so that the results need not keep all of it
+    struct OccurrenceStatsAccumulator
+    {
+        ScenarioOccurrenceStats Stats;
+        size_t NumEvents = 0;
+        double LastTime_s = 0.0;
+        double InitialStorage_kJ = 0.0;
+        bool WasDown = false;
+        // duration of the current stretch of downtime
+        double Sedt_s = 0.0;
+        // state of the previous event; flows hold until the next event
+        std::vector<Flow> PreviousFlows;
+        std::vector<flow_t> PreviousStorageAmounts_J;
+    };
+
+    // What Simulate_ProcessEvents records at each event. Without a
+    // projection every connection and store is copied.
+    struct ResultCapture
+    {
+        ResultProjection const* Projection = nullptr;
+        OccurrenceStatsAccumulator* Stats = nullptr;
+    };
+
     typedef std::unordered_map<std::string, std::set<std::size_t>>
         GroupToComponentMap;
 
@@ -480,6 +559,8 @@ namespace erin
         std::vector<VariableEfficiencyMover> VarEffMovers;
         std::vector<Switch> Switches;
         std::vector<Connection> Connections;
+        std::vector<ReducedChain> ReducedChains;
+        std::vector<LoadMerge> LoadMerges;
         std::vector<ScheduleBasedReliability> Reliabilities;
         DistributionSystem DistSys{};
         ReliabilityCoordinator Rel{};
@@ -516,11 +597,48 @@ namespace erin
         // a set of component id that are unavailable
         std::set<size_t> UnavailableComponents{};
         std::vector<flow_t> StorageAmounts_J{};
+        // the fraction of a joule each store holds beyond StorageAmounts_J;
+        // carried between steps so that whole-joule steps conserve energy
+        std::vector<double> StorageRemainders_J{};
         std::vector<double> StorageNextEventTimes{};
         std::vector<Flow> Flows{};
         std::vector<size_t> ScheduleBasedLoadIdx{};
         std::vector<size_t> ScheduleBasedSourceIdx{};
+        // schedule cursors of the loads in Model::LoadMerges
+        std::vector<size_t> MergedLoadIdx{};
         std::vector<SwitchState> SwitchStates{};
+        // lookup cursors of the tables of variable efficiency converters and
+        // movers: by outflow at 2 x index and by inflow at 2 x index + 1
+        std::vector<size_t> VarEffConvCursors{};
+        std::vector<size_t> VarEffMoverCursors{};
+    };
+
+    // A simulation paused after the events at Time have been processed.
+    // NumResults counts the results recorded up to and including Time.
+    struct SimulationSnapshot
+    {
+        double Time = 0.0;
+        size_t NumResults = 0;
+        SimulationState State;
+        // statistics of the events up to and including Time
+        OccurrenceStatsAccumulator Stats;
+    };
+
+    // A run of a model without reliability schedules that is advanced on
+    // demand. Snapshots are kept at least SnapshotInterval_s apart so that
+    // runs whose first failure comes late can resume from the baseline
+    // instead of starting over.
+    struct BaselineSimulation
+    {
+        double SnapshotInterval_s = 0.0;
+        bool IsStarted = false;
+        bool IsFinished = false;
+        // the latest processed time of the baseline
+        SimulationSnapshot Current;
+        // connections and stores kept in Results; all if nullptr
+        ResultProjection const* Projection = nullptr;
+        std::vector<TimeAndFlows> Results;
+        std::vector<SimulationSnapshot> Snapshots;
     };
 
     struct TagAndPort
@@ -554,6 +672,8 @@ namespace erin
         size_t VulnerabilityId = 0;
         std::vector<double> Intensities;
         std::vector<double> FailureFractions;
+        // Lookup prepared from the above; built on demand if left empty
+        LookupTable FailureFractionByIntensity;
     };
 
     struct IntensityDict
@@ -850,14 +970,100 @@ namespace erin
     std::vector<flow_t>
     CopyStorageStates(SimulationState& ss);
 
+    // copies the projected flows and storage amounts of ss
+    TimeAndFlows
+    CaptureResult(
+        SimulationState const& ss,
+        double t,
+        ResultProjection const& projection
+    );
+
     std::vector<TimeAndFlows>
     Simulate(
         Model& m,
         bool verbose = true,
         bool enableSwitchLogic = true,
+        Log const& log = Log{},
+        ResultCapture const& capture = ResultCapture{}
+    );
+
+    // activates and runs the connections with events at time t to
+    // quiescence and records the resulting flows
+    void
+    Simulate_ProcessEvents(
+        Model& model,
+        SimulationState& ss,
+        double t,
+        std::vector<TimeAndFlows>& timeAndFlows,
+        bool verbose,
+        bool enableSwitchLogic,
+        Log const& log,
+        ResultCapture const& capture = ResultCapture{}
+    );
+
+    // time of the next event after the events at t have been processed;
+    // infinity once the final time has been processed
+    double
+    Simulate_NextEventTime(
+        Model const& model,
+        SimulationState const& ss,
+        double t
+    );
+
+    // moves stores and schedule cursors from time t to nextTime
+    void
+    Simulate_AdvanceTime(
+        Model const& model,
+        SimulationState& ss,
+        double t,
+        double nextTime
+    );
+
+    // Writes the hotspot counters as CSV: components ranked by solver work
+    // (kernel runs on their connections, backward as the upstream end and
+    // forward as the downstream end), then connections ranked the same way.
+    Result
+    Hotspots_WriteCsv(
+        Hotspots const& hotspots,
+        Model const& model,
+        std::string const& filename
+    );
+
+    // Simulates the rest of a run from a baseline snapshot. The model must
+    // match the baseline up to and including the snapshot's time; the
+    // baseline results up to the snapshot are copied into the result and
+    // its statistics into capture.Stats. The capture's projection must be
+    // that of the baseline.
+    std::vector<TimeAndFlows>
+    Simulate_FromSnapshot(
+        Model& model,
+        SimulationSnapshot const& snapshot,
+        std::vector<TimeAndFlows> const& baselineResults,
+        bool verbose = false,
+        bool enableSwitchLogic = true,
+        Log const& log = Log{},
+        ResultCapture const& capture = ResultCapture{}
+    );
+
+    // advances the baseline until its next event is at or after time_s
+    // or it has finished; pass infinity to run it to the end
+    void
+    BaselineSimulation_AdvanceTo(
+        BaselineSimulation& baseline,
+        Model& model,
+        double time_s,
+        bool enableSwitchLogic = true,
         Log const& log = Log{}
     );
 
+    // the latest baseline snapshot taken before time_s (any time for
+    // infinity); nullptr if none
+    SimulationSnapshot const*
+    BaselineSimulation_FindSnapshot(
+        BaselineSimulation const& baseline,
+        double time_s
+    );
+
     void
     Model_SetComponentToRepaired(
         Model const& m,
@@ -1070,6 +1276,26 @@ namespace erin
         std::vector<TimeAndFlows> timeAndFlows
     );
 
+    // adds the event at time_s; flows are those holding until the next event
+    void
+    OccurrenceStatsAccumulator_Add(
+        OccurrenceStatsAccumulator& acc,
+        Model const& m,
+        double time_s,
+        std::vector<Flow> const& flows,
+        std::vector<flow_t> const& storageAmounts_J
+    );
+
+    // completes the statistics with those of the reliability schedules
+    ScenarioOccurrenceStats
+    OccurrenceStatsAccumulator_Finish(
+        OccurrenceStatsAccumulator const& acc,
+        size_t scenarioId,
+        size_t occurrenceNumber,
+        Model const& m,
+        FlowDict const& flowDict
+    );
+
     ScenarioOccurrenceStats
     ModelResults_CalculateScenarioOccurrenceStats(
         size_t scenarioId,
@@ -1080,13 +1306,57 @@ namespace erin
     );
 
     void
-    Debug_PrintNumberOfPasses(bool onlyGrandTotal = false);
+    Model_SetupSimulationState(Model& m, SimulationState& ss);
+
+    // Collapses chains of two or more pass-throughs and runs of two or more
+    // constant efficiency converters in series (without lossflow) into
+    // their end components. Components that may fail are left alone. Call
+    // once, after the model is complete; returns the number of connections
+    // the solver no longer visits.
+    size_t
+    Model_Reduce(Model& m, std::unordered_set<size_t> const& mayFailCompIds);
+
+    // inflow request of a reduced chain for its outflow request
+    flow_t
+    ReducedChain_Request(ReducedChain const& chain, flow_t outflowRequest_W);
+
+    // outflow available from a reduced chain for its available inflow
+    flow_t
+    ReducedChain_Available(
+        ReducedChain const& chain,
+        flow_t inflowAvailable_W
+    );
+
+    // sets the requested and available flows of the connections inside the
+    // reduced chains (and the wasteflows of their stages) from those of
+    // the chain ends
+    void
+    Model_ReconstructReducedFlows(Model const& m, SimulationState& ss);
 
+    // Merges runs of two or more schedule-based loads fed by consecutive
+    // outports of a mux into the first load of each run. The mux and the
+    // loads must not fail and the outports must be unlimited. Call once,
+    // after the model is complete; returns the number of connections the
+    // solver no longer visits.
+    size_t
+    Model_MergeLoads(
+        Model& m,
+        std::unordered_set<size_t> const& mayFailCompIds
+    );
+
+    // Sums the schedules of each run of merged loads into its first load
+    // with a k-way merge of their time and amount series. Call after the
+    // loads' schedules are set for a scenario.
     void
-    Debug_ResetNumberOfPasses(bool resetAll = false);
+    Model_MergeLoadSchedules(Model& m);
 
+    // sets the flows of the merged loads' connections from the merged flow
+    // at time t; undone by Model_CollapseMergedLoads
     void
-    Model_SetupSimulationState(Model& m, SimulationState& ss);
+    Model_ExpandMergedLoads(Model const& m, SimulationState& ss, double t);
+
+    void
+    Model_CollapseMergedLoads(Model const& m, SimulationState& ss);
 
     void
     RunConstantEfficiencyConverterBackward(
@@ -1323,7 +1593,7 @@ namespace erin
 
     double
     TabularFragilityCurve_GetFailureFraction(
-        TabularFragilityCurve tfc,
+        TabularFragilityCurve const& tfc,
         double intensityLevel
     );
 
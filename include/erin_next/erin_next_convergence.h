@@ -0,0 +1,64 @@
+/* Copyright (c) 2024 Big Ladder Software LLC. All rights reserved.
+ * See the LICENSE.txt file for additional terms and conditions. */
+#ifndef ERIN_CONVERGENCE_H
+#define ERIN_CONVERGENCE_H
+#include <optional>
+#include <stddef.h>
+#include <string>
+
+namespace erin
+{
+    // Per-occurrence metrics that can be used to stop a scenario's
+    // occurrences early once their estimates have converged
+    enum class ConvergenceMetric
+    {
+        EnergyAvailability,
+        EnergyRobustness,
+        LoadNotServed,
+        MaxSingleEventDowntime,
+        GlobalAvailability,
+    };
+
+    std::optional<ConvergenceMetric>
+    TagToConvergenceMetric(std::string const& tag);
+
+    std::string
+    ConvergenceMetricToTag(ConvergenceMetric metric);
+
+    // Running mean and variance (Welford's algorithm)
+    struct StreamingStats
+    {
+        size_t Count = 0;
+        double Mean = 0.0;
+        // sum of squared deviations from the running mean
+        double SumOfSquares = 0.0;
+    };
+
+    void
+    StreamingStats_Add(StreamingStats& ss, double value);
+
+    // sample variance; 0.0 with fewer than two values
+    double
+    StreamingStats_Variance(StreamingStats const& ss);
+
+    // half-width of the confidence interval on the mean for the given
+    // standard normal score
+    double
+    StreamingStats_HalfWidth(StreamingStats const& ss, double zScore);
+
+    // true when the confidence interval half-width is within
+    // relativeTolerance * |mean|
+    bool
+    StreamingStats_IsConverged(
+        StreamingStats const& ss,
+        double zScore,
+        double relativeTolerance
+    );
+
+    // standard normal score for a two-sided confidence level in (0, 1);
+    // for example, 0.95 gives 1.96
+    double
+    ConfidenceLevelToZScore(double confidenceLevel);
+} // namespace erin
+
+#endif
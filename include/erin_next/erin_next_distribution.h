@@ -5,12 +5,14 @@
 #define ERIN_DISTRIBUTION_H
 #include "erin_next/erin_next_valdata.h"
 #include "erin_next/erin_next_result.h"
+#include "erin_next/erin_next_lookup_table.h"
 #include "erin/logging.h"
 #include "../vendor/toml11/toml.hpp"
 #include <chrono>
 #include <exception>
 #include <functional>
 #include <random>
+#include <span>
 #include <sstream>
 #include <string>
 #include <stdint.h>
@@ -100,6 +102,8 @@ namespace erin
         std::vector<double> times{};
         std::vector<size_t> start_idx{};
         std::vector<size_t> end_idx{};
+        // variates to times lookups, one per table
+        std::vector<LookupTable> tables{};
     };
 
     struct WeibullDist
@@ -109,6 +113,11 @@ namespace erin
         std::vector<double> location_params{}; // gamma
     };
 
+    // NOTE: batched sampling bounds each time advance by the quantile at
+    // this fraction; a draw above it ends the batch and is handled one at a
+    // time, so batched and scalar draws give identical results
+    double const max_batch_fraction = 1.0 - 1.0e-6;
+
     class DistributionSystem
     {
       public:
@@ -162,6 +171,32 @@ namespace erin
         double
         next_time_advance(size_t dist_id, double fraction) const;
 
+        // NOTE: batch form of next_time_advance(dist_id, fraction):
+        // out[i] = next_time_advance(dist_id, u[i]). out may alias u.
+        void
+        sample_n(
+            size_t dist_id,
+            std::span<double const> u,
+            std::span<double> out
+        ) const;
+
+        // NOTE: draws up to out.size() fractions from the internal generator
+        // in the same order as repeated next_time_advance(dist_id) calls and
+        // writes their time advances to out. Stops after the first fraction
+        // above max_fraction; returns the number of advances written.
+        size_t
+        sample_n(
+            size_t dist_id,
+            std::span<double> out,
+            double max_fraction = 1.0
+        );
+
+        // NOTE: upper bound on the time advance for any fraction in
+        // [0, max_fraction]. With max_fraction < 1, the bound is finite for
+        // every distribution type, including Normal and Weibull.
+        double
+        max_time_advance(size_t dist_id, double max_fraction = 1.0) const;
+
         //[[nodiscard]] std::vector<double>
         //  sample_upto_including(const double max_time_s);
         void
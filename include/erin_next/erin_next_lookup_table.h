@@ -4,6 +4,7 @@
 #define ERIN_LOOKUP_TABLE_H
 
 #include <vector>
+#include <stddef.h>
 #include <assert.h>
 
 namespace erin
@@ -27,6 +28,60 @@ namespace erin
         std::vector<double> const& ys,
         double x
     );
+
+    enum class LookupMethod
+    {
+        // xs are not strictly increasing; scan from the start as above
+        Scan,
+        // xs are (near) evenly spaced; the index is computed directly
+        UniformGrid,
+        // large tables; binary search
+        Binary,
+        // small tables; walk from the segment of the previous lookup
+        Cursor,
+    };
+
+    // A lookup table prepared once so repeated lookups avoid rescanning.
+    // Segment i spans [Xs[i], Xs[i + 1]]; its deltas and slope are
+    // precomputed. Results are identical to the free functions above.
+    // A table is not changed by lookups and may be shared between threads.
+    struct LookupTable
+    {
+        std::vector<double> Xs;
+        std::vector<double> Ys;
+        std::vector<double> Dxs;
+        std::vector<double> Dys;
+        std::vector<double> Slopes;
+        LookupMethod Method = LookupMethod::Scan;
+        double InverseStep = 0.0;
+    };
+
+    LookupTable
+    LookupTable_Make(std::vector<double> xs, std::vector<double> ys);
+
+    // NOTE: the overloads taking a cursor start the Cursor method's walk
+    // from the segment it holds and store the segment found in it. The
+    // cursor belongs to the caller; any value is a valid starting point.
+
+    // same as LookupTable_LookupStairStep(xs, ys, x)
+    double
+    LookupTable_StairStep(LookupTable const& table, double x);
+
+    double
+    LookupTable_StairStep(LookupTable const& table, double x, size_t& cursor);
+
+    // same as LookupTable_LookupInterp(xs, ys, x)
+    double
+    LookupTable_Interp(LookupTable const& table, double x);
+
+    double
+    LookupTable_Interp(LookupTable const& table, double x, size_t& cursor);
+
+    // Interpolation where each segment is closed on the right and values
+    // are computed as y0 + (x - x0) * slope. This matches the tabular
+    // fragility curve lookup.
+    double
+    LookupTable_InterpBySlope(LookupTable const& table, double x);
 }
 
 #endif
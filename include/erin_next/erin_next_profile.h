@@ -0,0 +1,232 @@
+/* Copyright (c) 2024 Big Ladder Software LLC. All rights reserved.
+ * See the LICENSE.txt file for additional terms and conditions. */
+#ifndef ERIN_PROFILE_H
+#define ERIN_PROFILE_H
+#include "erin_next/erin_next_result.h"
+#include <array>
+#include <chrono>
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace erin
+{
+    enum class ProfilePhase : size_t
+    {
+        ParseToml = 0,
+        LoadIngestion,
+        Validation,
+        CreateFailureSchedules,
+        ApplyReliabilities,
+        Simulate,
+        Resample,
+        Aggregate,
+        Stats,
+        Write,
+        Count,
+    };
+
+    enum class ProfileCounter : size_t
+    {
+        Events = 0,
+        BackwardPasses,
+        ForwardPasses,
+        ActiveConnectionIterations,
+        SwitchFlips,
+        Count,
+    };
+
+    size_t const numProfilePhases = static_cast<size_t>(ProfilePhase::Count);
+    size_t const numProfileCounters =
+        static_cast<size_t>(ProfileCounter::Count);
+
+    struct ProfileRecord
+    {
+        // empty for work done outside of any occurrence
+        std::string ScenarioTag;
+        size_t OccurrenceNumber = 0;
+        std::array<double, numProfilePhases> PhaseTimes_s{};
+        std::array<uint64_t, numProfileCounters> Counts{};
+    };
+
+    struct Profile
+    {
+        bool Enabled = false;
+        bool InOccurrence = false;
+        // work outside of occurrences: input, setup, and the statistics file
+        ProfileRecord Outside;
+        ProfileRecord Occurrence;
+        std::vector<ProfileRecord> Occurrences;
+        // time spent in nested timers, one entry per active timer
+        std::vector<double> ChildTimes_s;
+    };
+
+    // NOTE: a single process-wide profile; the engine runs on one thread
+    extern Profile TheProfile;
+
+    // clears the profile and starts collecting
+    void
+    Profile_Enable();
+
+    // clears the profile and stops collecting
+    void
+    Profile_Disable();
+
+    inline ProfileRecord&
+    Profile_CurrentRecord()
+    {
+        return TheProfile.InOccurrence ? TheProfile.Occurrence
+                                       : TheProfile.Outside;
+    }
+
+    inline void
+    Profile_Count(ProfileCounter counter, uint64_t amount = 1)
+    {
+        if (TheProfile.Enabled)
+        {
+            Profile_CurrentRecord().Counts[static_cast<size_t>(counter)] +=
+                amount;
+        }
+    }
+
+    void
+    Profile_BeginOccurrence(
+        std::string const& scenarioTag,
+        size_t occurrenceNumber
+    );
+
+    void
+    Profile_EndOccurrence();
+
+    // sum of the work outside and inside all finished occurrences
+    ProfileRecord
+    Profile_Total(Profile const& profile);
+
+    std::string
+    ProfilePhase_ToTag(ProfilePhase phase);
+
+    std::string
+    ProfileCounter_ToTag(ProfileCounter counter);
+
+    Result
+    Profile_WriteJson(Profile const& profile, std::string const& filename);
+
+    // prints the totals of the counters
+    void
+    Profile_PrintCounters(Profile const& profile);
+
+    // solver work of one direction (backward or forward) per connection
+    struct HotspotPasses
+    {
+        std::vector<uint64_t> Runs;
+        // runs beyond the first within an event
+        std::vector<uint64_t> Reactivations;
+        std::vector<uint64_t> MaxRunsPerEvent;
+        // reversals in the direction a connection's value moves within an
+        // event (requested flow backward, available flow forward)
+        std::vector<uint64_t> Oscillations;
+        // per-event scratch
+        std::vector<uint64_t> EventRuns;
+        std::vector<uint64_t> LastValue;
+        std::vector<int8_t> LastChange;
+        std::vector<size_t> Touched;
+    };
+
+    // Per-connection and per-component solver work for finding the parts
+    // of a network that take many passes to settle
+    struct Hotspots
+    {
+        bool Enabled = false;
+        HotspotPasses Backward;
+        HotspotPasses Forward;
+        // by component id: switch flips that made RunSwitchLogic re-run the
+        // active connections
+        std::vector<uint64_t> SwitchFlips;
+    };
+
+    // NOTE: process-wide like TheProfile
+    extern Hotspots TheHotspots;
+
+    // clears the counters and starts collecting
+    void
+    Hotspots_Enable();
+
+    // clears the counters and stops collecting
+    void
+    Hotspots_Disable();
+
+    void
+    HotspotPasses_RecordRun(
+        HotspotPasses& passes,
+        size_t connIdx,
+        uint64_t value
+    );
+
+    inline void
+    Hotspots_RecordBackwardRun(size_t connIdx, uint64_t requested_W)
+    {
+        if (TheHotspots.Enabled)
+        {
+            HotspotPasses_RecordRun(
+                TheHotspots.Backward, connIdx, requested_W
+            );
+        }
+    }
+
+    inline void
+    Hotspots_RecordForwardRun(size_t connIdx, uint64_t available_W)
+    {
+        if (TheHotspots.Enabled)
+        {
+            HotspotPasses_RecordRun(TheHotspots.Forward, connIdx, available_W);
+        }
+    }
+
+    void
+    Hotspots_RecordSwitchFlip(size_t compId);
+
+    // folds the per-event scratch into the totals
+    void
+    Hotspots_EndEvent();
+
+    // Adds the wall time of its scope to a phase. Time spent in nested
+    // timers is excluded so that the phases add up to the total. Does
+    // nothing unless profiling is enabled.
+    class ProfileTimer
+    {
+      public:
+        explicit ProfileTimer(ProfilePhase phase)
+            : Phase{phase}
+            , Active{TheProfile.Enabled}
+        {
+            if (Active)
+            {
+                TheProfile.ChildTimes_s.push_back(0.0);
+                Start = std::chrono::steady_clock::now();
+            }
+        }
+
+        ~ProfileTimer()
+        {
+            if (Active)
+            {
+                Stop();
+            }
+        }
+
+        ProfileTimer(ProfileTimer const&) = delete;
+        ProfileTimer&
+        operator=(ProfileTimer const&) = delete;
+
+      private:
+        void
+        Stop();
+
+        ProfilePhase Phase;
+        bool Active;
+        std::chrono::steady_clock::time_point Start{};
+    };
+} // namespace erin
+
+#endif
@@ -2,8 +2,12 @@
  * See the LICENSE.txt file for additional terms and conditions. */
 #ifndef ERIN_RANDOM_H
 #define ERIN_RANDOM_H
-#include <vector>
+#include <functional>
+#include <optional>
 #include <random>
+#include <stdint.h>
+#include <string>
+#include <vector>
 
 namespace erin
 {
@@ -44,6 +48,92 @@ namespace erin
 
     Random
     CreateRandomWithSeed(unsigned int seed);
+
+    // seed for an independent stream identified by (streamId, substreamId)
+    // under a base seed; the result does not depend on which other
+    // streams are in use
+    unsigned int
+    DeriveSeed(unsigned int seed, uint64_t streamId, uint64_t substreamId);
+
+    // How the uniform draws of a scenario's occurrences relate to each other.
+    // Draws are grouped into streams, each of which means the same quantity
+    // in every occurrence (e.g., one failure mode link or one fragility mode
+    // of a component). The first draw of stream j of occurrence i is treated
+    // as coordinate j of sample point i.
+    enum class SamplingType
+    {
+        // independent draws from the base generator
+        Independent,
+        // occurrences come in pairs; draw k of a stream in the second uses
+        // 1 - u of draw k of the same stream in the first
+        Antithetic,
+        // each coordinate below Sobol_NumDimensions() is stratified over the
+        // scenario's occurrences; later coordinates and later draws of a
+        // stream fall back to independent draws
+        LatinHypercube,
+        // randomly shifted Sobol points; coordinates past the supported
+        // dimension and later draws of a stream fall back to independent
+        // draws
+        Sobol,
+    };
+
+    std::optional<SamplingType>
+    TagToSamplingType(std::string const& tag);
+
+    std::string
+    SamplingTypeToTag(SamplingType st);
+
+    // number of coordinates for which Sobol points are available; Latin
+    // hypercube sampling stratifies as many, each keeping a permutation of
+    // the scenario's occurrences
+    size_t
+    Sobol_NumDimensions();
+
+    // the Sobol point at index for the given dimension as a 32-bit fraction
+    uint32_t
+    Sobol_Point(uint32_t index, size_t dimension);
+
+    // Hands out draws for the occurrences of a scenario according to the
+    // sampling type. All randomness comes from Base so runs stay
+    // reproducible from the seed.
+    struct SampledRandom
+    {
+        SamplingType Type = SamplingType::Independent;
+        std::function<double()> Base;
+        size_t NumOccurrences = 0;
+        size_t OccurrenceIdx = 0;
+        size_t Stream = 0;
+        size_t StreamDrawIdx = 0;
+        // Antithetic: draws of the first occurrence of the current pair, by
+        // stream
+        std::vector<std::vector<double>> PairDraws;
+        // LatinHypercube: stratum of each occurrence, by coordinate
+        std::vector<std::vector<size_t>> Strata;
+        // Sobol: random digital shift by coordinate
+        std::vector<uint32_t> Shifts;
+        double
+        operator()();
+    };
+
+    void
+    SampledRandom_StartScenario(SampledRandom& sr, size_t numOccurrences);
+
+    void
+    SampledRandom_StartOccurrence(SampledRandom& sr, size_t occurrenceIdx);
+
+    // the following draws belong to the given stream of the current
+    // occurrence; draws before the first call belong to stream 0
+    void
+    SampledRandom_StartStream(SampledRandom& sr, size_t stream);
+
+    // Importance sampling of a Bernoulli failure with probability p: the
+    // sampling probability q has its odds scaled by oddsFactor. Returns q.
+    double
+    ImportanceSampling_FailureProbability(double p, double oddsFactor);
+
+    // likelihood ratio p(outcome) / q(outcome) for the sampled outcome
+    double
+    ImportanceSampling_Weight(double p, double q, bool isFailed);
 } // namespace erin
 
 #endif
@@ -13,7 +13,11 @@
 #include "../vendor/toml11/toml.hpp"
 #include "../vendor/courier/include/courier/courier.h"
 #include "erin_next/erin_next_validation.h"
+#include <functional>
+#include <ios>
+#include <ostream>
 #include <string>
+#include <utility>
 #include <vector>
 #include <optional>
 #include <cstdlib>
@@ -40,6 +44,88 @@ namespace erin
         FailureModeDict FailureModes;
     };
 
+    // Convergence of the opt-in stopping metrics for one scenario; the
+    // metrics follow Simulation.Info.ConvergenceMetrics
+    struct ScenarioConvergenceStats
+    {
+        size_t ScenarioId = 0;
+        size_t NumOccurrences = 0;
+        size_t MaxOccurrences = 0;
+        bool IsConverged = false;
+        std::vector<StreamingStats> MetricStats;
+    };
+
+    // Results of the first failure-free occurrence of a scenario. Without
+    // failures the model is deterministic, so later occurrences with the
+    // same reliability schedules reuse these instead of simulating again.
+    struct FailureFreeOccurrence
+    {
+        bool IsSet = false;
+        std::vector<ScheduleBasedReliability> Reliabilities;
+        // projected results of the occurrence before group aggregation and
+        // resampling
+        std::vector<TimeAndFlows> EventResults;
+        ScenarioOccurrenceStats Stats;
+        // number of events simulated for the occurrence
+        size_t NumEvents = 0;
+        // event file rows without the scenario and start-time columns as
+        // formatted from the stream flags and precision before and leaving
+        // those after
+        std::vector<std::string> EventRows;
+        std::ios_base::fmtflags FlagsBefore{};
+        std::streamsize PrecisionBefore = 0;
+        std::ios_base::fmtflags FlagsAfter{};
+        std::streamsize PrecisionAfter = 0;
+    };
+
+    // Group aggregation compiled once per model as a sparse operator in
+    // compressed sparse row form: node connection i sums the flows of the
+    // connections ConnIds[RowStarts[i]] to ConnIds[RowStarts[i + 1] - 1].
+    struct GroupAggregation
+    {
+        std::vector<size_t> RowStarts;
+        std::vector<size_t> ConnIds;
+    };
+
+    // How flows are reported at a uniform time step
+    enum class ResampleMode
+    {
+        // flows in effect at each report time
+        Sample,
+        // time-weighted mean flow over each report interval
+        Mean,
+        // energy over each report interval; reported in kJ
+        Energy,
+        // highest flow in effect during each report interval
+        Max,
+    };
+
+    // flows integrated over part of a report interval
+    struct FlowIntegral
+    {
+        double Requested_J = 0.0;
+        double Available_J = 0.0;
+        double Actual_J = 0.0;
+    };
+
+    // Resamples results one event at a time onto report times that are
+    // multiples of the time step. State is kept per connection, so memory
+    // does not grow with the number of events or report steps.
+    struct UniformTimeStepResampler
+    {
+        ResampleMode Mode = ResampleMode::Sample;
+        double TimeStep_s = 0.0;
+        bool HasPrevious = false;
+        TimeAndFlows Previous;
+        double LastReport_s = 0.0;
+        // time up to which the previous flows have been integrated
+        double Cursor_s = 0.0;
+        std::vector<FlowIntegral> Integrals;
+        std::vector<Flow> Maxima;
+        // the report being emitted
+        TimeAndFlows Report;
+    };
+
     std::string
     DoubleToString(double value, unsigned int precision);
 
@@ -210,20 +296,27 @@ namespace erin
     Result
     SetLoadsForScenario(
         std::vector<ScheduleBasedLoad>& loads,
-        LoadDict loadMap,
+        LoadDict const& loadMap,
         size_t scenarioIdx
     );
 
     Result
     SetSupplyForScenario(
         std::vector<ScheduleBasedSource>& loads,
-        LoadDict loadMap,
+        LoadDict const& loadMap,
         size_t scenarioIdx
     );
 
     std::vector<double>
     DetermineScenarioOccurrenceTimes(Simulation& s, size_t scenIdx);
 
+    // the metric as reported per occurrence in the statistics file
+    double
+    ScenarioOccurrenceStats_GetMetric(
+        ScenarioOccurrenceStats const& sos,
+        ConvergenceMetric metric
+    );
+
     std::unordered_map<size_t, double>
     GetIntensitiesForScenario(Simulation& s, size_t scenIdx);
 
@@ -239,7 +332,11 @@ namespace erin
         std::function<double()> const& randFn,
         DistributionSystem const& ds,
         double scenarioDuration_s,
-        double scenarioOffset_s
+        double scenarioOffset_s,
+        bool clipToScenario = false,
+        // NOTE: if given, the draws of each failure mode link go to the
+        // stream numbered by its index in componentFailureModeComponentIds
+        SampledRandom* sampledRandom = nullptr
     );
 
     std::vector<ScheduleBasedReliability>
@@ -255,8 +352,8 @@ namespace erin
         std::vector<std::string> const& fragilityModeTags,
         std::vector<size_t> const& fragilityCurveCurveIds,
         std::vector<FragilityCurveType> const& fragilityCurveCurveTypes,
-        std::vector<LinearFragilityCurve> linearFragilityCurves,
-        std::vector<TabularFragilityCurve> tabularFragilityCurves,
+        std::vector<LinearFragilityCurve> const& linearFragilityCurves,
+        std::vector<TabularFragilityCurve> const& tabularFragilityCurves,
         DistributionSystem const& ds,
         double startTime_s,
         double endTime_s,
@@ -264,19 +361,208 @@ namespace erin
         std::unordered_map<size_t, std::vector<TimeState>> const&
             relSchByCompId,
         bool verbose,
-        Log const& log
+        Log const& log,
+        bool schedulesAreClipped = false,
+        // NOTE: above 1, fragility failures are sampled with their odds
+        // scaled by this factor and likelihoodRatio (if given) is multiplied
+        // by each draw's likelihood ratio
+        double fragilityOddsFactor = 1.0,
+        double* likelihoodRatio = nullptr,
+        // NOTE: if given, the draws of each component fragility mode go to
+        // the stream numbered by its index in componentFragilityComponentIds
+        // plus the number of failure mode links
+        SampledRandom* sampledRandom = nullptr
+    );
+
+    // true if no schedule has a component unavailable
+    bool
+    Reliabilities_AreFailureFree(
+        std::vector<ScheduleBasedReliability> const& reliabilities
+    );
+
+    // time of the earliest entry in any schedule that can make an occurrence
+    // differ from a failure-free one: the first failure or fragility hit,
+    // skipping leading up entries at time 0; infinity (-1) if none
+    double
+    Reliabilities_FirstEventTime(
+        std::vector<ScheduleBasedReliability> const& reliabilities
+    );
+
+    bool
+    Reliabilities_AreEqual(
+        std::vector<ScheduleBasedReliability> const& a,
+        std::vector<ScheduleBasedReliability> const& b
+    );
+
+    // writes the cached failure-free occurrence to the event file under the
+    // given scenario and start-time tags
+    void
+    WriteFailureFreeOccurrenceToEventFile(
+        std::ostream& out,
+        FailureFreeOccurrence& ffo,
+        Simulation const& s,
+        std::string const& scenarioTag,
+        std::string const& scenarioStartTimeTag,
+        std::vector<size_t> const& nodeConnOrder,
+        std::vector<size_t> const& storeOrder,
+        std::vector<size_t> const& compOrder,
+        TimeUnit outputTimeUnit,
+        GroupAggregation const& aggregation,
+        UniformTimeStepResampler* resampler,
+        bool changesOnly,
+        ResultProjection const* projection
+    );
+
+    std::optional<ResampleMode>
+    TagToResampleMode(std::string const& tag);
+
+    std::string
+    ResampleModeToTag(ResampleMode mode);
+
+    UniformTimeStepResampler
+    UniformTimeStepResampler_Create(double time_step_h, ResampleMode mode);
+
+    // prepares for the results of the next occurrence
+    void
+    UniformTimeStepResampler_Reset(UniformTimeStepResampler& resampler);
+
+    // Adds the flows and storage amounts of the next event and calls emit
+    // with each report up to and including the event's time. The first
+    // event is reported as is (with zero energy for ResampleMode::Energy).
+    void
+    UniformTimeStepResampler_Push(
+        UniformTimeStepResampler& resampler,
+        double time_s,
+        std::vector<Flow> const& flows,
+        std::vector<flow_t> const& storageAmounts_J,
+        std::function<void(TimeAndFlows const&)> const& emit
     );
 
     std::vector<TimeAndFlows>
     ApplyUniformTimeStep(
         std::vector<TimeAndFlows> const& results,
-        double const time_step_h
+        double const time_step_h,
+        ResampleMode mode = ResampleMode::Sample
     );
 
-    void
-    AggregateGroups(Model& model, std::vector<TimeAndFlows> const& results);
+    GroupAggregation
+    GroupAggregation_Create(std::vector<NodeConnection> const& nodeConnections);
 
+    // node connection flows from connection flows for one event
     void
+    GroupAggregation_Apply(
+        GroupAggregation const& agg,
+        std::vector<Flow> const& flows,
+        std::vector<Flow>& nodeFlows
+    );
+
+    // the connections summed by the given node connections in id order
+    std::vector<size_t>
+    GroupAggregation_ConnectionsOf(
+        GroupAggregation const& agg,
+        std::vector<size_t> const& nodeConnIds
+    );
+
+    // The aggregation for results captured with the projection: connection
+    // ids become indices into projection.ConnIds. Connections left out of
+    // the projection are dropped, so only the node connections whose
+    // connections were all captured sum correctly.
+    GroupAggregation
+    GroupAggregation_Project(
+        GroupAggregation const& agg,
+        ResultProjection const& projection
+    );
+
+    // One part of a run split over several processes. The (scenario,
+    // occurrence) pairs are numbered in output order and shard Index
+    // (1-based) of Count runs a contiguous block of them.
+    struct ShardSpec
+    {
+        size_t Index = 1;
+        size_t Count = 1;
+    };
+
+    // parses "i/N" with 1 <= i <= N
+    std::optional<ShardSpec>
+    ShardSpec_Parse(std::string const& text);
+
+    // the pairs [first, last) of numPairs run by the shard
+    std::pair<size_t, size_t>
+    ShardSpec_PairRange(ShardSpec const& shard, size_t numPairs);
+
+    // path of a shard's partial output file: "out.csv" becomes
+    // "out.shard-2-of-4.csv"; unchanged for a single shard
+    std::string
+    ShardSpec_FilePath(std::string const& path, ShardSpec const& shard);
+
+    // path of the convergence table written with adaptive stopping:
+    // "stats.csv" becomes "stats-convergence.csv"
+    std::string
+    ConvergenceFilePath(std::string const& statsPath);
+
+    // Resamples a schedule onto windows of window_s starting at time 0 with
+    // the mean (energy over the window divided by its length, rounded to
+    // the nearest W) or the max of the amounts in effect over each window.
+    // The last amount holds from the first window start at or after the
+    // last entry. Only ResampleMode::Mean and ResampleMode::Max apply.
+    std::vector<TimeAndAmount>
+    AmountSchedule_Coarsen(
+        AmountSchedule const& schedule,
+        double window_s,
+        ResampleMode mode
+    );
+
+    // counts from a call to Simulation_CoarsenSchedules
+    struct ScheduleCoarsening
+    {
+        size_t NumEntries = 0;
+        size_t NumCoarseEntries = 0;
+    };
+
+    // Coarsens the load and supply schedules to windows of window_h hours
+    // (see AmountSchedule_Coarsen) for quick screening runs. Schedules that
+    // would not get fewer entries are left as they are.
+    ScheduleCoarsening
+    Simulation_CoarsenSchedules(
+        Simulation& s,
+        double window_h,
+        ResampleMode mode
+    );
+
+    // counts from a call to Simulation_CompactSchedules
+    struct ScheduleCompaction
+    {
+        size_t NumEntries = 0;
+        size_t NumEntriesRemoved = 0;
+        // uniform-step schedules left as they are because their compacted
+        // entries would take more memory
+        size_t NumUniformSchedulesKept = 0;
+    };
+
+    // Removes the load and supply schedule entries that repeat the amount
+    // before them (see TimeAndAmount_Compact). Uniform-step schedules keep
+    // their uniform form unless compaction shrinks them. Results are
+    // unchanged apart from the events that no longer happen at the removed
+    // entries.
+    ScheduleCompaction
+    Simulation_CompactSchedules(Simulation& s);
+
+    // Reduces the model (see Model_Reduce and Model_MergeLoads) leaving
+    // alone the components with failure or fragility modes; returns the
+    // number of connections eliminated
+    size_t
+    Simulation_ReduceModel(Simulation& s);
+
+    // counts from a call to Simulation_Run for performance reporting
+    struct SimulationRunMetrics
+    {
+        size_t OccurrencesSimulated = 0;
+        // events on the occurrence timelines, including those of
+        // occurrences that reuse the failure-free results
+        size_t EventsSimulated = 0;
+    };
+
+    SimulationRunMetrics
     Simulation_Run(
         Simulation& s,
         Log& log,
@@ -285,7 +571,20 @@ namespace erin
         double time_step_h = -1.0,
         bool aggregateGroups = true,
         bool saveReliabilityCurves = false,
-        bool verbose = false
+        bool verbose = false,
+        std::optional<ShardSpec> const& shard = {},
+        ResampleMode resampleMode = ResampleMode::Sample,
+        bool changesOnly = false
+    );
+
+    // combines the partial event and statistics files of numShards shards
+    // into the files the unsplit run would have written
+    Result
+    Simulation_MergeShards(
+        std::string const& eventsFilename,
+        std::string const& statsFilename,
+        size_t numShards,
+        Log& log
     );
 
     bool
@@ -322,6 +621,10 @@ namespace erin
         std::string const& tableFullName
     );
 
+    // indices of tags in sorted tag order; equal tags keep their order
+    std::vector<size_t>
+    CalculateTagOrder(std::vector<std::string> const& tags);
+
     std::vector<size_t>
     CalculateScenarioOrder(Simulation const& s);
 
@@ -331,7 +634,7 @@ namespace erin
     std::vector<size_t>
     CalculateStoreOrder(
         Simulation const& s,
-        std::unordered_set<std::string> const& compsToReport
+        std::unordered_set<size_t> const& compsToReport
     );
 
     std::vector<size_t>
@@ -350,18 +653,30 @@ namespace erin
         std::vector<size_t> const& compOrder,
         TimeUnit outputTimeUnit,
         std::vector<NodeConnection> const& nodeConnections,
-        bool aggregateGroups
+        bool aggregateGroups,
+        std::string const& flowUnit = "kW"
     );
 
+    // Writes a row per result (or per report with a resampler). With
+    // changesOnly, rows whose values equal those of the last row written
+    // are left out, except for the last row, which marks the end time.
+    // Results captured with a projection hold its stores only and need an
+    // aggregation projected the same way (see GroupAggregation_Project).
     void
     WriteResultsToEventFile(
-        std::ofstream& out,
-        std::vector<TimeAndFlows> results,
+        std::ostream& out,
+        std::vector<TimeAndFlows> const& results,
         Simulation const& s,
         std::string const& scenarioTag,
         std::string const& scenarioStartTimeTag,
-        std::vector<size_t> const& connOrder,
-        TimeUnit outputTimeUnit = TimeUnit::Hour
+        std::vector<size_t> const& nodeConnOrder,
+        std::vector<size_t> const& storeOrder,
+        std::vector<size_t> const& compOrder,
+        TimeUnit outputTimeUnit = TimeUnit::Hour,
+        GroupAggregation const* aggregation = nullptr,
+        UniformTimeStepResampler* resampler = nullptr,
+        bool changesOnly = false,
+        ResultProjection const* projection = nullptr
     );
 
     void
@@ -3,6 +3,7 @@
 #ifndef ERIN_SIMULATION_INFO_H
 #define ERIN_SIMULATION_INFO_H
 #include "erin_next/erin_next_valdata.h"
+#include "erin_next/erin_next_convergence.h"
 #include "erin_next/erin_next_units.h"
 #include "erin_next/erin_next_random.h"
 #include "../vendor/toml11/toml.hpp"
@@ -37,6 +38,20 @@ namespace erin
         int unsigned Seed = 0;
         std::vector<double> Series;
         double FixedValue = 0.0;
+        // NOTE: opt-in adaptive stopping. When metrics are given, each
+        // scenario's occurrences stop once every metric's confidence
+        // interval half-width is within its relative tolerance of the mean
+        // (checked from MinOccurrences on) or the occurrences run out.
+        std::vector<ConvergenceMetric> ConvergenceMetrics;
+        std::vector<double> ConvergenceTolerances;
+        double ConfidenceLevel = 0.95;
+        size_t MinOccurrences = 30;
+        // NOTE: opt-in variance reduction. Sampling sets how the draws of
+        // a scenario's occurrences relate to each other. A fragility
+        // importance factor above 1 scales the odds of fragility failures
+        // and weights each occurrence by its likelihood ratio.
+        SamplingType Sampling = SamplingType::Independent;
+        double FragilityImportanceFactor = 1.0;
     };
 
     std::optional<SimulationInfo>
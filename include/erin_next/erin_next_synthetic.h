@@ -0,0 +1,55 @@
+/* Copyright (c) 2024 Big Ladder Software LLC. All rights reserved.
+ * See the LICENSE.txt file for additional terms and conditions. */
+#ifndef ERIN_SYNTHETIC_H
+#define ERIN_SYNTHETIC_H
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+namespace erin
+{
+    // Parameters of a synthetic district model for stress testing. A
+    // utility feeds the buildings through a tree of muxes NetworkDepth
+    // levels deep. Each building has a feeder, an optional battery, a
+    // switch to a gas-fired generator, an electric load, and a chiller
+    // serving a cooling load.
+    struct SyntheticModelOptions
+    {
+        size_t NumBuildings = 10;
+        size_t NetworkDepth = 2;
+        // fraction of buildings with a battery behind the feeder
+        double StorageFraction = 0.25;
+        // probability of each component having a failure mode and of each
+        // exposed component having a fragility mode
+        double FailureModeDensity = 0.5;
+        size_t NumScenarios = 2;
+        size_t NumOccurrences = 10;
+        size_t NumLoadProfiles = 4;
+        double ScenarioDuration_h = 336.0;
+        unsigned int Seed = 17;
+    };
+
+    struct LoadProfileFile
+    {
+        std::string Path;
+        std::string Contents;
+    };
+
+    struct SyntheticModel
+    {
+        std::string Toml;
+        // when load files are requested, the csv files referenced by Toml
+        std::vector<LoadProfileFile> LoadFiles;
+    };
+
+    // Generates the model. With an empty loadFilePrefix, load profiles are
+    // written inline; otherwise each profile goes to a csv file whose path
+    // starts with the prefix.
+    SyntheticModel
+    SyntheticModel_Generate(
+        SyntheticModelOptions const& options,
+        std::string const& loadFilePrefix = ""
+    );
+} // namespace erin
+
+#endif
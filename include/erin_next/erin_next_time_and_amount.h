@@ -3,8 +3,10 @@
 #ifndef ERIN_TIME_AND_AMOUNT_H
 #define ERIN_TIME_AND_AMOUNT_H
 #include "erin_next/erin_next_const.h"
+#include <stddef.h>
 #include <stdint.h>
 #include <ostream>
+#include <vector>
 
 namespace erin
 {
@@ -16,6 +18,69 @@ namespace erin
 
     std::ostream&
     operator<<(std::ostream& os, TimeAndAmount const& timeAndAmount);
+
+    bool
+    operator==(TimeAndAmount const& a, TimeAndAmount const& b);
+
+    // Removes the entries whose amount equals that of the entry before; the
+    // amount in effect at any time stays the same. The first entry is always
+    // kept. Returns the number of entries removed.
+    size_t
+    TimeAndAmount_Compact(std::vector<TimeAndAmount>& series);
+
+    // A series of amounts over time. A series whose times are uniformly
+    // spaced is kept as a start time, a time step, and the amounts, so that
+    // the time of an entry is computed rather than stored; other series
+    // keep their time and amount pairs.
+    struct AmountSchedule
+    {
+        // irregular form; empty in the uniform form
+        std::vector<TimeAndAmount> Entries;
+        // uniform form; Amounts_W is empty in the irregular form
+        double Start_s = 0.0;
+        double TimeStep_s = 0.0;
+        std::vector<flow_t> Amounts_W;
+    };
+
+    // uses the uniform form when the time of every entry is exactly
+    // Start_s + i * TimeStep_s
+    AmountSchedule
+    AmountSchedule_Make(std::vector<TimeAndAmount> entries);
+
+    std::vector<TimeAndAmount>
+    AmountSchedule_ToEntries(AmountSchedule const& schedule);
+
+    bool
+    operator==(AmountSchedule const& a, AmountSchedule const& b);
+
+    inline bool
+    AmountSchedule_IsUniform(AmountSchedule const& schedule)
+    {
+        return !schedule.Amounts_W.empty();
+    }
+
+    inline size_t
+    AmountSchedule_Size(AmountSchedule const& schedule)
+    {
+        return AmountSchedule_IsUniform(schedule) ? schedule.Amounts_W.size()
+                                                  : schedule.Entries.size();
+    }
+
+    inline double
+    AmountSchedule_TimeAt(AmountSchedule const& schedule, size_t idx)
+    {
+        return AmountSchedule_IsUniform(schedule)
+            ? schedule.Start_s + static_cast<double>(idx) * schedule.TimeStep_s
+            : schedule.Entries[idx].Time_s;
+    }
+
+    inline flow_t
+    AmountSchedule_AmountAt(AmountSchedule const& schedule, size_t idx)
+    {
+        return AmountSchedule_IsUniform(schedule)
+            ? schedule.Amounts_W[idx]
+            : schedule.Entries[idx].Amount_W;
+    }
 } // namespace erin
 
 #endif
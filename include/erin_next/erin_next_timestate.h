@@ -2,6 +2,9 @@
  * See the LICENSE.txt file for additional terms and conditions. */
 #ifndef ERIN_TIMESTATE_H
 #define ERIN_TIMESTATE_H
+#include <array>
+#include <cstdint>
+#include <initializer_list>
 #include <iostream>
 #include <vector>
 #include <set>
@@ -10,14 +13,93 @@
 namespace erin
 {
 
+    // NOTE: a CauseSet is a handle to an interned, sorted set of mode ids.
+    // Equal sets share one id and the empty set is always id 0, so copying,
+    // comparing, and clearing a TimeState's causes never touches the heap.
+    // The intern table is shared by the whole process and lives for its
+    // duration. Reading a set by its id takes no lock; interning a new set
+    // takes a mutex, so concurrent simulations may share the table. The
+    // number of distinct cause combinations in a run is small compared to the
+    // number of schedule entries that reference them.
+    class CauseSet
+    {
+      public:
+        CauseSet() = default;
+        CauseSet(std::initializer_list<size_t> ids);
+        CauseSet(std::set<size_t> const& ids);
+
+        std::vector<size_t>::const_iterator
+        begin() const;
+
+        std::vector<size_t>::const_iterator
+        end() const;
+
+        size_t
+        size() const;
+
+        bool
+        empty() const;
+
+        bool
+        contains(size_t id) const;
+
+        void
+        insert(size_t id);
+
+        uint32_t
+        GetId() const
+        {
+            return static_cast<uint32_t>(IdBytes[0])
+                | (static_cast<uint32_t>(IdBytes[1]) << 8)
+                | (static_cast<uint32_t>(IdBytes[2]) << 16);
+        }
+
+        friend CauseSet
+        CauseSet_Union(CauseSet const& a, CauseSet const& b);
+
+        friend bool
+        operator==(CauseSet const& a, CauseSet const& b)
+        {
+            return a.IdBytes == b.IdBytes;
+        }
+
+        friend bool
+        operator!=(CauseSet const& a, CauseSet const& b)
+        {
+            return a.IdBytes != b.IdBytes;
+        }
+
+      private:
+        void
+        SetId(uint32_t id);
+
+        // NOTE: ids are 24 bits wide and kept as bytes so that a TimeState's
+        // state and both of its cause sets share one word after the time
+        std::array<uint8_t, 3> IdBytes{0, 0, 0};
+    };
+
+    // the number of distinct cause sets the intern table can hold
+    uint32_t const maxCauseSets = 1u << 24;
+
+    CauseSet
+    CauseSet_Union(CauseSet const& a, CauseSet const& b);
+
+    size_t
+    CauseSet_NumberInterned();
+
     struct TimeState
     {
         double time = 0.0;
         bool state = true;
-        std::set<size_t> failureModeCauses;
-        std::set<size_t> fragilityModeCauses;
+        CauseSet failureModeCauses;
+        CauseSet fragilityModeCauses;
     };
 
+    static_assert(
+        sizeof(TimeState) == 16,
+        "TimeState should pack into a time and one word"
+    );
+
     std::ostream&
     operator<<(std::ostream& os, TimeState const& ts);
 
@@ -41,6 +123,19 @@ namespace erin
         bool rezeroTime
     );
 
+    // NOTE: merges any number of schedules in one pass; the result is
+    // identical to folding the inputs with TimeState_Combine() and then
+    // calling TimeState_Clip() on the combined schedule. Result is cleared
+    // and refilled so callers can reuse its capacity.
+    void
+    TimeState_MergeAndClip(
+        std::vector<std::vector<TimeState> const*> const& inputs,
+        double startTime_s,
+        double endTime_s,
+        bool rezeroTime,
+        std::vector<TimeState>& result
+    );
+
     std::vector<TimeState>
     TimeState_Translate(std::vector<TimeState> const& input, double dt_s);
 
@@ -0,0 +1,132 @@
+/* Copyright (c) 2024 Big Ladder Software LLC. All rights reserved.
+ * See the LICENSE.txt file for additional terms and conditions. */
+#ifndef ERIN_TRACE_H
+#define ERIN_TRACE_H
+#include "erin_next/erin_next_result.h"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace erin
+{
+    // One event of the Chrome trace event format, which chrome://tracing
+    // and Perfetto read
+    struct TraceEvent
+    {
+        // string literals; never freed
+        char const* Name = nullptr;
+        char const* Category = nullptr;
+        // 'X' complete span, 'C' counter, 'i' instant
+        char Phase = 'X';
+        double Time_us = 0.0;
+        double Duration_us = 0.0;
+        // contents of the args object, e.g., "\"iteration\": 3"
+        std::string Args;
+    };
+
+    struct TraceBuffer
+    {
+        size_t ThreadIndex = 0;
+        std::vector<TraceEvent> Events;
+    };
+
+    // NOTE: Enabled and Generation are read by the tracing hooks of every
+    // thread while Trace_Enable() and Trace_Disable() may change them.
+    // Enabled is set with release ordering after Start so that a thread that
+    // sees tracing enabled also sees its start time.
+    struct Trace
+    {
+        std::atomic<bool> Enabled{false};
+        // incremented on enable so threads drop buffers of earlier traces
+        std::atomic<uint64_t> Generation{0};
+        std::chrono::steady_clock::time_point Start{};
+        // NOTE: guards Buffers only; each thread appends to its own buffer
+        // without locking
+        std::mutex BuffersMutex;
+        std::vector<std::unique_ptr<TraceBuffer>> Buffers;
+    };
+
+    extern Trace TheTrace;
+
+    inline bool
+    Trace_IsEnabled()
+    {
+        return TheTrace.Enabled.load(std::memory_order_acquire);
+    }
+
+    // clears the trace and starts collecting; call before starting threads
+    void
+    Trace_Enable();
+
+    // clears the trace and stops collecting; call after joining threads
+    void
+    Trace_Disable();
+
+    // microseconds since the trace was enabled
+    double
+    Trace_Now_us();
+
+    void
+    Trace_AddEvent(TraceEvent event);
+
+    void
+    Trace_AddCounter(char const* name, std::string args);
+
+    void
+    Trace_AddInstant(char const* name, char const* category, std::string args);
+
+    // quotes and escapes s for use as a JSON string in Args
+    std::string
+    Trace_JsonString(std::string const& s);
+
+    // writes the events of all threads; call after joining threads
+    Result
+    Trace_WriteJson(std::string const& filename);
+
+    // Records its scope as a complete ('X') event. Does nothing unless
+    // tracing is enabled; check Active before formatting Args.
+    class TraceSpan
+    {
+      public:
+        TraceSpan(char const* name, char const* category)
+            : Active{Trace_IsEnabled()}
+            , Name{name}
+            , Category{category}
+        {
+            if (Active)
+            {
+                Start_us = Trace_Now_us();
+            }
+        }
+
+        ~TraceSpan()
+        {
+            if (Active)
+            {
+                Stop();
+            }
+        }
+
+        TraceSpan(TraceSpan const&) = delete;
+        TraceSpan&
+        operator=(TraceSpan const&) = delete;
+
+        bool Active;
+        std::string Args;
+
+      private:
+        void
+        Stop();
+
+        char const* Name;
+        char const* Category;
+        double Start_us = 0.0;
+    };
+} // namespace erin
+
+#endif
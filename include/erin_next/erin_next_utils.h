@@ -131,6 +131,14 @@ namespace erin
     std::string
     WriteErrorToString(std::string const& tag, std::string const& msg);
 
+    // CPU time (user + system) used by this process so far, in seconds
+    double
+    GetProcessCpuTime_s();
+
+    // high-water mark of this process's resident set size, in bytes
+    uint64_t
+    GetPeakResidentSetSize_bytes();
+
 } // namespace erin
 
 #endif
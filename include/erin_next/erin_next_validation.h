@@ -50,6 +50,13 @@ namespace erin
         "MWh",
     };
 
+    std::unordered_set<std::string> const ValidSamplingTypes{
+        "independent",
+        "antithetic",
+        "latin_hypercube",
+        "sobol",
+    };
+
     std::string
     InputSection_toString(InputSection s);
 
@@ -3,14 +3,19 @@
 #include "erin_next/erin_next.h"
 #include "erin/logging.h"
 #include "erin_next/erin_next_lookup_table.h"
+#include "erin_next/erin_next_profile.h"
 #include "erin_next/erin_next_time_and_amount.h"
+#include "erin_next/erin_next_trace.h"
 #include "erin_next/erin_next_units.h"
 #include "erin_next/erin_next_utils.h"
+#include <algorithm>
 #include <cmath>
 #include <cstdlib>
+#include <fstream>
 #include <sstream>
 #include <stdexcept>
 #include <numeric>
+#include <queue>
 #include <string>
 #include <unordered_set>
 #include <utility>
@@ -1265,18 +1270,16 @@ namespace erin
         {
             size_t connIdx = m.ScheduledLoads[i].InflowConn;
             size_t idx = ss.ScheduleBasedLoadIdx[i];
-            if (idx < m.ScheduledLoads[i].TimesAndLoads.size())
+            AmountSchedule const& schedule = m.ScheduledLoads[i].TimesAndLoads;
+            if (idx < AmountSchedule_Size(schedule)
+                && AmountSchedule_TimeAt(schedule, idx) == t)
             {
-                auto const& tal = m.ScheduledLoads[i].TimesAndLoads[idx];
-                if (tal.Time_s == t)
+                flow_t amount_W = AmountSchedule_AmountAt(schedule, idx);
+                if (ss.Flows[connIdx].Requested_W != amount_W)
                 {
-
-                    if (ss.Flows[connIdx].Requested_W != tal.Amount_W)
-                    {
-                        ss.ActiveConnectionsBack.insert(connIdx);
-                    }
-                    ss.Flows[connIdx].Requested_W = tal.Amount_W;
+                    ss.ActiveConnectionsBack.insert(connIdx);
                 }
+                ss.Flows[connIdx].Requested_W = amount_W;
             }
         }
     }
@@ -1303,14 +1306,15 @@ namespace erin
                 continue;
             }
             auto idx = ss.ScheduleBasedSourceIdx[i];
-            if (idx < sbs.TimeAndAvails.size())
+            if (idx < AmountSchedule_Size(sbs.TimeAndAvails))
             {
-                auto const& taa = sbs.TimeAndAvails[idx];
-                if (taa.Time_s == t)
+                if (AmountSchedule_TimeAt(sbs.TimeAndAvails, idx) == t)
                 {
-                    flow_t outAvail_W = taa.Amount_W > sbs.MaxOutflow_W
+                    flow_t amount_W =
+                        AmountSchedule_AmountAt(sbs.TimeAndAvails, idx);
+                    flow_t outAvail_W = amount_W > sbs.MaxOutflow_W
                         ? sbs.MaxOutflow_W
-                        : taa.Amount_W;
+                        : amount_W;
                     if (ss.Flows[outIdx].Available_W != outAvail_W)
                     {
                         ss.ActiveConnectionsFront.insert(outIdx);
@@ -1624,9 +1628,20 @@ namespace erin
             ss.Flows[outflowConnIdx].Requested_W > cec.MaxOutflow_W
             ? cec.MaxOutflow_W
             : ss.Flows[outflowConnIdx].Requested_W;
-        flow_t inflowRequest_W =
-            static_cast<flow_t>(std::ceil(outflowRequest_W / cec.Efficiency));
-        assert(inflowRequest_W >= outflowRequest_W);
+        flow_t inflowRequest_W = 0;
+        if (cec.ReducedChainIdx.has_value())
+        {
+            inflowRequest_W = ReducedChain_Request(
+                m.ReducedChains[cec.ReducedChainIdx.value()], outflowRequest_W
+            );
+        }
+        else
+        {
+            inflowRequest_W = static_cast<flow_t>(
+                std::ceil(outflowRequest_W / cec.Efficiency)
+            );
+            assert(inflowRequest_W >= outflowRequest_W);
+        }
         if (inflowRequest_W != ss.Flows[cec.InflowConn].Requested_W)
         {
             ss.ActiveConnectionsBack.insert(cec.InflowConn);
@@ -1650,10 +1665,10 @@ namespace erin
             ss.Flows[outflowConnIdx].Requested_W > vec.MaxOutflow_W
             ? vec.MaxOutflow_W
             : ss.Flows[outflowConnIdx].Requested_W;
-        double efficiency = LookupTable_LookupInterp(
-            vec.OutflowsForEfficiency_W,
-            vec.Efficiencies,
-            static_cast<double>(outflowRequest_W)
+        double efficiency = LookupTable_Interp(
+            vec.EfficiencyByOutflow,
+            static_cast<double>(outflowRequest_W),
+            ss.VarEffConvCursors[2 * compIdx]
         );
         assert(efficiency > 0.0 && efficiency <= 1.0);
         flow_t inflowRequest_W =
@@ -1780,10 +1795,10 @@ namespace erin
             ss.Flows[outflowConnIdx].Requested_W > mov.MaxOutflow_W
             ? mov.MaxOutflow_W
             : ss.Flows[outflowConnIdx].Requested_W;
-        double cop = LookupTable_LookupInterp(
-            mov.OutflowsForCop_W,
-            mov.COPs,
-            static_cast<double>(outflowRequest_W)
+        double cop = LookupTable_Interp(
+            mov.CopByOutflow,
+            static_cast<double>(outflowRequest_W),
+            ss.VarEffMoverCursors[2 * moverIdx]
         );
         // outflow = COP * inflow
         // inflow = outflow / COP
@@ -2007,9 +2022,9 @@ namespace erin
         assert(outConnIdx == sbs.OutflowConn);
         auto wasteConn = model.ScheduledSrcs[sbsIdx].WasteflowConn;
         auto schIdx = ss.ScheduleBasedSourceIdx[sbsIdx];
-        auto available = sbs.TimeAndAvails[schIdx].Amount_W > sbs.MaxOutflow_W
-            ? sbs.MaxOutflow_W
-            : sbs.TimeAndAvails[schIdx].Amount_W;
+        flow_t amount_W = AmountSchedule_AmountAt(sbs.TimeAndAvails, schIdx);
+        auto available =
+            amount_W > sbs.MaxOutflow_W ? sbs.MaxOutflow_W : amount_W;
         auto spillage = available > ss.Flows[outConnIdx].Requested_W
             ? available - ss.Flows[outConnIdx].Requested_W
             : 0;
@@ -2058,6 +2073,7 @@ namespace erin
     {
         while (!ss.ActiveConnectionsBack.empty())
         {
+            Profile_Count(ProfileCounter::BackwardPasses);
             auto temp = std::vector<size_t>(
                 ss.ActiveConnectionsBack.begin(), ss.ActiveConnectionsBack.end()
             );
@@ -2067,6 +2083,9 @@ namespace erin
                 size_t connIdx = *it;
                 size_t compIdx = model.Connections[connIdx].FromIdx;
                 size_t compId = model.Connections[connIdx].FromId;
+                Hotspots_RecordBackwardRun(
+                    connIdx, ss.Flows[connIdx].Requested_W
+                );
                 if (ss.UnavailableComponents.contains(compId))
                 {
                     // TODO: test if we need to call this
@@ -2250,12 +2269,23 @@ namespace erin
         ConstantEfficiencyConverter const& cec = m.ConstEffConvs[compIdx];
         assert(cec.InflowConn == inflowConnIdx);
         flow_t inflowAvailable_W = ss.Flows[inflowConnIdx].Available_W;
-        flow_t outflowAvailable_W =
-            static_cast<flow_t>(std::floor(cec.Efficiency * inflowAvailable_W));
-        assert(inflowAvailable_W >= outflowAvailable_W);
-        if (outflowAvailable_W > cec.MaxOutflow_W)
+        flow_t outflowAvailable_W = 0;
+        if (cec.ReducedChainIdx.has_value())
+        {
+            outflowAvailable_W = ReducedChain_Available(
+                m.ReducedChains[cec.ReducedChainIdx.value()], inflowAvailable_W
+            );
+        }
+        else
         {
-            outflowAvailable_W = cec.MaxOutflow_W;
+            outflowAvailable_W = static_cast<flow_t>(
+                std::floor(cec.Efficiency * inflowAvailable_W)
+            );
+            assert(inflowAvailable_W >= outflowAvailable_W);
+            if (outflowAvailable_W > cec.MaxOutflow_W)
+            {
+                outflowAvailable_W = cec.MaxOutflow_W;
+            }
         }
         if (outflowAvailable_W != ss.Flows[cec.OutflowConn].Available_W)
         {
@@ -2277,10 +2307,10 @@ namespace erin
         assert(inflowConnIdx == vec.InflowConn);
         size_t outflowConn = vec.OutflowConn;
         flow_t inflowAvailable_W = ss.Flows[inflowConnIdx].Available_W;
-        double efficiency = LookupTable_LookupInterp(
-            vec.InflowsForEfficiency_W,
-            vec.Efficiencies,
-            static_cast<double>(inflowAvailable_W)
+        double efficiency = LookupTable_Interp(
+            vec.EfficiencyByInflow,
+            static_cast<double>(inflowAvailable_W),
+            ss.VarEffConvCursors[2 * compIdx + 1]
         );
         assert(efficiency > 0.0 && efficiency <= 1.0);
         flow_t outflowAvailable =
@@ -2335,10 +2365,10 @@ namespace erin
         VariableEfficiencyMover const& mov = model.VarEffMovers[moverIdx];
         flow_t inflowAvailable_W = ss.Flows[outConnIdx].Available_W;
         size_t outflowConn = mov.OutflowConn;
-        double cop = LookupTable_LookupInterp(
-            mov.InflowsForCop_W,
-            mov.COPs,
-            static_cast<double>(inflowAvailable_W)
+        double cop = LookupTable_Interp(
+            mov.CopByInflow,
+            static_cast<double>(inflowAvailable_W),
+            ss.VarEffMoverCursors[2 * moverIdx + 1]
         );
         // outflow = cop * inflow
         flow_t outflowAvailable_W = static_cast<flow_t>(
@@ -2517,6 +2547,7 @@ namespace erin
     {
         while (!ss.ActiveConnectionsFront.empty())
         {
+            Profile_Count(ProfileCounter::ForwardPasses);
             auto temp = std::vector<size_t>(
                 ss.ActiveConnectionsFront.begin(),
                 ss.ActiveConnectionsFront.end()
@@ -2527,6 +2558,9 @@ namespace erin
                 size_t connIdx = *it;
                 size_t compIdx = model.Connections[connIdx].ToIdx;
                 size_t compId = model.Connections[connIdx].ToId;
+                Hotspots_RecordForwardRun(
+                    connIdx, ss.Flows[connIdx].Available_W
+                );
                 if (ss.UnavailableComponents.contains(compId))
                 {
                     // TODO: test if we need to call this
@@ -2618,6 +2652,10 @@ namespace erin
         Store const& store = model.Stores[compIdx];
         size_t outflowConn = store.OutflowConn;
         std::optional<size_t> maybeInflowConn = store.InflowConn;
+        // NOTE: event times are computed from the exact stored energy so that
+        // the steps taken up to them, remainder included, land on the limit
+        double stored_J = static_cast<double>(ss.StorageAmounts_J[compIdx])
+            + ss.StorageRemainders_J[compIdx];
         int64_t netCharge_W =
             -1 * static_cast<int64_t>(ss.Flows[outflowConn].Actual_W);
         if (maybeInflowConn.has_value())
@@ -2639,11 +2677,10 @@ namespace erin
                 ss.Flows[wfIdx].Available_W = wasteflow_W;
                 ss.Flows[wfIdx].Actual_W = wasteflow_W;
             }
-            ss.StorageNextEventTimes[compIdx] = t
-                + (static_cast<double>(
-                       store.Capacity_J - ss.StorageAmounts_J[compIdx]
-                   )
-                   / static_cast<double>(storeflow_W));
+            double room_J =
+                std::max(static_cast<double>(store.Capacity_J) - stored_J, 0.0);
+            ss.StorageNextEventTimes[compIdx] =
+                t + (room_J / static_cast<double>(storeflow_W));
         }
         else if (netCharge_W < 0 && store.InflowConn.has_value()
                  && (ss.StorageAmounts_J[compIdx] > store.ChargeAmount_J))
@@ -2656,9 +2693,7 @@ namespace erin
                 ss.Flows[wfIdx].Actual_W = 0;
             }
             ss.StorageNextEventTimes[compIdx] = t
-                + (static_cast<double>(
-                       ss.StorageAmounts_J[compIdx] - store.ChargeAmount_J
-                   )
+                + ((stored_J - static_cast<double>(store.ChargeAmount_J))
                    / (-1.0 * static_cast<double>(netCharge_W)));
         }
         else if (netCharge_W < 0)
@@ -2671,7 +2706,7 @@ namespace erin
                 ss.Flows[wfIdx].Actual_W = 0;
             }
             ss.StorageNextEventTimes[compIdx] = t
-                + (static_cast<double>(ss.StorageAmounts_J[compIdx])
+                + (std::max(stored_J, 0.0)
                    / (-1.0 * static_cast<double>(netCharge_W)));
         }
         else // netCharge_W = 0
@@ -2712,22 +2747,45 @@ namespace erin
         size_t num_times = 0;
         do
         {
+            TraceSpan span{"iteration", "RunActiveConnections"};
+            if (span.Active)
+            {
+                span.Args = fmt::format("\"iteration\": {}", num_times);
+                Trace_AddCounter(
+                    "active connections",
+                    fmt::format(
+                        "\"backward\": {}, \"forward\": {}",
+                        ss.ActiveConnectionsBack.size(),
+                        ss.ActiveConnectionsFront.size()
+                    )
+                );
+            }
             RunConnectionsBackward(model, ss);
             RunConnectionsForward(model, ss);
             ++num_times;
         } while (num_times < max_times
                  && (ss.ActiveConnectionsBack.size() > 0
                      || ss.ActiveConnectionsFront.size() > 0));
+        Profile_Count(ProfileCounter::ActiveConnectionIterations, num_times);
         if (num_times == max_times)
         {
             std::cout << "WARNING! iterated " << max_times
                       << " to resolve connections" << std::endl;
+            if (Trace_IsEnabled())
+            {
+                Trace_AddInstant(
+                    "iteration cap reached",
+                    "RunActiveConnections",
+                    fmt::format("\"time_s\": {}", t)
+                );
+            }
         }
         else
         {
             assert(ss.ActiveConnectionsBack.size() == 0);
             assert(ss.ActiveConnectionsFront.size() == 0);
         }
+        Model_ReconstructReducedFlows(model, ss);
         FinalizeFlows(ss);
         RunConnectionsPostFinalization(model, ss, t);
     }
@@ -2757,11 +2815,11 @@ namespace erin
     )
     {
         auto nextIdx = ss.ScheduleBasedLoadIdx[sbIdx] + 1;
-        if (nextIdx >= sb.TimesAndLoads.size())
+        if (nextIdx >= AmountSchedule_Size(sb.TimesAndLoads))
         {
             return infinity;
         }
-        return sb.TimesAndLoads[nextIdx].Time_s;
+        return AmountSchedule_TimeAt(sb.TimesAndLoads, nextIdx);
     }
 
     double
@@ -2772,11 +2830,11 @@ namespace erin
     )
     {
         auto nextIdx = ss.ScheduleBasedSourceIdx[sbIdx] + 1;
-        if (nextIdx >= sb.TimeAndAvails.size())
+        if (nextIdx >= AmountSchedule_Size(sb.TimeAndAvails))
         {
             return infinity;
         }
-        return sb.TimeAndAvails[nextIdx].Time_s;
+        return AmountSchedule_TimeAt(sb.TimeAndAvails, nextIdx);
     }
 
     double
@@ -2813,7 +2871,6 @@ namespace erin
         for (size_t storeIdx = 0; storeIdx < m.Stores.size(); ++storeIdx)
         {
             Store const& store = m.Stores[storeIdx];
-            int64_t netEnergyAdded_J = 0;
             std::optional<size_t> maybeInConn = store.InflowConn;
             size_t outConn = store.OutflowConn;
             size_t compId = m.Connections[outConn].FromId;
@@ -2827,25 +2884,24 @@ namespace erin
                 - static_cast<int64_t>(ss.StorageAmounts_J[storeIdx]);
             int64_t availableDischarge_J =
                 -1 * static_cast<int64_t>(ss.StorageAmounts_J[storeIdx]);
+            // NOTE: the net flow is integrated once and rounded to whole
+            // joules; the fraction left over is carried to the next step
+            int64_t netFlow_W =
+                -1 * static_cast<int64_t>(ss.Flows[outConn].Actual_W);
             if (maybeInConn.has_value())
             {
                 size_t inConn = maybeInConn.value();
-                double actualInflow_W =
-                    static_cast<double>(ss.Flows[inConn].Actual_W);
-                netEnergyAdded_J +=
-                    std::llround(elapsedTime_s * actualInflow_W);
-            }
-            double actualOutflow_W =
-                static_cast<double>(ss.Flows[outConn].Actual_W);
-            netEnergyAdded_J -= std::llround(elapsedTime_s * actualOutflow_W);
+                netFlow_W += static_cast<int64_t>(ss.Flows[inConn].Actual_W);
+            }
             if (store.WasteflowConn.has_value())
             {
                 size_t wConn = store.WasteflowConn.value();
-                double actualWasteflow_W =
-                    static_cast<double>(ss.Flows[wConn].Actual_W);
-                netEnergyAdded_J -=
-                    std::llround(elapsedTime_s * actualWasteflow_W);
+                netFlow_W -= static_cast<int64_t>(ss.Flows[wConn].Actual_W);
             }
+            double exactEnergyAdded_J =
+                elapsedTime_s * static_cast<double>(netFlow_W)
+                + ss.StorageRemainders_J[storeIdx];
+            int64_t netEnergyAdded_J = std::llround(exactEnergyAdded_J);
             if (netEnergyAdded_J > availableCharge_J)
             {
                 std::cout << "ERROR: netEnergyAdded is greater than capacity!"
@@ -2955,6 +3011,8 @@ namespace erin
                 && "netEnergyAdded cannot use more energy than available"
             );
             ss.StorageAmounts_J[storeIdx] += netEnergyAdded_J;
+            ss.StorageRemainders_J[storeIdx] =
+                exactEnergyAdded_J - static_cast<double>(netEnergyAdded_J);
         }
     }
 
@@ -2967,9 +3025,10 @@ namespace erin
     {
         for (size_t i = 0; i < m.ScheduledLoads.size(); ++i)
         {
+            AmountSchedule const& schedule = m.ScheduledLoads[i].TimesAndLoads;
             size_t nextIdx = ss.ScheduleBasedLoadIdx[i] + 1;
-            if (nextIdx < m.ScheduledLoads[i].TimesAndLoads.size()
-                && m.ScheduledLoads[i].TimesAndLoads[nextIdx].Time_s == time)
+            if (nextIdx < AmountSchedule_Size(schedule)
+                && AmountSchedule_TimeAt(schedule, nextIdx) == time)
             {
                 ss.ScheduleBasedLoadIdx[i] = nextIdx;
             }
@@ -2985,9 +3044,10 @@ namespace erin
     {
         for (size_t i = 0; i < m.ScheduledSrcs.size(); ++i)
         {
+            AmountSchedule const& schedule = m.ScheduledSrcs[i].TimeAndAvails;
             size_t nextIdx = ss.ScheduleBasedSourceIdx[i] + 1;
-            if (nextIdx < m.ScheduledSrcs[i].TimeAndAvails.size()
-                && m.ScheduledSrcs[i].TimeAndAvails[nextIdx].Time_s == time)
+            if (nextIdx < AmountSchedule_Size(schedule)
+                && AmountSchedule_TimeAt(schedule, nextIdx) == time)
             {
                 ss.ScheduleBasedSourceIdx[i] = nextIdx;
             }
@@ -3369,6 +3429,28 @@ namespace erin
         return newAmounts;
     }
 
+    TimeAndFlows
+    CaptureResult(
+        SimulationState const& ss,
+        double t,
+        ResultProjection const& projection
+    )
+    {
+        TimeAndFlows taf{};
+        taf.Time = t;
+        taf.Flows.reserve(projection.ConnIds.size());
+        for (size_t connId : projection.ConnIds)
+        {
+            taf.Flows.push_back(ss.Flows[connId]);
+        }
+        taf.StorageAmounts_J.reserve(projection.StoreIdxs.size());
+        for (size_t storeIdx : projection.StoreIdxs)
+        {
+            taf.StorageAmounts_J.push_back(ss.StorageAmounts_J[storeIdx]);
+        }
+        return taf;
+    }
+
     void
     PrintModelState(Model& m, SimulationState& ss)
     {
@@ -3404,6 +3486,11 @@ namespace erin
         {
             ss.StorageAmounts_J.push_back(model.Stores[i].InitialStorage_J);
         }
+        ss.StorageRemainders_J = std::vector<double>(model.Stores.size(), 0.0);
+        ss.VarEffConvCursors =
+            std::vector<size_t>(2 * model.VarEffConvs.size(), 0);
+        ss.VarEffMoverCursors =
+            std::vector<size_t>(2 * model.VarEffMovers.size(), 0);
         ss.StorageNextEventTimes =
             std::vector<double>(model.Stores.size(), 0.0);
         ss.Flows = std::vector<Flow>(model.Connections.size(), {0, 0, 0});
@@ -3411,12 +3498,473 @@ namespace erin
             std::vector<size_t>(model.ScheduledLoads.size(), 0);
         ss.ScheduleBasedSourceIdx =
             std::vector<size_t>(model.ScheduledSrcs.size(), 0);
+        size_t numMergedLoads = 0;
+        for (LoadMerge const& merge : model.LoadMerges)
+        {
+            numMergedLoads += merge.LoadIdxs.size();
+        }
+        ss.MergedLoadIdx = std::vector<size_t>(numMergedLoads, 0);
         for (size_t i = 0; i < model.Switches.size(); ++i)
         {
             ss.SwitchStates.push_back(SwitchState::Primary);
         }
     }
 
+    // chains of two or more eligible components of one type where each
+    // passes its outflow (port 0) straight to the next; listed as component
+    // indices in flow order
+    static std::vector<std::vector<size_t>>
+    FindReducibleChains(
+        Model const& m,
+        ComponentType type,
+        std::vector<size_t> const& inflowConns,
+        std::vector<size_t> const& outflowConns,
+        std::vector<bool> const& isEligible
+    )
+    {
+        auto isInternal = [&](size_t connId) -> bool
+        {
+            Connection const& conn = m.Connections[connId];
+            return conn.From == type && conn.To == type && conn.FromPort == 0
+                && conn.ToPort == 0 && isEligible[conn.FromIdx]
+                && isEligible[conn.ToIdx]
+                && outflowConns[conn.FromIdx] == connId
+                && inflowConns[conn.ToIdx] == connId;
+        };
+        std::vector<std::vector<size_t>> chains;
+        for (size_t idx = 0; idx < isEligible.size(); ++idx)
+        {
+            if (!isEligible[idx] || isInternal(inflowConns[idx]))
+            {
+                continue;
+            }
+            std::vector<size_t> chain{idx};
+            // NOTE: a chain only ends at a component that is not eligible,
+            // so cycles have no start and are never followed
+            while (isInternal(outflowConns[chain.back()]))
+            {
+                chain.push_back(m.Connections[outflowConns[chain.back()]].ToIdx
+                );
+            }
+            if (chain.size() > 1)
+            {
+                chains.push_back(std::move(chain));
+            }
+        }
+        return chains;
+    }
+
+    size_t
+    Model_Reduce(Model& m, std::unordered_set<size_t> const& mayFailCompIds)
+    {
+        assert(m.ReducedChains.empty());
+        auto isConnected = [&](ComponentType type,
+                               size_t idx,
+                               size_t inflowConn,
+                               size_t outflowConn) -> bool
+        {
+            if (inflowConn >= m.Connections.size()
+                || outflowConn >= m.Connections.size())
+            {
+                return false;
+            }
+            Connection const& in = m.Connections[inflowConn];
+            Connection const& out = m.Connections[outflowConn];
+            return in.To == type && in.ToIdx == idx && out.From == type
+                && out.FromIdx == idx && !mayFailCompIds.contains(in.ToId);
+        };
+        size_t numEliminated = 0;
+        // NOTE: pass-throughs in a chain simply cap their flow, so the two
+        // ends take the smallest cap of the chain
+        std::vector<size_t> inflowConns(m.PassThroughs.size());
+        std::vector<size_t> outflowConns(m.PassThroughs.size());
+        std::vector<bool> isEligible(m.PassThroughs.size());
+        for (size_t idx = 0; idx < m.PassThroughs.size(); ++idx)
+        {
+            PassThrough const& pt = m.PassThroughs[idx];
+            inflowConns[idx] = pt.InflowConn;
+            outflowConns[idx] = pt.OutflowConn;
+            isEligible[idx] = isConnected(
+                ComponentType::PassThroughType,
+                idx,
+                pt.InflowConn,
+                pt.OutflowConn
+            );
+        }
+        for (std::vector<size_t> const& chain : FindReducibleChains(
+                 m,
+                 ComponentType::PassThroughType,
+                 inflowConns,
+                 outflowConns,
+                 isEligible
+             ))
+        {
+            ReducedChain reduced{};
+            reduced.Type = ComponentType::PassThroughType;
+            reduced.ConnIds.push_back(m.PassThroughs[chain.front()].InflowConn);
+            flow_t maxOutflow_W = max_flow_W;
+            for (size_t idx : chain)
+            {
+                PassThrough const& pt = m.PassThroughs[idx];
+                reduced.ConnIds.push_back(pt.OutflowConn);
+                reduced.MaxOutflows_W.push_back(pt.MaxOutflow_W);
+                maxOutflow_W = std::min(maxOutflow_W, pt.MaxOutflow_W);
+            }
+            PassThrough& first = m.PassThroughs[chain.front()];
+            PassThrough& last = m.PassThroughs[chain.back()];
+            first.OutflowConn = reduced.ConnIds.back();
+            first.MaxOutflow_W = maxOutflow_W;
+            last.InflowConn = reduced.ConnIds.front();
+            last.MaxOutflow_W = maxOutflow_W;
+            numEliminated += reduced.ConnIds.size() - 2;
+            m.ReducedChains.push_back(std::move(reduced));
+        }
+        // NOTE: converters round at each stage, so a run keeps its stages
+        // rather than one combined efficiency
+        inflowConns.assign(m.ConstEffConvs.size(), 0);
+        outflowConns.assign(m.ConstEffConvs.size(), 0);
+        isEligible.assign(m.ConstEffConvs.size(), false);
+        for (size_t idx = 0; idx < m.ConstEffConvs.size(); ++idx)
+        {
+            ConstantEfficiencyConverter const& cec = m.ConstEffConvs[idx];
+            inflowConns[idx] = cec.InflowConn;
+            outflowConns[idx] = cec.OutflowConn;
+            isEligible[idx] = !cec.LossflowConn.has_value()
+                && isConnected(
+                    ComponentType::ConstantEfficiencyConverterType,
+                    idx,
+                    cec.InflowConn,
+                    cec.OutflowConn
+                );
+        }
+        for (std::vector<size_t> const& chain : FindReducibleChains(
+                 m,
+                 ComponentType::ConstantEfficiencyConverterType,
+                 inflowConns,
+                 outflowConns,
+                 isEligible
+             ))
+        {
+            ReducedChain reduced{};
+            reduced.Type = ComponentType::ConstantEfficiencyConverterType;
+            reduced.ConnIds.push_back(m.ConstEffConvs[chain.front()].InflowConn
+            );
+            for (size_t idx : chain)
+            {
+                ConstantEfficiencyConverter const& cec = m.ConstEffConvs[idx];
+                reduced.ConnIds.push_back(cec.OutflowConn);
+                reduced.Efficiencies.push_back(cec.Efficiency);
+                reduced.MaxOutflows_W.push_back(cec.MaxOutflow_W);
+                reduced.WasteflowConns.push_back(cec.WasteflowConn);
+            }
+            size_t chainIdx = m.ReducedChains.size();
+            ConstantEfficiencyConverter& first = m.ConstEffConvs[chain.front()];
+            ConstantEfficiencyConverter& last = m.ConstEffConvs[chain.back()];
+            first.OutflowConn = reduced.ConnIds.back();
+            first.ReducedChainIdx = chainIdx;
+            last.InflowConn = reduced.ConnIds.front();
+            last.ReducedChainIdx = chainIdx;
+            numEliminated += reduced.ConnIds.size() - 2;
+            m.ReducedChains.push_back(std::move(reduced));
+        }
+        return numEliminated;
+    }
+
+    static flow_t
+    ReducedChain_StageRequest(
+        ReducedChain const& chain,
+        size_t stage,
+        flow_t outflowRequest_W
+    )
+    {
+        flow_t request_W = outflowRequest_W > chain.MaxOutflows_W[stage]
+            ? chain.MaxOutflows_W[stage]
+            : outflowRequest_W;
+        if (chain.Type == ComponentType::ConstantEfficiencyConverterType)
+        {
+            request_W = static_cast<flow_t>(
+                std::ceil(request_W / chain.Efficiencies[stage])
+            );
+        }
+        return request_W;
+    }
+
+    static flow_t
+    ReducedChain_StageAvailable(
+        ReducedChain const& chain,
+        size_t stage,
+        flow_t inflowAvailable_W
+    )
+    {
+        flow_t available_W = inflowAvailable_W;
+        if (chain.Type == ComponentType::ConstantEfficiencyConverterType)
+        {
+            available_W = static_cast<flow_t>(
+                std::floor(chain.Efficiencies[stage] * inflowAvailable_W)
+            );
+        }
+        return available_W > chain.MaxOutflows_W[stage]
+            ? chain.MaxOutflows_W[stage]
+            : available_W;
+    }
+
+    flow_t
+    ReducedChain_Request(ReducedChain const& chain, flow_t outflowRequest_W)
+    {
+        flow_t request_W = outflowRequest_W;
+        for (size_t stage = chain.MaxOutflows_W.size(); stage > 0; --stage)
+        {
+            request_W = ReducedChain_StageRequest(chain, stage - 1, request_W);
+        }
+        return request_W;
+    }
+
+    flow_t
+    ReducedChain_Available(ReducedChain const& chain, flow_t inflowAvailable_W)
+    {
+        flow_t available_W = inflowAvailable_W;
+        for (size_t stage = 0; stage < chain.MaxOutflows_W.size(); ++stage)
+        {
+            available_W =
+                ReducedChain_StageAvailable(chain, stage, available_W);
+        }
+        return available_W;
+    }
+
+    void
+    Model_ReconstructReducedFlows(Model const& m, SimulationState& ss)
+    {
+        for (ReducedChain const& chain : m.ReducedChains)
+        {
+            size_t numStages = chain.MaxOutflows_W.size();
+            for (size_t stage = numStages - 1; stage > 0; --stage)
+            {
+                ss.Flows[chain.ConnIds[stage]].Requested_W =
+                    ReducedChain_StageRequest(
+                        chain,
+                        stage,
+                        ss.Flows[chain.ConnIds[stage + 1]].Requested_W
+                    );
+            }
+            for (size_t stage = 0; stage + 1 < numStages; ++stage)
+            {
+                ss.Flows[chain.ConnIds[stage + 1]].Available_W =
+                    ReducedChain_StageAvailable(
+                        chain, stage, ss.Flows[chain.ConnIds[stage]].Available_W
+                    );
+            }
+            for (size_t stage = 0; stage < chain.WasteflowConns.size();
+                 ++stage)
+            {
+                Flow const& in = ss.Flows[chain.ConnIds[stage]];
+                Flow const& out = ss.Flows[chain.ConnIds[stage + 1]];
+                flow_t inflow =
+                    FinalizeFlowValue(in.Requested_W, in.Available_W);
+                flow_t outflow = FinalizeFlowValue(
+                    out.Requested_W,
+                    out.Available_W > chain.MaxOutflows_W[stage]
+                        ? chain.MaxOutflows_W[stage]
+                        : out.Available_W
+                );
+                flow_t wasteflow = inflow > outflow ? inflow - outflow : 0;
+                ss.Flows[chain.WasteflowConns[stage]].Requested_W = wasteflow;
+                ss.Flows[chain.WasteflowConns[stage]].Available_W = wasteflow;
+            }
+        }
+    }
+
+    size_t
+    Model_MergeLoads(
+        Model& m,
+        std::unordered_set<size_t> const& mayFailCompIds
+    )
+    {
+        assert(m.LoadMerges.empty());
+        size_t numEliminated = 0;
+        size_t numCursors = 0;
+        for (size_t muxIdx = 0; muxIdx < m.Muxes.size(); ++muxIdx)
+        {
+            Mux& mux = m.Muxes[muxIdx];
+            auto isMergeable = [&](size_t port) -> bool
+            {
+                Connection const& conn = m.Connections[mux.OutflowConns[port]];
+                return mux.MaxOutflows_W[port] == max_flow_W
+                    && conn.To == ComponentType::ScheduleBasedLoadType
+                    && !mayFailCompIds.contains(conn.FromId)
+                    && !mayFailCompIds.contains(conn.ToId);
+            };
+            std::vector<size_t> outflowConns;
+            std::vector<flow_t> maxOutflows_W;
+            size_t port = 0;
+            while (port < mux.NumOutports)
+            {
+                size_t runEnd = port;
+                while (runEnd < mux.NumOutports && isMergeable(runEnd))
+                {
+                    ++runEnd;
+                }
+                outflowConns.push_back(mux.OutflowConns[port]);
+                maxOutflows_W.push_back(mux.MaxOutflows_W[port]);
+                if (runEnd - port < 2)
+                {
+                    ++port;
+                    continue;
+                }
+                LoadMerge merge{};
+                merge.MuxIdx = muxIdx;
+                merge.FirstCursor = numCursors;
+                for (; port < runEnd; ++port)
+                {
+                    size_t connId = mux.OutflowConns[port];
+                    merge.LoadIdxs.push_back(m.Connections[connId].ToIdx);
+                    merge.InflowConns.push_back(connId);
+                }
+                numCursors += merge.LoadIdxs.size();
+                numEliminated += merge.LoadIdxs.size() - 1;
+                m.LoadMerges.push_back(std::move(merge));
+            }
+            // NOTE: the connections of the outports after a run keep their
+            // port numbers; the solver only goes by the connection lists
+            mux.NumOutports = outflowConns.size();
+            mux.OutflowConns = std::move(outflowConns);
+            mux.MaxOutflows_W = std::move(maxOutflows_W);
+        }
+        Model_MergeLoadSchedules(m);
+        return numEliminated;
+    }
+
+    // NOTE: a load applies its first entry only at time 0; a later first
+    // entry is never in effect
+    static flow_t
+    LoadSchedule_AmountAt(AmountSchedule const& schedule, size_t idx)
+    {
+        if (idx >= AmountSchedule_Size(schedule)
+            || (idx == 0 && AmountSchedule_TimeAt(schedule, 0) != 0.0))
+        {
+            return 0;
+        }
+        return AmountSchedule_AmountAt(schedule, idx);
+    }
+
+    void
+    Model_MergeLoadSchedules(Model& m)
+    {
+        using NextEntry = std::pair<double, size_t>;
+        for (LoadMerge& merge : m.LoadMerges)
+        {
+            size_t numLoads = merge.LoadIdxs.size();
+            merge.Schedules.resize(numLoads);
+            // time of each load's next entry and the load's position
+            std::priority_queue<
+                NextEntry,
+                std::vector<NextEntry>,
+                std::greater<NextEntry>>
+                pending;
+            std::vector<size_t> cursors(numLoads, 0);
+            flow_t total_W = 0;
+            for (size_t i = 0; i < numLoads; ++i)
+            {
+                AmountSchedule& schedule =
+                    m.ScheduledLoads[merge.LoadIdxs[i]].TimesAndLoads;
+                merge.Schedules[i] = std::move(schedule);
+                schedule = AmountSchedule{};
+                total_W = UtilSafeAdd(
+                    total_W, LoadSchedule_AmountAt(merge.Schedules[i], 0)
+                );
+                if (AmountSchedule_Size(merge.Schedules[i]) > 1)
+                {
+                    pending.push(
+                        {AmountSchedule_TimeAt(merge.Schedules[i], 1), i}
+                    );
+                }
+            }
+            // NOTE: every time any load changes stays an entry, even if the
+            // sum does not change, so that each load's flows are recorded
+            // at the same events as without merging
+            std::vector<TimeAndAmount> merged{{0.0, total_W}};
+            while (!pending.empty())
+            {
+                double time_s = pending.top().first;
+                while (!pending.empty() && pending.top().first == time_s)
+                {
+                    size_t i = pending.top().second;
+                    pending.pop();
+                    AmountSchedule const& schedule = merge.Schedules[i];
+                    total_W -= LoadSchedule_AmountAt(schedule, cursors[i]);
+                    ++cursors[i];
+                    total_W = UtilSafeAdd(
+                        total_W, LoadSchedule_AmountAt(schedule, cursors[i])
+                    );
+                    if (cursors[i] + 1 < AmountSchedule_Size(schedule))
+                    {
+                        pending.push(
+                            {AmountSchedule_TimeAt(schedule, cursors[i] + 1), i}
+                        );
+                    }
+                }
+                if (merged.back().Time_s == time_s)
+                {
+                    merged.back().Amount_W = total_W;
+                }
+                else
+                {
+                    merged.push_back({time_s, total_W});
+                }
+            }
+            m.ScheduledLoads[merge.LoadIdxs[0]].TimesAndLoads =
+                AmountSchedule_Make(std::move(merged));
+        }
+    }
+
+    void
+    Model_ExpandMergedLoads(Model const& m, SimulationState& ss, double t)
+    {
+        for (LoadMerge const& merge : m.LoadMerges)
+        {
+            // NOTE: the mux serves its outports in order, so the loads of a
+            // run are served in order out of what reaches the merged one
+            flow_t available_W = ss.Flows[merge.InflowConns[0]].Available_W;
+            for (size_t i = 0; i < merge.LoadIdxs.size(); ++i)
+            {
+                AmountSchedule const& schedule = merge.Schedules[i];
+                size_t& idx = ss.MergedLoadIdx[merge.FirstCursor + i];
+                while (idx + 1 < AmountSchedule_Size(schedule)
+                       && AmountSchedule_TimeAt(schedule, idx + 1) <= t)
+                {
+                    ++idx;
+                }
+                Flow& flow = ss.Flows[merge.InflowConns[i]];
+                flow.Requested_W = LoadSchedule_AmountAt(schedule, idx);
+                flow.Available_W = std::min(flow.Requested_W, available_W);
+                available_W -= flow.Available_W;
+            }
+            // NOTE: any surplus goes to the first unlimited outport
+            Flow& first = ss.Flows[merge.InflowConns[0]];
+            first.Available_W = UtilSafeAdd(first.Available_W, available_W);
+            for (size_t connId : merge.InflowConns)
+            {
+                Flow& flow = ss.Flows[connId];
+                flow.Actual_W =
+                    FinalizeFlowValue(flow.Requested_W, flow.Available_W);
+            }
+        }
+    }
+
+    void
+    Model_CollapseMergedLoads(Model const& m, SimulationState& ss)
+    {
+        for (LoadMerge const& merge : m.LoadMerges)
+        {
+            Flow merged{};
+            for (size_t connId : merge.InflowConns)
+            {
+                merged = merged + ss.Flows[connId];
+                ss.Flows[connId] = Flow{};
+            }
+            ss.Flows[merge.InflowConns[0]] = merged;
+        }
+    }
+
     size_t
     Model_AddFixedReliabilityDistribution(Model& m, double dt)
     {
@@ -3468,6 +4016,7 @@ namespace erin
             .WasteflowConn = 0,
             .MaxOutflow_W = max_flow_W,
         };
+        size_t idx = m.Movers.size();
         m.Movers.push_back(std::move(mov));
         size_t wasteId = Component_AddComponentReturningId(
             m.ComponentMap,
@@ -3492,7 +4041,7 @@ namespace erin
         size_t thisId = Component_AddComponentReturningId(
             m.ComponentMap,
             ComponentType::MoverType,
-            0,
+            idx,
             std::vector<size_t>{inflowTypeId, wasteflowId},
             std::vector<size_t>{outflowTypeId, wasteflowId},
             tag,
@@ -3529,6 +4078,10 @@ namespace erin
             // therefore, inflow = outflow / COP;
             inflowsForCop_W.push_back(outflowsForCop_W[i] / copByOutflow[i]);
         }
+        LookupTable copByOutflowTable =
+            LookupTable_Make(outflowsForCop_W, copByOutflow);
+        LookupTable copByInflowTable =
+            LookupTable_Make(inflowsForCop_W, copByOutflow);
         VariableEfficiencyMover mov = {
             .InflowConn = 0,
             .OutflowConn = 0,
@@ -3538,7 +4091,10 @@ namespace erin
             .OutflowsForCop_W = std::move(outflowsForCop_W),
             .InflowsForCop_W = std::move(inflowsForCop_W),
             .COPs = std::move(copByOutflow),
+            .CopByOutflow = std::move(copByOutflowTable),
+            .CopByInflow = std::move(copByInflowTable),
         };
+        size_t idx = m.VarEffMovers.size();
         m.VarEffMovers.push_back(std::move(mov));
         size_t wasteId = Component_AddComponentReturningId(
             m.ComponentMap,
@@ -3563,7 +4119,7 @@ namespace erin
         size_t thisId = Component_AddComponentReturningId(
             m.ComponentMap,
             ComponentType::VariableEfficiencyMoverType,
-            0,
+            idx,
             std::vector<size_t>{inflowTypeId, wasteflowId},
             std::vector<size_t>{outflowTypeId, wasteflowId},
             tag,
@@ -3608,6 +4164,10 @@ namespace erin
                         ss.ActiveConnectionsFront.insert(in0Conn);
                         ss.ActiveConnectionsFront.insert(in1Conn);
                         result = true;
+                        Profile_Count(ProfileCounter::SwitchFlips);
+                        Hotspots_RecordSwitchFlip(
+                            model.Connections[outConn].FromId
+                        );
                     }
                 }
                 break;
@@ -3620,6 +4180,10 @@ namespace erin
                         ss.ActiveConnectionsFront.insert(in0Conn);
                         ss.ActiveConnectionsFront.insert(in1Conn);
                         result = true;
+                        Profile_Count(ProfileCounter::SwitchFlips);
+                        Hotspots_RecordSwitchFlip(
+                            model.Connections[outConn].FromId
+                        );
                     }
                 }
                 break;
@@ -3634,172 +4198,572 @@ namespace erin
         return result;
     }
 
-    std::vector<TimeAndFlows>
-    Simulate(Model& model, bool verbose, bool enableSwitchLogic, Log const& log)
+    void
+    Simulate_ProcessEvents(
+        Model& model,
+        SimulationState& ss,
+        double t,
+        std::vector<TimeAndFlows>& timeAndFlows,
+        bool verbose,
+        bool enableSwitchLogic,
+        Log const& log,
+        ResultCapture const& capture
+    )
     {
-        double t = 0.0;
-        std::vector<TimeAndFlows> timeAndFlows{};
-        SimulationState ss{};
-        Model_SetupSimulationState(model, ss);
-        // TODO: add units to FinalTime (append '_s')
-        while (t != infinity && t <= model.FinalTime)
-        {
-            // schedule each event-generating component for next event
-            // by adding to the ActiveComponentBack or ActiveComponentFront
-            // arrays
-            // note: these two arrays could be sorted by component type for
-            // faster running over loops...
-            ActivateConnectionsForReliability(model, ss, t, verbose);
-            ActivateConnectionsForScheduleBasedLoads(model, ss, t);
-            ActivateConnectionsForScheduleBasedSources(model, ss, t);
-            ActivateConnectionsForStores(model, ss, t);
-            // TODO: remove this if statement after we add a delay capability to
-            // constant loads and constant sources
-            if (t == 0)
-            {
-                ActivateConnectionsForConstantLoads(model, ss);
-                ActivateConnectionsForConstantSources(model, ss);
-            }
-            size_t const maxLoop = 1'000;
-            for (size_t loopIter = 0; loopIter < maxLoop; ++loopIter)
-            {
-                if (CountActiveConnections(ss) == 0)
-                {
-                    if (verbose)
-                    {
-                        Log_Debug(log, fmt::format("loop iter: {}", loopIter));
-                    }
-                    break;
+        Profile_Count(ProfileCounter::Events);
+        TraceSpan span{"event", "Simulate"};
+        if (span.Active)
+        {
+            span.Args = fmt::format("\"time_s\": {}", t);
+            Trace_AddCounter(
+                "unavailable components",
+                fmt::format("\"count\": {}", ss.UnavailableComponents.size())
+            );
+        }
+        // schedule each event-generating component for next event
+        // by adding to the ActiveComponentBack or ActiveComponentFront
+        // arrays
+        // note: these two arrays could be sorted by component type for
+        // faster running over loops...
+        ActivateConnectionsForReliability(model, ss, t, verbose);
+        ActivateConnectionsForScheduleBasedLoads(model, ss, t);
+        ActivateConnectionsForScheduleBasedSources(model, ss, t);
+        ActivateConnectionsForStores(model, ss, t);
+        // TODO: remove this if statement after we add a delay capability to
+        // constant loads and constant sources
+        if (t == 0)
+        {
+            ActivateConnectionsForConstantLoads(model, ss);
+            ActivateConnectionsForConstantSources(model, ss);
+        }
+        size_t const maxLoop = 1'000;
+        bool ranConnections = false;
+        for (size_t loopIter = 0; loopIter < maxLoop; ++loopIter)
+        {
+            if (CountActiveConnections(ss) == 0)
+            {
+                if (verbose)
+                {
+                    Log_Debug(log, fmt::format("loop iter: {}", loopIter));
                 }
-                RunActiveConnections(model, ss, t);
-                if (enableSwitchLogic)
+                break;
+            }
+            if (loopIter + 1 == maxLoop && span.Active)
+            {
+                Trace_AddInstant(
+                    "loop cap reached",
+                    "Simulate",
+                    fmt::format("\"time_s\": {}", t)
+                );
+            }
+            RunActiveConnections(model, ss, t);
+            ranConnections = true;
+            if (enableSwitchLogic)
+            {
+                bool anySwitchChanged = RunSwitchLogic(model, ss);
+                if (anySwitchChanged)
                 {
-                    bool anySwitchChanged = RunSwitchLogic(model, ss);
-                    if (anySwitchChanged)
-                    {
-                        RunActiveConnections(model, ss, t);
-                    }
+                    RunActiveConnections(model, ss, t);
                 }
             }
-            if (verbose)
+        }
+        // NOTE: stores are charged or discharged per elapsed time in whole
+        // joules; their next event times are recomputed from the rounded
+        // amounts at every event, including events that change no flows
+        if (!ranConnections)
+        {
+            RunConnectionsPostFinalization(model, ss, t);
+        }
+        if (verbose)
+        {
+            LogFlows(log, model, ss, t);
+            if (!PrintFlowSummary(SummarizeFlows(model, ss, t)))
             {
-                LogFlows(log, model, ss, t);
-                if (!PrintFlowSummary(SummarizeFlows(model, ss, t)))
+                Log_Warning(log, "FLOW IMBALANCE!");
+                std::map<size_t, int64_t> sumOfFlowsByCompId;
+                for (size_t connIdx = 0; connIdx < model.Connections.size();
+                     ++connIdx)
                 {
-                    Log_Warning(log, "FLOW IMBALANCE!");
-                    std::map<size_t, int64_t> sumOfFlowsByCompId;
-                    for (size_t connIdx = 0; connIdx < model.Connections.size();
-                         ++connIdx)
+                    size_t const& fromId =
+                        model.Connections[connIdx].FromId;
+                    size_t const& toId = model.Connections[connIdx].ToId;
+                    if (!sumOfFlowsByCompId.contains(fromId))
                     {
-                        size_t const& fromId =
-                            model.Connections[connIdx].FromId;
-                        size_t const& toId = model.Connections[connIdx].ToId;
-                        if (!sumOfFlowsByCompId.contains(fromId))
-                        {
-                            sumOfFlowsByCompId.insert({fromId, 0});
-                        }
-                        if (!sumOfFlowsByCompId.contains(toId))
-                        {
-                            sumOfFlowsByCompId.insert({toId, 0});
-                        }
-                        flow_t flow = ss.Flows[connIdx].Actual_W;
-                        sumOfFlowsByCompId[fromId] -= flow;
-                        sumOfFlowsByCompId[toId] += flow;
+                        sumOfFlowsByCompId.insert({fromId, 0});
                     }
-                    for (auto const& item : sumOfFlowsByCompId)
+                    if (!sumOfFlowsByCompId.contains(toId))
                     {
-                        size_t const& compId = item.first;
-                        ComponentType ctype =
-                            model.ComponentMap.CompType[compId];
-                        if (ctype == ComponentType::ConstantLoadType
-                            || ctype == ComponentType::ScheduleBasedLoadType
-                            || ctype == ComponentType::WasteSinkType
-                            || ctype == ComponentType::StoreType
-                            || ctype == ComponentType::ConstantSourceType
-                            || ctype == ComponentType::ScheduleBasedSourceType
-                            || ctype == ComponentType::EnvironmentSourceType)
-                        {
-                            continue;
-                        }
-                        if (item.second != 0)
+                        sumOfFlowsByCompId.insert({toId, 0});
+                    }
+                    flow_t flow = ss.Flows[connIdx].Actual_W;
+                    sumOfFlowsByCompId[fromId] -= flow;
+                    sumOfFlowsByCompId[toId] += flow;
+                }
+                for (auto const& item : sumOfFlowsByCompId)
+                {
+                    size_t const& compId = item.first;
+                    ComponentType ctype =
+                        model.ComponentMap.CompType[compId];
+                    if (ctype == ComponentType::ConstantLoadType
+                        || ctype == ComponentType::ScheduleBasedLoadType
+                        || ctype == ComponentType::WasteSinkType
+                        || ctype == ComponentType::StoreType
+                        || ctype == ComponentType::ConstantSourceType
+                        || ctype == ComponentType::ScheduleBasedSourceType
+                        || ctype == ComponentType::EnvironmentSourceType)
+                    {
+                        continue;
+                    }
+                    if (item.second != 0)
+                    {
+                        Log_Warning(
+                            log,
+                            fmt::format(
+                                "{} doesn't have a zero sum of all flows: "
+                                "{} W",
+                                model.ComponentMap.Tag[item.first],
+                                item.second
+                            )
+                        );
+                        for (size_t connIdx = 0;
+                             connIdx < model.Connections.size();
+                             ++connIdx)
                         {
-                            Log_Warning(
-                                log,
-                                fmt::format(
-                                    "{} doesn't have a zero sum of all flows: "
-                                    "{} W",
-                                    model.ComponentMap.Tag[item.first],
-                                    item.second
-                                )
-                            );
-                            for (size_t connIdx = 0;
-                                 connIdx < model.Connections.size();
-                                 ++connIdx)
+                            Connection const& conn =
+                                model.Connections[connIdx];
+                            if (conn.ToId == item.first)
                             {
-                                Connection const& conn =
-                                    model.Connections[connIdx];
-                                if (conn.ToId == item.first)
-                                {
-                                    Log_Warning(
-                                        log,
-                                        fmt::format(
-                                            "* +{:>16d} W (R: +{:>16d} W // A: "
-                                            "+{:>16d} W):: {}",
-                                            ss.Flows[connIdx].Actual_W,
-                                            ss.Flows[connIdx].Requested_W,
-                                            ss.Flows[connIdx].Available_W,
-                                            ConnectionToString(
-                                                model.ComponentMap, conn, true
-                                            )
+                                Log_Warning(
+                                    log,
+                                    fmt::format(
+                                        "* +{:>16d} W (R: +{:>16d} W // A: "
+                                        "+{:>16d} W):: {}",
+                                        ss.Flows[connIdx].Actual_W,
+                                        ss.Flows[connIdx].Requested_W,
+                                        ss.Flows[connIdx].Available_W,
+                                        ConnectionToString(
+                                            model.ComponentMap, conn, true
                                         )
-                                    );
-                                }
-                                if (conn.FromId == item.first)
-                                {
-                                    Log_Warning(
-                                        log,
-                                        fmt::format(
-                                            "* -{:>16d} W (R: -{:>16d} W // A: "
-                                            "-{:>16d} W):: {}",
-                                            ss.Flows[connIdx].Actual_W,
-                                            ss.Flows[connIdx].Requested_W,
-                                            ss.Flows[connIdx].Available_W,
-                                            ConnectionToString(
-                                                model.ComponentMap, conn, true
-                                            )
+                                    )
+                                );
+                            }
+                            if (conn.FromId == item.first)
+                            {
+                                Log_Warning(
+                                    log,
+                                    fmt::format(
+                                        "* -{:>16d} W (R: -{:>16d} W // A: "
+                                        "-{:>16d} W):: {}",
+                                        ss.Flows[connIdx].Actual_W,
+                                        ss.Flows[connIdx].Requested_W,
+                                        ss.Flows[connIdx].Available_W,
+                                        ConnectionToString(
+                                            model.ComponentMap, conn, true
                                         )
-                                    );
-                                }
+                                    )
+                                );
                             }
                         }
                     }
                 }
-                PrintModelState(model, ss);
-                Log_Info(log, "==== QUIESCENCE REACHED ====");
             }
+            PrintModelState(model, ss);
+            Log_Info(log, "==== QUIESCENCE REACHED ====");
+        }
+        Hotspots_EndEvent();
+        Model_ExpandMergedLoads(model, ss, t);
+        if (capture.Stats != nullptr)
+        {
+            OccurrenceStatsAccumulator_Add(
+                *capture.Stats, model, t, ss.Flows, ss.StorageAmounts_J
+            );
+        }
+        if (capture.Projection != nullptr)
+        {
+            timeAndFlows.push_back(CaptureResult(ss, t, *capture.Projection));
+        }
+        else
+        {
             TimeAndFlows taf = {};
             taf.Time = t;
             taf.Flows = CopyFlows(ss.Flows);
             taf.StorageAmounts_J = CopyStorageStates(ss);
             timeAndFlows.push_back(std::move(taf));
-            if (t == model.FinalTime)
+        }
+        Model_CollapseMergedLoads(model, ss);
+    }
+
+    double
+    Simulate_NextEventTime(
+        Model const& model,
+        SimulationState const& ss,
+        double t
+    )
+    {
+        if (t == model.FinalTime)
+        {
+            return infinity;
+        }
+        double nextTime = EarliestNextEvent(model, ss, t);
+        if ((nextTime == infinity && t < model.FinalTime)
+            || (nextTime > model.FinalTime))
+        {
+            nextTime = model.FinalTime;
+        }
+        return nextTime;
+    }
+
+    struct HotspotRow
+    {
+        std::string Tag;
+        std::string Type;
+        uint64_t BackwardRuns = 0;
+        uint64_t ForwardRuns = 0;
+        uint64_t Reactivations = 0;
+        uint64_t MaxRunsPerEvent = 0;
+        uint64_t Oscillations = 0;
+        uint64_t SwitchFlips = 0;
+    };
+
+    static void
+    HotspotRow_AddPasses(
+        HotspotRow& row,
+        HotspotPasses const& passes,
+        size_t connIdx,
+        bool isBackward
+    )
+    {
+        if (connIdx >= passes.Runs.size())
+        {
+            return;
+        }
+        (isBackward ? row.BackwardRuns : row.ForwardRuns) +=
+            passes.Runs[connIdx];
+        row.Reactivations += passes.Reactivations[connIdx];
+        row.MaxRunsPerEvent =
+            std::max(row.MaxRunsPerEvent, passes.MaxRunsPerEvent[connIdx]);
+        row.Oscillations += passes.Oscillations[connIdx];
+    }
+
+    static void
+    HotspotRows_Write(
+        std::ostream& out,
+        std::string const& kind,
+        std::vector<HotspotRow>& rows
+    )
+    {
+        std::stable_sort(
+            rows.begin(),
+            rows.end(),
+            [](HotspotRow const& a, HotspotRow const& b)
             {
-                break;
+                uint64_t aRuns = a.BackwardRuns + a.ForwardRuns;
+                uint64_t bRuns = b.BackwardRuns + b.ForwardRuns;
+                if (aRuns != bRuns)
+                {
+                    return aRuns > bRuns;
+                }
+                return a.Reactivations > b.Reactivations;
+            }
+        );
+        for (size_t i = 0; i < rows.size(); ++i)
+        {
+            HotspotRow const& row = rows[i];
+            out << fmt::format(
+                "{},{},{},{},{},{},{},{},{},{},{}\n",
+                kind,
+                i + 1,
+                row.Tag,
+                row.Type,
+                row.BackwardRuns + row.ForwardRuns,
+                row.BackwardRuns,
+                row.ForwardRuns,
+                row.Reactivations,
+                row.MaxRunsPerEvent,
+                row.Oscillations,
+                row.SwitchFlips
+            );
+        }
+    }
+
+    Result
+    Hotspots_WriteCsv(
+        Hotspots const& hotspots,
+        Model const& model,
+        std::string const& filename
+    )
+    {
+        std::ofstream out{filename};
+        if (!out.good())
+        {
+            return Result::Failure;
+        }
+        std::vector<HotspotRow> compRows(model.ComponentMap.Tag.size());
+        for (size_t compId = 0; compId < compRows.size(); ++compId)
+        {
+            compRows[compId].Tag = model.ComponentMap.Tag[compId];
+            compRows[compId].Type =
+                ToString(model.ComponentMap.CompType[compId]);
+            if (compId < hotspots.SwitchFlips.size())
+            {
+                compRows[compId].SwitchFlips = hotspots.SwitchFlips[compId];
+            }
+        }
+        std::vector<HotspotRow> connRows(model.Connections.size());
+        for (size_t connIdx = 0; connIdx < connRows.size(); ++connIdx)
+        {
+            Connection const& conn = model.Connections[connIdx];
+            HotspotRow& row = connRows[connIdx];
+            row.Tag = ConnectionToString(model.ComponentMap, conn, true);
+            row.Type = "connection";
+            HotspotRow_AddPasses(row, hotspots.Backward, connIdx, true);
+            HotspotRow_AddPasses(row, hotspots.Forward, connIdx, false);
+            if (conn.FromId < compRows.size())
+            {
+                HotspotRow_AddPasses(
+                    compRows[conn.FromId], hotspots.Backward, connIdx, true
+                );
             }
-            double nextTime = EarliestNextEvent(model, ss, t);
-            if ((nextTime == infinity && t < model.FinalTime)
-                || (nextTime > model.FinalTime))
+            if (conn.ToId < compRows.size())
             {
-                nextTime = model.FinalTime;
+                HotspotRow_AddPasses(
+                    compRows[conn.ToId], hotspots.Forward, connIdx, false
+                );
             }
-            UpdateStoresPerElapsedTime(model, ss, nextTime - t);
-            UpdateScheduleBasedLoadNextEvent(model, ss, nextTime);
-            UpdateScheduleBasedSourceNextEvent(model, ss, nextTime);
+        }
+        out << "kind,rank,tag,type,kernel runs,backward runs,forward runs,"
+               "re-activations,max runs per event,oscillations,switch flips\n";
+        HotspotRows_Write(out, "component", compRows);
+        HotspotRows_Write(out, "connection", connRows);
+        return out.good() ? Result::Success : Result::Failure;
+    }
+
+    void
+    Simulate_AdvanceTime(
+        Model const& model,
+        SimulationState& ss,
+        double t,
+        double nextTime
+    )
+    {
+        UpdateStoresPerElapsedTime(model, ss, nextTime - t);
+        UpdateScheduleBasedLoadNextEvent(model, ss, nextTime);
+        UpdateScheduleBasedSourceNextEvent(model, ss, nextTime);
+    }
+
+    // NOTE: continues a simulation whose events at time t have already been
+    // processed
+    static void
+    Simulate_Continue(
+        Model& model,
+        SimulationState& ss,
+        double t,
+        std::vector<TimeAndFlows>& timeAndFlows,
+        bool verbose,
+        bool enableSwitchLogic,
+        Log const& log,
+        ResultCapture const& capture
+    )
+    {
+        for (double nextTime = Simulate_NextEventTime(model, ss, t);
+             nextTime != infinity;
+             nextTime = Simulate_NextEventTime(model, ss, t))
+        {
+            Simulate_AdvanceTime(model, ss, t, nextTime);
             t = nextTime;
+            Simulate_ProcessEvents(
+                model,
+                ss,
+                t,
+                timeAndFlows,
+                verbose,
+                enableSwitchLogic,
+                log,
+                capture
+            );
+        }
+    }
+
+    std::vector<TimeAndFlows>
+    Simulate(
+        Model& model,
+        bool verbose,
+        bool enableSwitchLogic,
+        Log const& log,
+        ResultCapture const& capture
+    )
+    {
+        double t = 0.0;
+        std::vector<TimeAndFlows> timeAndFlows{};
+        SimulationState ss{};
+        Model_SetupSimulationState(model, ss);
+        // TODO: add units to FinalTime (append '_s')
+        if (t <= model.FinalTime)
+        {
+            Simulate_ProcessEvents(
+                model,
+                ss,
+                t,
+                timeAndFlows,
+                verbose,
+                enableSwitchLogic,
+                log,
+                capture
+            );
+            Simulate_Continue(
+                model,
+                ss,
+                t,
+                timeAndFlows,
+                verbose,
+                enableSwitchLogic,
+                log,
+                capture
+            );
+        }
+        return timeAndFlows;
+    }
+
+    std::vector<TimeAndFlows>
+    Simulate_FromSnapshot(
+        Model& model,
+        SimulationSnapshot const& snapshot,
+        std::vector<TimeAndFlows> const& baselineResults,
+        bool verbose,
+        bool enableSwitchLogic,
+        Log const& log,
+        ResultCapture const& capture
+    )
+    {
+        assert(snapshot.NumResults <= baselineResults.size());
+        if (capture.Stats != nullptr)
+        {
+            *capture.Stats = snapshot.Stats;
         }
+        std::vector<TimeAndFlows> timeAndFlows{
+            baselineResults.begin(),
+            baselineResults.begin()
+                + static_cast<std::ptrdiff_t>(snapshot.NumResults)
+        };
+        SimulationState ss = snapshot.State;
+        Simulate_Continue(
+            model,
+            ss,
+            snapshot.Time,
+            timeAndFlows,
+            verbose,
+            enableSwitchLogic,
+            log,
+            capture
+        );
         return timeAndFlows;
     }
 
+    void
+    BaselineSimulation_AdvanceTo(
+        BaselineSimulation& baseline,
+        Model& model,
+        double time_s,
+        bool enableSwitchLogic,
+        Log const& log
+    )
+    {
+        // NOTE: the baseline is simulated without any reliability schedules
+        std::vector<ScheduleBasedReliability> reliabilities =
+            std::move(model.Reliabilities);
+        model.Reliabilities.clear();
+        SimulationSnapshot& current = baseline.Current;
+        // NOTE: the statistics are kept with the snapshots as runs resumed
+        // from one only record the events after it
+        ResultCapture const capture{
+            .Projection = baseline.Projection,
+            .Stats = &current.Stats,
+        };
+        if (!baseline.IsStarted)
+        {
+            baseline.IsStarted = true;
+            Model_SetupSimulationState(model, current.State);
+            current.Time = 0.0;
+            baseline.IsFinished = current.Time > model.FinalTime;
+            if (!baseline.IsFinished)
+            {
+                Simulate_ProcessEvents(
+                    model,
+                    current.State,
+                    current.Time,
+                    baseline.Results,
+                    false,
+                    enableSwitchLogic,
+                    log,
+                    capture
+                );
+                current.NumResults = baseline.Results.size();
+                baseline.Snapshots.push_back(current);
+            }
+        }
+        while (!baseline.IsFinished)
+        {
+            double nextTime =
+                Simulate_NextEventTime(model, current.State, current.Time);
+            if (nextTime == infinity)
+            {
+                baseline.IsFinished = true;
+                break;
+            }
+            if (time_s != infinity && nextTime >= time_s)
+            {
+                break;
+            }
+            Simulate_AdvanceTime(model, current.State, current.Time, nextTime);
+            current.Time = nextTime;
+            Simulate_ProcessEvents(
+                model,
+                current.State,
+                current.Time,
+                baseline.Results,
+                false,
+                enableSwitchLogic,
+                log,
+                capture
+            );
+            current.NumResults = baseline.Results.size();
+            if (baseline.SnapshotInterval_s > 0.0
+                && current.Time - baseline.Snapshots.back().Time
+                    >= baseline.SnapshotInterval_s)
+            {
+                baseline.Snapshots.push_back(current);
+            }
+        }
+        model.Reliabilities = std::move(reliabilities);
+    }
+
+    SimulationSnapshot const*
+    BaselineSimulation_FindSnapshot(
+        BaselineSimulation const& baseline,
+        double time_s
+    )
+    {
+        if (baseline.Snapshots.empty())
+        {
+            return nullptr;
+        }
+        SimulationSnapshot const* found = nullptr;
+        for (SimulationSnapshot const& snapshot : baseline.Snapshots)
+        {
+            if (time_s != infinity && snapshot.Time >= time_s)
+            {
+                break;
+            }
+            found = &snapshot;
+        }
+        if ((time_s == infinity || baseline.Current.Time < time_s)
+            && (found == nullptr || baseline.Current.Time > found->Time))
+        {
+            return &baseline.Current;
+        }
+        return found;
+    }
+
     void
     Model_SetComponentToRepaired(
         Model const& m,
@@ -3834,8 +4798,9 @@ namespace erin
             {
                 auto const inflowConn = m.ConstLoads[idx].InflowConn;
                 auto const loadIdx = ss.ScheduleBasedLoadIdx[idx];
-                auto const amount =
-                    m.ScheduledLoads[idx].TimesAndLoads[loadIdx].Amount_W;
+                auto const amount = AmountSchedule_AmountAt(
+                    m.ScheduledLoads[idx].TimesAndLoads, loadIdx
+                );
                 if (ss.Flows[inflowConn].Requested_W != amount)
                 {
                     ss.ActiveConnectionsBack.insert(inflowConn);
@@ -3860,8 +4825,9 @@ namespace erin
                 // to the right amount as well.
                 auto const outflowConn = m.ScheduledSrcs[idx].OutflowConn;
                 auto const availIdx = ss.ScheduleBasedSourceIdx[idx];
-                auto const available =
-                    m.ScheduledSrcs[idx].TimeAndAvails[availIdx].Amount_W;
+                auto const available = AmountSchedule_AmountAt(
+                    m.ScheduledSrcs[idx].TimeAndAvails, availIdx
+                );
                 if (ss.Flows[outflowConn].Available_W != available)
                 {
                     ss.ActiveConnectionsFront.insert(outflowConn);
@@ -4298,7 +5264,7 @@ namespace erin
     {
         size_t idx = m.ScheduledLoads.size();
         ScheduleBasedLoad sbl = {};
-        sbl.TimesAndLoads = timesAndLoads;
+        sbl.TimesAndLoads = AmountSchedule_Make(timesAndLoads);
         sbl.InflowConn = 0;
         sbl.ScenarioIdToLoadId = scenarioIdToLoadId;
         m.ScheduledLoads.push_back(std::move(sbl));
@@ -4362,7 +5328,7 @@ namespace erin
     {
         auto idx = m.ScheduledSrcs.size();
         ScheduleBasedSource sbs = {};
-        sbs.TimeAndAvails = xs;
+        sbs.TimeAndAvails = AmountSchedule_Make(xs);
         sbs.ScenarioIdToSourceId = scenarioIdToSourceId;
         m.ScheduledSrcs.push_back(sbs);
         size_t wasteId = Component_AddComponentReturningId(
@@ -4620,6 +5586,10 @@ namespace erin
         vec.OutflowsForEfficiency_W = std::move(outflowsForEfficiency_W);
         vec.InflowsForEfficiency_W = std::move(inflowsForEfficiency_W);
         vec.Efficiencies = std::move(efficiencyByOutflow);
+        vec.EfficiencyByOutflow =
+            LookupTable_Make(vec.OutflowsForEfficiency_W, vec.Efficiencies);
+        vec.EfficiencyByInflow =
+            LookupTable_Make(vec.InflowsForEfficiency_W, vec.Efficiencies);
 
         m.VarEffConvs.push_back(std::move(vec));
         size_t wasteId = Component_AddComponentReturningId(
@@ -5161,46 +6131,35 @@ namespace erin
         return {};
     }
 
-    ScenarioOccurrenceStats
-    ModelResults_CalculateScenarioOccurrenceStats(
-        size_t scenarioId,
-        size_t occurrenceNumber,
+    void
+    OccurrenceStatsAccumulator_Add(
+        OccurrenceStatsAccumulator& acc,
         Model const& m,
-        FlowDict const& flowDict,
-        std::vector<TimeAndFlows> const& timeAndFlows
+        double time_s,
+        std::vector<Flow> const& flows,
+        std::vector<flow_t> const& storageAmounts_J
     )
     {
-        ScenarioOccurrenceStats sos{};
-        sos.Id = scenarioId;
-        sos.OccurrenceNumber = occurrenceNumber;
-        double initialStorage_kJ = 0.0;
-        double finalStorage_kJ = 0.0;
-        if (timeAndFlows.size() > 0)
+        ScenarioOccurrenceStats& sos = acc.Stats;
+        if (acc.NumEvents == 0)
         {
-            for (flow_t const& stored_J : timeAndFlows[0].StorageAmounts_J)
+            for (flow_t const& stored_J : storageAmounts_J)
             {
-                initialStorage_kJ += static_cast<double>(stored_J) / J_per_kJ;
+                acc.InitialStorage_kJ +=
+                    static_cast<double>(stored_J) / J_per_kJ;
             }
         }
-        double lastTime = timeAndFlows.size() > 0 ? timeAndFlows[0].Time : 0.0;
-        bool wasDown = false;
-        double sedt_s = 0.0;
-        size_t numTimeAndFlows = timeAndFlows.size();
-        size_t lastEventIdx = numTimeAndFlows - 1;
-        for (size_t eventIdx = 1; eventIdx < numTimeAndFlows; ++eventIdx)
+        else
         {
-            double dt_s = timeAndFlows[eventIdx].Time - lastTime;
+            double dt_s = time_s - acc.LastTime_s;
             assert(dt_s > 0.0);
-            lastTime = timeAndFlows[eventIdx].Time;
             // TODO: in Simulation, ensure we ALWAYS have an event at final time
             // in order that scenario duration equals what we have here; this
             // is a good check.
             sos.Duration_s += dt_s;
             bool allLoadsMet = true;
             std::map<size_t, bool> allLoadsMetByFlowType;
-            size_t prevEventIdx = eventIdx - 1;
-            for (size_t connId = 0;
-                 connId < timeAndFlows[prevEventIdx].Flows.size();
+            for (size_t connId = 0; connId < acc.PreviousFlows.size();
                  ++connId)
             {
                 size_t flowTypeId = m.Connections[connId].FlowTypeId;
@@ -5208,7 +6167,7 @@ namespace erin
                     m.ComponentMap.CompType[m.Connections[connId].FromId];
                 ComponentType toType =
                     m.ComponentMap.CompType[m.Connections[connId].ToId];
-                Flow const& flow = timeAndFlows[prevEventIdx].Flows[connId];
+                Flow const& flow = acc.PreviousFlows[connId];
                 double actualFlow_W = static_cast<double>(flow.Actual_W);
                 double requestedFlow_W = static_cast<double>(flow.Requested_W);
                 switch (fromType)
@@ -5383,36 +6342,34 @@ namespace erin
             if (allLoadsMet)
             {
                 sos.Uptime_s += dt_s;
-                if (wasDown && sedt_s > sos.MaxSEDT_s)
+                if (acc.WasDown && acc.Sedt_s > sos.MaxSEDT_s)
                 {
-                    sos.MaxSEDT_s = sedt_s;
+                    sos.MaxSEDT_s = acc.Sedt_s;
                 }
-                sedt_s = 0.0;
-                wasDown = false;
+                acc.Sedt_s = 0.0;
+                acc.WasDown = false;
             }
             else
             {
                 sos.Downtime_s += dt_s;
-                if (wasDown)
+                if (acc.WasDown)
                 {
-                    sedt_s += dt_s;
+                    acc.Sedt_s += dt_s;
                 }
                 else
                 {
-                    sedt_s = dt_s;
+                    acc.Sedt_s = dt_s;
                 }
-                wasDown = true;
+                acc.WasDown = true;
             }
-            for (size_t storeIdx = 0;
-                 storeIdx < timeAndFlows[eventIdx].StorageAmounts_J.size();
+            for (size_t storeIdx = 0; storeIdx < storageAmounts_J.size();
                  ++storeIdx)
             {
                 double prevStored_J = static_cast<double>(
-                    timeAndFlows[prevEventIdx].StorageAmounts_J[storeIdx]
-                );
-                double currentStored_J = static_cast<double>(
-                    timeAndFlows[eventIdx].StorageAmounts_J[storeIdx]
+                    acc.PreviousStorageAmounts_J[storeIdx]
                 );
+                double currentStored_J =
+                    static_cast<double>(storageAmounts_J[storeIdx]);
                 double increaseInStorage_J = currentStored_J - prevStored_J;
                 if (increaseInStorage_J > 0.0)
                 {
@@ -5423,19 +6380,39 @@ namespace erin
                     sos.StorageDischarge_kJ +=
                         -1.0 * (increaseInStorage_J / J_per_kJ);
                 }
-                if (eventIdx == lastEventIdx)
-                {
-                    double amount_J = static_cast<double>(
-                        timeAndFlows[eventIdx].StorageAmounts_J[storeIdx]
-                    );
-                    finalStorage_kJ += amount_J / J_per_kJ;
-                }
             }
         }
-        sos.ChangeInStorage_kJ = finalStorage_kJ - initialStorage_kJ;
-        if (sedt_s > sos.MaxSEDT_s)
+        acc.LastTime_s = time_s;
+        acc.PreviousFlows = flows;
+        acc.PreviousStorageAmounts_J = storageAmounts_J;
+        ++acc.NumEvents;
+    }
+
+    ScenarioOccurrenceStats
+    OccurrenceStatsAccumulator_Finish(
+        OccurrenceStatsAccumulator const& acc,
+        size_t scenarioId,
+        size_t occurrenceNumber,
+        Model const& m,
+        FlowDict const& flowDict
+    )
+    {
+        ScenarioOccurrenceStats sos = acc.Stats;
+        sos.Id = scenarioId;
+        sos.OccurrenceNumber = occurrenceNumber;
+        double finalStorage_kJ = 0.0;
+        // NOTE: a single event has no change in storage to report
+        if (acc.NumEvents > 1)
+        {
+            for (flow_t const& stored_J : acc.PreviousStorageAmounts_J)
+            {
+                finalStorage_kJ += static_cast<double>(stored_J) / J_per_kJ;
+            }
+        }
+        sos.ChangeInStorage_kJ = finalStorage_kJ - acc.InitialStorage_kJ;
+        if (acc.Sedt_s > sos.MaxSEDT_s)
         {
-            sos.MaxSEDT_s = sedt_s;
+            sos.MaxSEDT_s = acc.Sedt_s;
         }
         // calculate availability using reliability schedules
         std::vector<TimeState> relSch;
@@ -5595,6 +6572,27 @@ namespace erin
         return sos;
     }
 
+    ScenarioOccurrenceStats
+    ModelResults_CalculateScenarioOccurrenceStats(
+        size_t scenarioId,
+        size_t occurrenceNumber,
+        Model const& m,
+        FlowDict const& flowDict,
+        std::vector<TimeAndFlows> const& timeAndFlows
+    )
+    {
+        OccurrenceStatsAccumulator acc{};
+        for (TimeAndFlows const& taf : timeAndFlows)
+        {
+            OccurrenceStatsAccumulator_Add(
+                acc, m, taf.Time, taf.Flows, taf.StorageAmounts_J
+            );
+        }
+        return OccurrenceStatsAccumulator_Finish(
+            acc, scenarioId, occurrenceNumber, m, flowDict
+        );
+    }
+
     std::optional<TagAndPort>
     ParseTagAndPort(std::string const& s, std::string const& tableName)
     {
@@ -6027,40 +7025,23 @@ namespace erin
 
     double
     TabularFragilityCurve_GetFailureFraction(
-        TabularFragilityCurve tfc,
+        TabularFragilityCurve const& tfc,
         double intensityLevel
     )
     {
         size_t size = tfc.Intensities.size();
         assert(size == tfc.FailureFractions.size());
         assert(size > 0);
-        if (intensityLevel <= tfc.Intensities[0])
-        {
-            return tfc.FailureFractions[0];
-        }
-        if (intensityLevel >= tfc.Intensities[size - 1])
+        if (tfc.FailureFractionByIntensity.Xs.size() == size)
         {
-            return tfc.FailureFractions[size - 1];
-        }
-        for (size_t i = 0; i < size; ++i)
-        {
-            if (intensityLevel == tfc.Intensities[i])
-            {
-                return tfc.FailureFractions[i];
-            }
-            if ((i + 1) < size && intensityLevel > tfc.Intensities[i]
-                && intensityLevel <= tfc.Intensities[i + 1])
-            {
-                return Interpolate1d(
-                    intensityLevel,
-                    tfc.Intensities[i],
-                    tfc.FailureFractions[i],
-                    tfc.Intensities[i + 1],
-                    tfc.FailureFractions[i + 1]
-                );
-            }
+            return LookupTable_InterpBySlope(
+                tfc.FailureFractionByIntensity, intensityLevel
+            );
         }
-        return 0.0;
+        return LookupTable_InterpBySlope(
+            LookupTable_Make(tfc.Intensities, tfc.FailureFractions),
+            intensityLevel
+        );
     }
 
     void
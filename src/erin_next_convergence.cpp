@@ -0,0 +1,160 @@
+/* Copyright (c) 2024 Big Ladder Software LLC. All rights reserved.
+ * See the LICENSE.txt file for additional terms and conditions. */
+#include "erin_next/erin_next_convergence.h"
+#include <cassert>
+#include <cmath>
+
+namespace erin
+{
+    std::optional<ConvergenceMetric>
+    TagToConvergenceMetric(std::string const& tag)
+    {
+        if (tag == "energy_availability")
+        {
+            return ConvergenceMetric::EnergyAvailability;
+        }
+        if (tag == "energy_robustness")
+        {
+            return ConvergenceMetric::EnergyRobustness;
+        }
+        if (tag == "load_not_served")
+        {
+            return ConvergenceMetric::LoadNotServed;
+        }
+        if (tag == "max_single_event_downtime")
+        {
+            return ConvergenceMetric::MaxSingleEventDowntime;
+        }
+        if (tag == "global_availability")
+        {
+            return ConvergenceMetric::GlobalAvailability;
+        }
+        return {};
+    }
+
+    std::string
+    ConvergenceMetricToTag(ConvergenceMetric metric)
+    {
+        switch (metric)
+        {
+            case ConvergenceMetric::EnergyAvailability:
+            {
+                return "energy_availability";
+            }
+            case ConvergenceMetric::EnergyRobustness:
+            {
+                return "energy_robustness";
+            }
+            case ConvergenceMetric::LoadNotServed:
+            {
+                return "load_not_served";
+            }
+            case ConvergenceMetric::MaxSingleEventDowntime:
+            {
+                return "max_single_event_downtime";
+            }
+            case ConvergenceMetric::GlobalAvailability:
+            {
+                return "global_availability";
+            }
+        }
+        return "";
+    }
+
+    void
+    StreamingStats_Add(StreamingStats& ss, double value)
+    {
+        ++ss.Count;
+        double delta = value - ss.Mean;
+        ss.Mean += delta / static_cast<double>(ss.Count);
+        ss.SumOfSquares += delta * (value - ss.Mean);
+    }
+
+    double
+    StreamingStats_Variance(StreamingStats const& ss)
+    {
+        if (ss.Count < 2)
+        {
+            return 0.0;
+        }
+        return ss.SumOfSquares / static_cast<double>(ss.Count - 1);
+    }
+
+    double
+    StreamingStats_HalfWidth(StreamingStats const& ss, double zScore)
+    {
+        if (ss.Count == 0)
+        {
+            return 0.0;
+        }
+        return zScore
+            * std::sqrt(
+                   StreamingStats_Variance(ss) / static_cast<double>(ss.Count)
+            );
+    }
+
+    bool
+    StreamingStats_IsConverged(
+        StreamingStats const& ss,
+        double zScore,
+        double relativeTolerance
+    )
+    {
+        return ss.Count >= 2
+            && StreamingStats_HalfWidth(ss, zScore)
+            <= relativeTolerance * std::abs(ss.Mean);
+    }
+
+    double
+    ConfidenceLevelToZScore(double confidenceLevel)
+    {
+        assert(confidenceLevel > 0.0 && confidenceLevel < 1.0);
+        // NOTE: inverse of the standard normal CDF at p by P. J. Acklam's
+        // rational approximation (relative error below 1.2e-9)
+        double p = 0.5 + (confidenceLevel / 2.0);
+        constexpr double a[] = {
+            -3.969683028665376e+01,
+            2.209460984245205e+02,
+            -2.759285104469687e+02,
+            1.383577518672690e+02,
+            -3.066479806614716e+01,
+            2.506628277459239e+00,
+        };
+        constexpr double b[] = {
+            -5.447609879822406e+01,
+            1.615858368580409e+02,
+            -1.556989798598866e+02,
+            6.680131188771972e+01,
+            -1.328068155288572e+01,
+        };
+        constexpr double c[] = {
+            -7.784894002430293e-03,
+            -3.223964580411365e-01,
+            -2.400758277161838e+00,
+            -2.549732539343734e+00,
+            4.374664141464968e+00,
+            2.938163982698783e+00,
+        };
+        constexpr double d[] = {
+            7.784695709041462e-03,
+            3.224671290700398e-01,
+            2.445134137142996e+00,
+            3.754408661907416e+00,
+        };
+        constexpr double pHigh = 1.0 - 0.02425;
+        if (p <= pHigh)
+        {
+            double q = p - 0.5;
+            double r = q * q;
+            return (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r
+                    + a[5])
+                * q
+                / (((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r + b[4]) * r
+                   + 1.0);
+        }
+        double q = std::sqrt(-2.0 * std::log(1.0 - p));
+        return -(((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q
+                 + c[5])
+            / ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1.0);
+    }
+} // namespace erin
@@ -377,6 +377,7 @@ namespace erin
         }
         dist.tag.emplace_back(tag);
         dist.subtype_id.emplace_back(subtype_id);
+        quantile_table_dist.tables.emplace_back(LookupTable_Make(xs, dtimes_s));
         dist.dist_type.emplace_back(DistType::QuantileTable);
         return id;
     }
@@ -517,46 +518,21 @@ namespace erin
             break;
             case DistType::QuantileTable:
             {
-                const auto& start_idx =
-                    quantile_table_dist.start_idx[subtype_id];
-                const auto& end_idx = quantile_table_dist.end_idx[subtype_id];
+                // NOTE: variates run from 0 to 1 so the table covers the
+                // whole domain; fractions below 0 give 0
                 if (fraction >= 1.0)
                 {
+                    const auto& end_idx =
+                        quantile_table_dist.end_idx[subtype_id];
                     dt = static_cast<double>(
                         std::round(quantile_table_dist.times[end_idx])
                     );
                 }
-                else
+                else if (fraction >= 0.0)
                 {
-                    for (size_t idx{start_idx}; idx < end_idx; ++idx)
-                    {
-                        const auto& v0 = quantile_table_dist.variates[idx];
-                        const auto& v1 = quantile_table_dist.variates[idx + 1];
-                        if ((fraction >= v0) && (fraction < v1))
-                        {
-                            if (fraction == v0)
-                            {
-                                dt = static_cast<double>(
-                                    std::round(quantile_table_dist.times[idx])
-                                );
-                                break;
-                            }
-                            else
-                            {
-                                const auto df{fraction - v0};
-                                const auto dv{v1 - v0};
-                                const auto time0{quantile_table_dist.times[idx]
-                                };
-                                const auto time1{
-                                    quantile_table_dist.times[idx + 1]
-                                };
-                                const auto dtimes{time1 - time0};
-                                dt = static_cast<double>(
-                                    std::round(time0 + (df / dv) * dtimes)
-                                );
-                            }
-                        }
-                    }
+                    dt = std::round(LookupTable_Interp(
+                        quantile_table_dist.tables[subtype_id], fraction
+                    ));
                 }
             }
             break;
@@ -585,6 +561,159 @@ namespace erin
         return dt;
     }
 
+    void
+    DistributionSystem::sample_n(
+        size_t dist_id,
+        std::span<double const> u,
+        std::span<double> out
+    ) const
+    {
+        if (dist_id >= dist.tag.size())
+        {
+            std::ostringstream oss{};
+            oss << "dist_id '" << dist_id << "' is out of range\n"
+                << "- id     : " << dist_id << "\n"
+                << "- max(id): " << (dist.tag.size() - 1) << "\n";
+            throw std::out_of_range(oss.str());
+        }
+        if (u.size() != out.size())
+        {
+            throw std::invalid_argument(
+                "sample_n: fractions and output must be the same size"
+            );
+        }
+        size_t const n = u.size();
+        size_t const subtype_id = dist.subtype_id[dist_id];
+        // NOTE: each case hoists the parameters out of the loop and keeps
+        // the per-element arithmetic identical to next_time_advance so that
+        // batched and scalar sampling give bit-identical results.
+        switch (dist.dist_type[dist_id])
+        {
+            case DistType::Fixed:
+            {
+                double const value = fixed_dist.value[subtype_id];
+                std::fill(out.begin(), out.end(), value);
+            }
+            break;
+            case DistType::Uniform:
+            {
+                double const lb = uniform_dist.lower_bound[subtype_id];
+                double const ub = uniform_dist.upper_bound[subtype_id];
+                double const delta = ub - lb;
+                double const offset =
+                    static_cast<double>(static_cast<flow_t>(lb));
+                for (size_t i = 0; i < n; ++i)
+                {
+                    out[i] = u[i] * delta + offset;
+                }
+            }
+            break;
+            case DistType::Normal:
+            {
+                constexpr double sqrt2{1.4142'1356'2373'0951};
+                constexpr double twice{2.0};
+                double const avg = normal_dist.average[subtype_id];
+                double const sd_sqrt2 = normal_dist.stddev[subtype_id] * sqrt2;
+                for (size_t i = 0; i < n; ++i)
+                {
+                    out[i] = std::round(
+                        avg + sd_sqrt2 * erfinv(twice * u[i] - 1.0)
+                    );
+                }
+            }
+            break;
+            case DistType::QuantileTable:
+            {
+                size_t const end_idx = quantile_table_dist.end_idx[subtype_id];
+                double const t_last =
+                    std::round(quantile_table_dist.times[end_idx]);
+                LookupTable const& table =
+                    quantile_table_dist.tables[subtype_id];
+                for (size_t i = 0; i < n; ++i)
+                {
+                    double const fraction = u[i];
+                    if (fraction >= 1.0)
+                    {
+                        out[i] = t_last;
+                    }
+                    else if (fraction >= 0.0)
+                    {
+                        out[i] =
+                            std::round(LookupTable_Interp(table, fraction));
+                    }
+                    else
+                    {
+                        out[i] = 0.0;
+                    }
+                }
+            }
+            break;
+            case DistType::Weibull:
+            {
+                double const k = weibull_dist.shape_params[subtype_id];
+                double const a = weibull_dist.scale_params[subtype_id];
+                double const b = weibull_dist.location_params[subtype_id];
+                for (size_t i = 0; i < n; ++i)
+                {
+                    out[i] = std::round(weibull_quantile(u[i], k, a, b));
+                }
+            }
+            break;
+            default:
+            {
+                WriteErrorMessage(
+                    "distribution", "unhandled cumulative density function"
+                );
+                std::exit(1);
+            }
+        }
+        for (size_t i = 0; i < n; ++i)
+        {
+            out[i] = out[i] < 0.0 ? 0.0 : out[i];
+        }
+    }
+
+    size_t
+    DistributionSystem::sample_n(
+        size_t dist_id,
+        std::span<double> out,
+        double max_fraction
+    )
+    {
+        size_t n = 0;
+        while (n < out.size())
+        {
+            double fraction = roll(g);
+            out[n++] = fraction;
+            if (fraction > max_fraction)
+            {
+                break;
+            }
+        }
+        std::span<double> drawn = out.first(n);
+        sample_n(dist_id, drawn, drawn);
+        return n;
+    }
+
+    double
+    DistributionSystem::max_time_advance(
+        size_t dist_id,
+        double max_fraction
+    ) const
+    {
+        // NOTE: every quantile function is non-decreasing on [0, 1).
+        if (max_fraction < 1.0)
+        {
+            return next_time_advance(dist_id, max_fraction);
+        }
+        // NOTE: Weibull caps fractions >= 1 at a lower quantile, so the
+        // largest fraction below 1 is checked as well.
+        return std::max(
+            next_time_advance(dist_id, 1.0),
+            next_time_advance(dist_id, std::nextafter(1.0, 0.0))
+        );
+    }
+
     void
     DistributionSystem::print_distributions() const
     {
@@ -1,4 +1,8 @@
 #include "erin_next/erin_next_lookup_table.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
 
 namespace erin
 {
@@ -66,4 +70,228 @@ namespace erin
         }
         return ys[maxIdx];
     }
+
+    LookupTable
+    LookupTable_Make(std::vector<double> xs, std::vector<double> ys)
+    {
+        assert(xs.size() == ys.size());
+        LookupTable table{};
+        if (xs.empty())
+        {
+            return table;
+        }
+        size_t numSegments = xs.size() - 1;
+        table.Dxs.reserve(numSegments);
+        table.Dys.reserve(numSegments);
+        table.Slopes.reserve(numSegments);
+        bool isIncreasing = numSegments > 0;
+        for (size_t i = 0; i < numSegments; ++i)
+        {
+            double dx = xs[i + 1] - xs[i];
+            double dy = ys[i + 1] - ys[i];
+            table.Dxs.push_back(dx);
+            table.Dys.push_back(dy);
+            table.Slopes.push_back(dy / dx);
+            if (!(xs[i] < xs[i + 1]))
+            {
+                isIncreasing = false;
+            }
+        }
+        table.Xs = std::move(xs);
+        table.Ys = std::move(ys);
+        if (!isIncreasing)
+        {
+            table.Method = LookupMethod::Scan;
+            return table;
+        }
+        constexpr double relativeTolerance = 1e-9;
+        constexpr size_t maxCursorEntries = 16;
+        double step = table.Dxs[0];
+        bool isUniform = true;
+        for (double dx : table.Dxs)
+        {
+            if (std::abs(dx - step) > relativeTolerance * step)
+            {
+                isUniform = false;
+                break;
+            }
+        }
+        if (isUniform)
+        {
+            table.Method = LookupMethod::UniformGrid;
+            table.InverseStep = 1.0 / step;
+        }
+        else if (table.Xs.size() > maxCursorEntries)
+        {
+            table.Method = LookupMethod::Binary;
+        }
+        else
+        {
+            table.Method = LookupMethod::Cursor;
+        }
+        return table;
+    }
+
+    // NOTE: requires a strictly increasing table and
+    // Xs[0] < x < Xs[Xs.size() - 1]. Returns i such that
+    // Xs[i] <= x < Xs[i + 1] or, if rightClosed, Xs[i] < x <= Xs[i + 1].
+    static size_t
+    LookupTable_FindSegment(
+        LookupTable const& table,
+        double x,
+        bool rightClosed,
+        size_t cursor
+    )
+    {
+        std::vector<double> const& xs = table.Xs;
+        size_t maxSegment = xs.size() - 2;
+        size_t i = 0;
+        switch (table.Method)
+        {
+            case LookupMethod::Binary:
+            {
+                auto it = rightClosed
+                    ? std::lower_bound(xs.begin(), xs.end(), x)
+                    : std::upper_bound(xs.begin(), xs.end(), x);
+                return static_cast<size_t>(it - xs.begin()) - 1;
+            }
+            case LookupMethod::UniformGrid:
+            {
+                double guess = (x - xs[0]) * table.InverseStep;
+                i = guess < static_cast<double>(maxSegment)
+                    ? static_cast<size_t>(guess)
+                    : maxSegment;
+            }
+            break;
+            case LookupMethod::Cursor:
+            {
+                i = cursor < maxSegment ? cursor : maxSegment;
+            }
+            break;
+            case LookupMethod::Scan:
+            {
+                assert(false && "scan tables have no ordered segments");
+            }
+            break;
+        }
+        // NOTE: the guess is at most a segment or two away for uniform
+        // grids; walk to the bracketing segment.
+        if (rightClosed)
+        {
+            while (i > 0 && xs[i] >= x)
+            {
+                --i;
+            }
+            while (i < maxSegment && xs[i + 1] < x)
+            {
+                ++i;
+            }
+        }
+        else
+        {
+            while (i > 0 && xs[i] > x)
+            {
+                --i;
+            }
+            while (i < maxSegment && xs[i + 1] <= x)
+            {
+                ++i;
+            }
+        }
+        return i;
+    }
+
+    double
+    LookupTable_StairStep(LookupTable const& table, double x, size_t& cursor)
+    {
+        if (table.Method == LookupMethod::Scan)
+        {
+            return LookupTable_LookupStairStep(table.Xs, table.Ys, x);
+        }
+        size_t maxIdx = table.Xs.size() - 1;
+        if (x <= table.Xs[0])
+        {
+            return table.Ys[0];
+        }
+        if (!(x < table.Xs[maxIdx]))
+        {
+            return table.Ys[maxIdx];
+        }
+        cursor = LookupTable_FindSegment(table, x, false, cursor);
+        return table.Ys[cursor];
+    }
+
+    double
+    LookupTable_StairStep(LookupTable const& table, double x)
+    {
+        size_t cursor = 0;
+        return LookupTable_StairStep(table, x, cursor);
+    }
+
+    double
+    LookupTable_Interp(LookupTable const& table, double x, size_t& cursor)
+    {
+        if (table.Method == LookupMethod::Scan)
+        {
+            return LookupTable_LookupInterp(table.Xs, table.Ys, x);
+        }
+        size_t maxIdx = table.Xs.size() - 1;
+        if (x <= table.Xs[0])
+        {
+            return table.Ys[0];
+        }
+        if (!(x < table.Xs[maxIdx]))
+        {
+            return table.Ys[maxIdx];
+        }
+        size_t i = LookupTable_FindSegment(table, x, false, cursor);
+        cursor = i;
+        double x_delta = x - table.Xs[i];
+        double y_delta = (x_delta / table.Dxs[i]) * table.Dys[i];
+        return table.Ys[i] + y_delta;
+    }
+
+    double
+    LookupTable_Interp(LookupTable const& table, double x)
+    {
+        size_t cursor = 0;
+        return LookupTable_Interp(table, x, cursor);
+    }
+
+    double
+    LookupTable_InterpBySlope(LookupTable const& table, double x)
+    {
+        std::vector<double> const& xs = table.Xs;
+        std::vector<double> const& ys = table.Ys;
+        size_t size = xs.size();
+        if (x <= xs[0])
+        {
+            return ys[0];
+        }
+        if (x >= xs[size - 1])
+        {
+            return ys[size - 1];
+        }
+        if (table.Method == LookupMethod::Scan)
+        {
+            for (size_t i = 0; i < size; ++i)
+            {
+                if (x == xs[i])
+                {
+                    return ys[i];
+                }
+                if ((i + 1) < size && x > xs[i] && x <= xs[i + 1])
+                {
+                    return ys[i] + ((x - xs[i]) * table.Slopes[i]);
+                }
+            }
+            return 0.0;
+        }
+        if (std::isnan(x))
+        {
+            return 0.0;
+        }
+        size_t i = LookupTable_FindSegment(table, x, true, 0);
+        return ys[i] + ((x - xs[i]) * table.Slopes[i]);
+    }
 }
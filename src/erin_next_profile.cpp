@@ -0,0 +1,360 @@
+/* Copyright (c) 2024 Big Ladder Software LLC. All rights reserved.
+ * See the LICENSE.txt file for additional terms and conditions. */
+#include "erin_next/erin_next_profile.h"
+#include <fmt/core.h>
+#include <fstream>
+#include <iostream>
+
+namespace erin
+{
+    Profile TheProfile{};
+
+    void
+    Profile_Enable()
+    {
+        TheProfile = Profile{};
+        TheProfile.Enabled = true;
+    }
+
+    void
+    Profile_Disable()
+    {
+        TheProfile = Profile{};
+    }
+
+    Hotspots TheHotspots{};
+
+    void
+    Hotspots_Enable()
+    {
+        TheHotspots = Hotspots{};
+        TheHotspots.Enabled = true;
+    }
+
+    void
+    Hotspots_Disable()
+    {
+        TheHotspots = Hotspots{};
+    }
+
+    void
+    HotspotPasses_RecordRun(
+        HotspotPasses& passes,
+        size_t connIdx,
+        uint64_t value
+    )
+    {
+        if (connIdx >= passes.Runs.size())
+        {
+            size_t n = connIdx + 1;
+            passes.Runs.resize(n, 0);
+            passes.Reactivations.resize(n, 0);
+            passes.MaxRunsPerEvent.resize(n, 0);
+            passes.Oscillations.resize(n, 0);
+            passes.EventRuns.resize(n, 0);
+            passes.LastValue.resize(n, 0);
+            passes.LastChange.resize(n, 0);
+        }
+        ++passes.Runs[connIdx];
+        if (passes.EventRuns[connIdx] == 0)
+        {
+            passes.Touched.push_back(connIdx);
+            passes.LastChange[connIdx] = 0;
+        }
+        else if (value != passes.LastValue[connIdx])
+        {
+            int8_t change = value > passes.LastValue[connIdx] ? 1 : -1;
+            if (passes.LastChange[connIdx] != 0
+                && passes.LastChange[connIdx] != change)
+            {
+                ++passes.Oscillations[connIdx];
+            }
+            passes.LastChange[connIdx] = change;
+        }
+        passes.LastValue[connIdx] = value;
+        ++passes.EventRuns[connIdx];
+    }
+
+    void
+    Hotspots_RecordSwitchFlip(size_t compId)
+    {
+        if (!TheHotspots.Enabled)
+        {
+            return;
+        }
+        if (compId >= TheHotspots.SwitchFlips.size())
+        {
+            TheHotspots.SwitchFlips.resize(compId + 1, 0);
+        }
+        ++TheHotspots.SwitchFlips[compId];
+    }
+
+    static void
+    HotspotPasses_EndEvent(HotspotPasses& passes)
+    {
+        for (size_t connIdx : passes.Touched)
+        {
+            uint64_t runs = passes.EventRuns[connIdx];
+            passes.Reactivations[connIdx] += runs - 1;
+            if (runs > passes.MaxRunsPerEvent[connIdx])
+            {
+                passes.MaxRunsPerEvent[connIdx] = runs;
+            }
+            passes.EventRuns[connIdx] = 0;
+        }
+        passes.Touched.clear();
+    }
+
+    void
+    Hotspots_EndEvent()
+    {
+        if (!TheHotspots.Enabled)
+        {
+            return;
+        }
+        HotspotPasses_EndEvent(TheHotspots.Backward);
+        HotspotPasses_EndEvent(TheHotspots.Forward);
+    }
+
+    void
+    Profile_BeginOccurrence(
+        std::string const& scenarioTag,
+        size_t occurrenceNumber
+    )
+    {
+        if (!TheProfile.Enabled)
+        {
+            return;
+        }
+        TheProfile.Occurrence = ProfileRecord{};
+        TheProfile.Occurrence.ScenarioTag = scenarioTag;
+        TheProfile.Occurrence.OccurrenceNumber = occurrenceNumber;
+        TheProfile.InOccurrence = true;
+    }
+
+    void
+    Profile_EndOccurrence()
+    {
+        if (!TheProfile.Enabled || !TheProfile.InOccurrence)
+        {
+            return;
+        }
+        TheProfile.Occurrences.push_back(std::move(TheProfile.Occurrence));
+        TheProfile.Occurrence = ProfileRecord{};
+        TheProfile.InOccurrence = false;
+    }
+
+    static void
+    ProfileRecord_Add(ProfileRecord& total, ProfileRecord const& record)
+    {
+        for (size_t i = 0; i < numProfilePhases; ++i)
+        {
+            total.PhaseTimes_s[i] += record.PhaseTimes_s[i];
+        }
+        for (size_t i = 0; i < numProfileCounters; ++i)
+        {
+            total.Counts[i] += record.Counts[i];
+        }
+    }
+
+    ProfileRecord
+    Profile_Total(Profile const& profile)
+    {
+        ProfileRecord total{};
+        ProfileRecord_Add(total, profile.Outside);
+        for (ProfileRecord const& record : profile.Occurrences)
+        {
+            ProfileRecord_Add(total, record);
+        }
+        return total;
+    }
+
+    std::string
+    ProfilePhase_ToTag(ProfilePhase phase)
+    {
+        switch (phase)
+        {
+            case ProfilePhase::ParseToml:
+            {
+                return "parse_toml";
+            }
+            case ProfilePhase::LoadIngestion:
+            {
+                return "load_ingestion";
+            }
+            case ProfilePhase::Validation:
+            {
+                return "validation";
+            }
+            case ProfilePhase::CreateFailureSchedules:
+            {
+                return "create_failure_schedules";
+            }
+            case ProfilePhase::ApplyReliabilities:
+            {
+                return "apply_reliabilities_and_fragilities";
+            }
+            case ProfilePhase::Simulate:
+            {
+                return "simulate";
+            }
+            case ProfilePhase::Resample:
+            {
+                return "resample";
+            }
+            case ProfilePhase::Aggregate:
+            {
+                return "aggregate";
+            }
+            case ProfilePhase::Stats:
+            {
+                return "stats";
+            }
+            case ProfilePhase::Write:
+            {
+                return "write";
+            }
+            case ProfilePhase::Count:
+            {
+            }
+            break;
+        }
+        return "unknown";
+    }
+
+    std::string
+    ProfileCounter_ToTag(ProfileCounter counter)
+    {
+        switch (counter)
+        {
+            case ProfileCounter::Events:
+            {
+                return "events";
+            }
+            case ProfileCounter::BackwardPasses:
+            {
+                return "backward_passes";
+            }
+            case ProfileCounter::ForwardPasses:
+            {
+                return "forward_passes";
+            }
+            case ProfileCounter::ActiveConnectionIterations:
+            {
+                return "active_connection_iterations";
+            }
+            case ProfileCounter::SwitchFlips:
+            {
+                return "switch_flips";
+            }
+            case ProfileCounter::Count:
+            {
+            }
+            break;
+        }
+        return "unknown";
+    }
+
+    static void
+    ProfileRecord_WriteJson(
+        std::ostream& out,
+        ProfileRecord const& record,
+        std::string const& indent
+    )
+    {
+        out << indent << "\"phases_s\": {";
+        for (size_t i = 0; i < numProfilePhases; ++i)
+        {
+            out << (i == 0 ? "" : ", ")
+                << fmt::format(
+                       "\"{}\": {:.6f}",
+                       ProfilePhase_ToTag(static_cast<ProfilePhase>(i)),
+                       record.PhaseTimes_s[i]
+                   );
+        }
+        out << "},\n" << indent << "\"counters\": {";
+        for (size_t i = 0; i < numProfileCounters; ++i)
+        {
+            out << (i == 0 ? "" : ", ")
+                << fmt::format(
+                       "\"{}\": {}",
+                       ProfileCounter_ToTag(static_cast<ProfileCounter>(i)),
+                       record.Counts[i]
+                   );
+        }
+        out << "}\n";
+    }
+
+    static std::string
+    EscapeJsonString(std::string const& s)
+    {
+        std::string escaped;
+        escaped.reserve(s.size());
+        for (char c : s)
+        {
+            if (c == '"' || c == '\\')
+            {
+                escaped.push_back('\\');
+            }
+            escaped.push_back(c);
+        }
+        return escaped;
+    }
+
+    Result
+    Profile_WriteJson(Profile const& profile, std::string const& filename)
+    {
+        std::ofstream out{filename};
+        if (!out.good())
+        {
+            return Result::Failure;
+        }
+        out << "{\n  \"total\": {\n";
+        ProfileRecord_WriteJson(out, Profile_Total(profile), "    ");
+        out << "  },\n  \"outside_occurrences\": {\n";
+        ProfileRecord_WriteJson(out, profile.Outside, "    ");
+        out << "  },\n  \"occurrences\": [";
+        for (size_t i = 0; i < profile.Occurrences.size(); ++i)
+        {
+            ProfileRecord const& record = profile.Occurrences[i];
+            out << (i == 0 ? "\n" : ",\n") << "    {\n"
+                << fmt::format(
+                       "      \"scenario\": \"{}\",\n",
+                       EscapeJsonString(record.ScenarioTag)
+                   )
+                << fmt::format(
+                       "      \"occurrence\": {},\n", record.OccurrenceNumber
+                   );
+            ProfileRecord_WriteJson(out, record, "      ");
+            out << "    }";
+        }
+        out << (profile.Occurrences.empty() ? "]\n" : "\n  ]\n") << "}\n";
+        return out.good() ? Result::Success : Result::Failure;
+    }
+
+    void
+    Profile_PrintCounters(Profile const& profile)
+    {
+        ProfileRecord total = Profile_Total(profile);
+        for (size_t i = 0; i < numProfileCounters; ++i)
+        {
+            std::cout << ProfileCounter_ToTag(static_cast<ProfileCounter>(i))
+                      << ": " << total.Counts[i] << std::endl;
+        }
+    }
+
+    void
+    ProfileTimer::Stop()
+    {
+        std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - Start;
+        double childTime_s = TheProfile.ChildTimes_s.back();
+        TheProfile.ChildTimes_s.pop_back();
+        Profile_CurrentRecord().PhaseTimes_s[static_cast<size_t>(Phase)] +=
+            elapsed.count() - childTime_s;
+        if (!TheProfile.ChildTimes_s.empty())
+        {
+            TheProfile.ChildTimes_s.back() += elapsed.count();
+        }
+    }
+} // namespace erin
@@ -3,6 +3,11 @@
 #include "erin_next/erin_next_random.h"
 #include <random>
 #include <chrono>
+#include <array>
+#include <cassert>
+#include <algorithm>
+#include <limits>
+#include <utility>
 
 namespace erin
 {
@@ -52,4 +57,302 @@ namespace erin
         r.Generator.seed(seed);
         return r;
     }
+
+    static uint64_t
+    SplitMix64(uint64_t x)
+    {
+        x += 0x9e3779b97f4a7c15ULL;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+
+    unsigned int
+    DeriveSeed(unsigned int seed, uint64_t streamId, uint64_t substreamId)
+    {
+        uint64_t h = SplitMix64(static_cast<uint64_t>(seed));
+        h = SplitMix64(h ^ streamId);
+        h = SplitMix64(h ^ substreamId);
+        return static_cast<unsigned int>(h >> 32);
+    }
+
+    std::optional<SamplingType>
+    TagToSamplingType(std::string const& tag)
+    {
+        if (tag == "independent")
+        {
+            return SamplingType::Independent;
+        }
+        if (tag == "antithetic")
+        {
+            return SamplingType::Antithetic;
+        }
+        if (tag == "latin_hypercube")
+        {
+            return SamplingType::LatinHypercube;
+        }
+        if (tag == "sobol")
+        {
+            return SamplingType::Sobol;
+        }
+        return {};
+    }
+
+    std::string
+    SamplingTypeToTag(SamplingType st)
+    {
+        switch (st)
+        {
+            case SamplingType::Independent:
+            {
+                return "independent";
+            }
+            case SamplingType::Antithetic:
+            {
+                return "antithetic";
+            }
+            case SamplingType::LatinHypercube:
+            {
+                return "latin_hypercube";
+            }
+            case SamplingType::Sobol:
+            {
+                return "sobol";
+            }
+        }
+        return "";
+    }
+
+    // NOTE: primitive polynomials (degree, coefficients) and initial
+    // direction numbers for Sobol dimensions 2 and up from S. Joe and
+    // F. Y. Kuo, "Constructing Sobol sequences with better two-dimensional
+    // projections" (2008). The first dimension is the van der Corput
+    // sequence.
+    struct SobolParameters
+    {
+        uint32_t Degree;
+        uint32_t Coefficients;
+        std::array<uint32_t, 7> InitialDirections;
+    };
+
+    constexpr SobolParameters sobolParameters[] = {
+        {1, 0, {1}},
+        {2, 1, {1, 3}},
+        {3, 1, {1, 3, 1}},
+        {3, 2, {1, 1, 1}},
+        {4, 1, {1, 1, 3, 3}},
+        {4, 4, {1, 3, 5, 13}},
+        {5, 2, {1, 1, 5, 5, 17}},
+        {5, 4, {1, 1, 5, 5, 5}},
+        {5, 7, {1, 1, 7, 11, 19}},
+        {5, 11, {1, 1, 5, 1, 1}},
+        {5, 13, {1, 1, 1, 3, 11}},
+        {5, 14, {1, 3, 5, 5, 31}},
+        {6, 1, {1, 3, 3, 9, 7, 49}},
+        {6, 13, {1, 1, 1, 15, 21, 21}},
+        {6, 16, {1, 3, 1, 13, 27, 49}},
+        {6, 19, {1, 1, 1, 15, 7, 5}},
+        {6, 22, {1, 3, 1, 15, 13, 25}},
+        {6, 25, {1, 1, 5, 5, 19, 61}},
+        {7, 1, {1, 3, 7, 11, 23, 15, 103}},
+        {7, 4, {1, 3, 7, 13, 13, 15, 69}},
+    };
+
+    constexpr size_t numSobolBits = 32;
+    constexpr size_t numSobolDimensions =
+        1 + (sizeof(sobolParameters) / sizeof(SobolParameters));
+
+    using SobolDirections =
+        std::array<std::array<uint32_t, numSobolBits>, numSobolDimensions>;
+
+    static SobolDirections
+    Sobol_MakeDirections()
+    {
+        SobolDirections dirs{};
+        for (size_t k = 0; k < numSobolBits; ++k)
+        {
+            dirs[0][k] = uint32_t{1} << (numSobolBits - 1 - k);
+        }
+        for (size_t dim = 1; dim < numSobolDimensions; ++dim)
+        {
+            SobolParameters const& p = sobolParameters[dim - 1];
+            std::array<uint32_t, numSobolBits>& v = dirs[dim];
+            for (size_t k = 0; k < numSobolBits; ++k)
+            {
+                if (k < p.Degree)
+                {
+                    v[k] = p.InitialDirections[k] << (numSobolBits - 1 - k);
+                    continue;
+                }
+                v[k] = v[k - p.Degree] ^ (v[k - p.Degree] >> p.Degree);
+                for (size_t i = 1; i < p.Degree; ++i)
+                {
+                    if (((p.Coefficients >> (p.Degree - 1 - i)) & 1) != 0)
+                    {
+                        v[k] ^= v[k - i];
+                    }
+                }
+            }
+        }
+        return dirs;
+    }
+
+    size_t
+    Sobol_NumDimensions()
+    {
+        return numSobolDimensions;
+    }
+
+    uint32_t
+    Sobol_Point(uint32_t index, size_t dimension)
+    {
+        assert(dimension < numSobolDimensions);
+        static SobolDirections const dirs = Sobol_MakeDirections();
+        uint32_t x = 0;
+        for (size_t k = 0; index != 0; ++k, index >>= 1)
+        {
+            if ((index & 1) != 0)
+            {
+                x ^= dirs[dimension][k];
+            }
+        }
+        return x;
+    }
+
+    double
+    SampledRandom::operator()()
+    {
+        size_t dim = Stream;
+        size_t drawIdx = StreamDrawIdx;
+        ++StreamDrawIdx;
+        switch (Type)
+        {
+            case SamplingType::Independent:
+            {
+                return Base();
+            }
+            case SamplingType::Antithetic:
+            {
+                if (PairDraws.size() <= Stream)
+                {
+                    PairDraws.resize(Stream + 1);
+                }
+                std::vector<double>& draws = PairDraws[Stream];
+                if (OccurrenceIdx % 2 == 0)
+                {
+                    double u = Base();
+                    draws.push_back(u);
+                    return u;
+                }
+                if (drawIdx < draws.size())
+                {
+                    return 1.0 - draws[drawIdx];
+                }
+                return Base();
+            }
+            case SamplingType::LatinHypercube:
+            {
+                if (OccurrenceIdx >= NumOccurrences || drawIdx > 0
+                    || dim >= numSobolDimensions)
+                {
+                    return Base();
+                }
+                while (Strata.size() <= dim)
+                {
+                    // NOTE: Fisher-Yates shuffle of the strata for a new
+                    // coordinate
+                    std::vector<size_t> perm(NumOccurrences);
+                    for (size_t i = 0; i < NumOccurrences; ++i)
+                    {
+                        perm[i] = i;
+                    }
+                    for (size_t i = NumOccurrences; i > 1; --i)
+                    {
+                        size_t j = std::min(
+                            static_cast<size_t>(
+                                Base() * static_cast<double>(i)
+                            ),
+                            i - 1
+                        );
+                        std::swap(perm[i - 1], perm[j]);
+                    }
+                    Strata.push_back(std::move(perm));
+                }
+                return (static_cast<double>(Strata[dim][OccurrenceIdx])
+                        + Base())
+                    / static_cast<double>(NumOccurrences);
+            }
+            case SamplingType::Sobol:
+            {
+                if (drawIdx > 0 || dim >= numSobolDimensions
+                    || OccurrenceIdx > std::numeric_limits<uint32_t>::max())
+                {
+                    return Base();
+                }
+                while (Shifts.size() <= dim)
+                {
+                    Shifts.push_back(static_cast<uint32_t>(
+                        Base() * 4'294'967'296.0
+                    ));
+                }
+                uint32_t x =
+                    Sobol_Point(static_cast<uint32_t>(OccurrenceIdx), dim)
+                    ^ Shifts[dim];
+                // NOTE: the center of the 2^-32 cell keeps draws in (0, 1)
+                return (static_cast<double>(x) + 0.5) / 4'294'967'296.0;
+            }
+        }
+        return Base();
+    }
+
+    void
+    SampledRandom_StartScenario(SampledRandom& sr, size_t numOccurrences)
+    {
+        sr.NumOccurrences = numOccurrences;
+        sr.OccurrenceIdx = 0;
+        sr.Stream = 0;
+        sr.StreamDrawIdx = 0;
+        sr.PairDraws.clear();
+        sr.Strata.clear();
+        sr.Shifts.clear();
+    }
+
+    void
+    SampledRandom_StartOccurrence(SampledRandom& sr, size_t occurrenceIdx)
+    {
+        sr.OccurrenceIdx = occurrenceIdx;
+        sr.Stream = 0;
+        sr.StreamDrawIdx = 0;
+        if (sr.Type == SamplingType::Antithetic && occurrenceIdx % 2 == 0)
+        {
+            sr.PairDraws.clear();
+        }
+    }
+
+    void
+    SampledRandom_StartStream(SampledRandom& sr, size_t stream)
+    {
+        sr.Stream = stream;
+        sr.StreamDrawIdx = 0;
+    }
+
+    double
+    ImportanceSampling_FailureProbability(double p, double oddsFactor)
+    {
+        if (p <= 0.0 || p >= 1.0 || oddsFactor == 1.0)
+        {
+            return p;
+        }
+        return (oddsFactor * p) / (1.0 + ((oddsFactor - 1.0) * p));
+    }
+
+    double
+    ImportanceSampling_Weight(double p, double q, bool isFailed)
+    {
+        if (isFailed)
+        {
+            return q > 0.0 ? p / q : 1.0;
+        }
+        return q < 1.0 ? (1.0 - p) / (1.0 - q) : 1.0;
+    }
 } // namespace erin
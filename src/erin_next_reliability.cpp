@@ -1,6 +1,7 @@
 /* Copyright (c) 2020-2024 Big Ladder Software LLC. All rights reserved.
  * See the LICENSE.txt file for additional terms and conditions. */
 #include "erin_next/erin_next_reliability.h"
+#include <cmath>
 #include <iostream>
 #include <utility>
 #include <stdexcept>
@@ -92,9 +93,81 @@ namespace erin
         double time = 0.0;
         double dt = -1.0;
         std::vector<TimeState> reliability_schedule;
+        auto const& fm_id = fm_comp_links.failure_mode_id.at(link_id);
+        size_t const failure_dist_id = fms.failure_dist.at(fm_id);
+        size_t const repair_dist_id = fms.repair_dist.at(fm_id);
+        // NOTE: a failure/repair cycle whose fractions are both at most
+        // max_batch_fraction advances time by at most max_cycle. While at
+        // least that many whole cycles (less one for round-off) remain
+        // before final_time, the schedule cannot finish, so fractions are
+        // drawn ahead -- in the same order as the one-at-a-time loop below
+        // -- and converted to time advances in bulk. A fraction above
+        // max_batch_fraction ends the batch; it (and the failure fraction
+        // of its cycle) is handed to the loop below instead of being
+        // redrawn, so the result is identical to the scalar loop.
+        double const max_cycle =
+            cds.max_time_advance(failure_dist_id, max_batch_fraction)
+            + cds.max_time_advance(repair_dist_id, max_batch_fraction);
+        constexpr size_t max_batch_cycles = 512;
+        std::vector<double> failure_dts;
+        std::vector<double> repair_dts;
+        std::vector<double> pending_fractions;
+        while (pending_fractions.empty() && max_cycle > 0.0
+               && std::isfinite(max_cycle))
+        {
+            double const sure_cycles =
+                std::floor((final_time - time) / max_cycle) - 1.0;
+            if (!(sure_cycles >= 1.0))
+            {
+                break;
+            }
+            size_t const num_cycles = sure_cycles
+                    >= static_cast<double>(max_batch_cycles)
+                ? max_batch_cycles
+                : static_cast<size_t>(sure_cycles);
+            failure_dts.clear();
+            repair_dts.clear();
+            for (size_t i = 0; i < num_cycles; ++i)
+            {
+                double const failure_fraction = rand_fn();
+                if (failure_fraction > max_batch_fraction)
+                {
+                    pending_fractions.push_back(failure_fraction);
+                    break;
+                }
+                double const repair_fraction = rand_fn();
+                if (repair_fraction > max_batch_fraction)
+                {
+                    pending_fractions.push_back(failure_fraction);
+                    pending_fractions.push_back(repair_fraction);
+                    break;
+                }
+                failure_dts.push_back(failure_fraction);
+                repair_dts.push_back(repair_fraction);
+            }
+            cds.sample_n(failure_dist_id, failure_dts, failure_dts);
+            cds.sample_n(repair_dist_id, repair_dts, repair_dts);
+            reliability_schedule.reserve(
+                reliability_schedule.size() + 2 * failure_dts.size()
+            );
+            for (size_t i = 0; i < failure_dts.size(); ++i)
+            {
+                time += failure_dts[i];
+                reliability_schedule.push_back(TimeState{time, false, {}, {}});
+                time += repair_dts[i];
+                reliability_schedule.push_back(TimeState{time, true, {}, {}});
+            }
+        }
+        size_t next_pending = 0;
+        std::function<double()> const next_fraction = [&]()
+        {
+            return next_pending < pending_fractions.size()
+                ? pending_fractions[next_pending++]
+                : rand_fn();
+        };
         while (true)
         {
-            dt = calc_next_event(link_id, dt, rand_fn, cds, true);
+            dt = calc_next_event(link_id, dt, next_fraction, cds, true);
             bool gteq_final_time = update_single_schedule(
                 time, dt, reliability_schedule, final_time, false
             );
@@ -102,7 +175,7 @@ namespace erin
             {
                 break;
             }
-            dt = calc_next_event(link_id, dt, rand_fn, cds, false);
+            dt = calc_next_event(link_id, dt, next_fraction, cds, false);
             gteq_final_time = update_single_schedule(
                 time, dt, reliability_schedule, final_time, true
             );
@@ -4,10 +4,12 @@
 #include "erin/logging.h"
 #include "erin_next/erin_next.h"
 #include "erin_next/erin_next_component.h"
+#include "erin_next/erin_next_profile.h"
 #include "erin_next/erin_next_timestate.h"
 #include "erin_next/erin_next_units.h"
 #include "erin_next/erin_next_utils.h"
 #include "erin_next/erin_next_toml.h"
+#include "erin_next/erin_next_trace.h"
 #include "erin_next/erin_next_random.h"
 #include "erin_next/erin_next_validation.h"
 #include "erin_next/erin_next_toml.h"
@@ -22,13 +24,26 @@
 #include <unordered_set>
 #include <vector>
 #include <map>
+#include <numeric>
 #include <iomanip>
 #include <algorithm>
+#include <cmath>
 #include <sstream>
 #include <cstdlib>
+#include <filesystem>
+#include <functional>
 
 namespace erin
 {
+    // NOTE: how many snapshots of the failure-free baseline are kept over
+    // a scenario's duration for occurrences to resume from
+    double const baselineSnapshotsPerScenario = 32.0;
+
+    // NOTE: storage amounts and states of charge in the event file are
+    // written fixed-point with this precision, which then sticks to the
+    // stream for the rows that follow
+    unsigned int const eventFileStorePrecision = 3;
+
     void
     Simulation_Init(Simulation& s)
     {
@@ -111,13 +126,12 @@ namespace erin
         {
             if (s.LoadMap.Tags[i] == tag)
             {
-                s.LoadMap.Loads[i].clear();
-                s.LoadMap.Loads[i] = loadSchedule;
+                s.LoadMap.Loads[i] = AmountSchedule_Make(loadSchedule);
                 return i;
             }
         }
         s.LoadMap.Tags.push_back(tag);
-        s.LoadMap.Loads.push_back(loadSchedule);
+        s.LoadMap.Loads.push_back(AmountSchedule_Make(loadSchedule));
         return id;
     }
 
@@ -145,7 +159,8 @@ namespace erin
         for (size_t i = 0; i < numLoads; ++i)
         {
             s.LoadMap.Tags.push_back(loads[i].Tag);
-            s.LoadMap.Loads.push_back(loads[i].TimeAndLoads);
+            s.LoadMap.Loads.push_back(AmountSchedule_Make(loads[i].TimeAndLoads)
+            );
         }
     }
 
@@ -744,18 +759,18 @@ namespace erin
         for (size_t i = 0; i < s.LoadMap.Tags.size(); ++i)
         {
             std::cout << i << ": " << s.LoadMap.Tags[i] << std::endl;
-            std::cout << "- load entries: " << s.LoadMap.Loads[i].size()
-                      << std::endl;
-            if (!s.LoadMap.Loads[i].empty())
+            AmountSchedule const& schedule = s.LoadMap.Loads[i];
+            size_t numEntries = AmountSchedule_Size(schedule);
+            std::cout << "- load entries: " << numEntries << std::endl;
+            if (numEntries > 0)
             {
                 // TODO: add time units
-                std::cout << "- initial time: " << s.LoadMap.Loads[i][0].Time_s
-                          << std::endl;
+                std::cout << "- initial time: "
+                          << AmountSchedule_TimeAt(schedule, 0) << std::endl;
                 // TODO: add time units
-                std::cout
-                    << "- final time  : "
-                    << s.LoadMap.Loads[i][s.LoadMap.Loads[i].size() - 1].Time_s
-                    << std::endl;
+                std::cout << "- final time  : "
+                          << AmountSchedule_TimeAt(schedule, numEntries - 1)
+                          << std::endl;
                 // TODO: add max rate
                 // TODO: add min rate
                 // TODO: add average rate
@@ -1129,6 +1144,9 @@ namespace erin
                         tfc.VulnerabilityId = intensityId;
                         tfc.Intensities = std::move(pv.Firsts);
                         tfc.FailureFractions = std::move(pv.Seconds);
+                        tfc.FailureFractionByIntensity = LookupTable_Make(
+                            tfc.Intensities, tfc.FailureFractions
+                        );
                         size_t subtypeIdx = s.TabularFragilityCurves.size();
                         s.TabularFragilityCurves.push_back(std::move(tfc));
                         Simulation_RegisterFragilityCurve(
@@ -1505,6 +1523,9 @@ namespace erin
         Log const& log
     )
     {
+        // NOTE: loads are timed on their own; everything else reading the
+        // input is validation
+        ProfileTimer validationTimer{ProfilePhase::Validation};
         Simulation s = {};
         Simulation_Init(s);
         auto simInfoResult = Simulation_ParseSimulationInfo(
@@ -1515,13 +1536,17 @@ namespace erin
             Log_Error(log, "simulation_info", "problem parsing...");
             return {};
         }
-        auto loadsResult = Simulation_ParseLoads(
-            s,
-            v,
-            validationInfo.Load_01Explicit,
-            validationInfo.Load_02FileBased,
-            log
-        );
+        Result loadsResult = Result::Success;
+        {
+            ProfileTimer loadsTimer{ProfilePhase::LoadIngestion};
+            loadsResult = Simulation_ParseLoads(
+                s,
+                v,
+                validationInfo.Load_01Explicit,
+                validationInfo.Load_02FileBased,
+                log
+            );
+        }
         if (loadsResult == Result::Failure)
         {
             Log_Error(log, "loads", "problem parsing...");
@@ -1675,7 +1700,8 @@ namespace erin
         std::vector<size_t> const& compOrder,
         TimeUnit outputTimeUnit,
         std::vector<NodeConnection> const& nodeConnections,
-        bool aggregateGroups
+        bool aggregateGroups,
+        std::string const& flowUnit
     )
     {
         ComponentDict const& compMap = model.ComponentMap;
@@ -1697,7 +1723,7 @@ namespace erin
                     << NodeConnectionToString(
                            model, fd, nodeConn, true, aggregateGroups
                        )
-                    << " (kW)";
+                    << " (" << flowUnit << ")";
             }
         }
 
@@ -1743,86 +1769,44 @@ namespace erin
         out << std::endl;
     }
 
+    std::vector<size_t>
+    CalculateTagOrder(std::vector<std::string> const& tags)
+    {
+        std::vector<size_t> result(tags.size());
+        std::iota(result.begin(), result.end(), 0);
+        std::stable_sort(
+            result.begin(),
+            result.end(),
+            [&tags](size_t a, size_t b) { return tags[a] < tags[b]; }
+        );
+        return result;
+    }
+
     std::vector<size_t>
     CalculateConnectionOrder(Simulation const& s)
     {
         // TODO: need to enforce connections are unique
-        size_t const numConns = s.TheModel.Connections.size();
-        std::vector<size_t> result;
-        std::vector<std::string> originalConnTags;
         std::vector<std::string> connTags;
-        result.reserve(numConns);
-        originalConnTags.reserve(numConns);
-        connTags.reserve(numConns);
+        connTags.reserve(s.TheModel.Connections.size());
         for (auto const& conn : s.TheModel.Connections)
         {
-            std::string connTag =
-                ConnectionToString(s.TheModel.ComponentMap, conn, true);
-            originalConnTags.push_back(connTag);
-            connTags.push_back(connTag);
-        }
-        std::sort(connTags.begin(), connTags.end());
-        for (auto const& connTag : connTags)
-        {
-            for (size_t connId = 0; connId < s.TheModel.Connections.size();
-                 ++connId)
-            {
-                if (connTag == originalConnTags[connId])
-                {
-                    result.push_back(connId);
-                    break;
-                }
-            }
+            connTags.push_back(
+                ConnectionToString(s.TheModel.ComponentMap, conn, true)
+            );
         }
-        assert(result.size() == numConns);
-        return result;
+        return CalculateTagOrder(connTags);
     }
 
     std::vector<size_t>
     CalculateScenarioOrder(Simulation const& s)
     {
-        std::vector<size_t> result;
-        std::vector<std::string> scenarioTags(s.ScenarioMap.Tags);
-        size_t numScenarios = s.ScenarioMap.Tags.size();
-        std::sort(scenarioTags.begin(), scenarioTags.end());
-        result.reserve(numScenarios);
-        for (std::string const& tag : scenarioTags)
-        {
-            for (size_t scenarioId = 0; scenarioId < s.ScenarioMap.Tags.size();
-                 ++scenarioId)
-            {
-                if (tag == s.ScenarioMap.Tags[scenarioId])
-                {
-                    result.push_back(scenarioId);
-                    break;
-                }
-            }
-        }
-        assert(result.size() == numScenarios);
-        return result;
+        return CalculateTagOrder(s.ScenarioMap.Tags);
     }
 
     std::vector<size_t>
     CalculateComponentOrder(Simulation const& s)
     {
-        size_t const numComps = s.TheModel.ComponentMap.Tag.size();
-        std::vector<size_t> result;
-        result.reserve(numComps);
-        std::vector<std::string> compTags(s.TheModel.ComponentMap.Tag);
-        std::sort(compTags.begin(), compTags.end());
-        for (auto const& t : compTags)
-        {
-            for (size_t compId = 0; compId < numComps; ++compId)
-            {
-                if (s.TheModel.ComponentMap.Tag[compId] == t)
-                {
-                    result.push_back(compId);
-                    break;
-                }
-            }
-        }
-        assert(result.size() == numComps);
-        return result;
+        return CalculateTagOrder(s.TheModel.ComponentMap.Tag);
     }
 
     std::vector<size_t>
@@ -1849,90 +1833,53 @@ namespace erin
         std::unordered_set<size_t> const& compsToReport
     )
     {
-        std::vector<size_t> result{};
-        std::vector<std::string> storeTags{};
-        storeTags.reserve(s.TheModel.Stores.size());
         size_t const numComps = s.TheModel.ComponentMap.CompType.size();
         size_t const numStores = s.TheModel.Stores.size();
-        std::vector<size_t> reportedStoreIdxs{};
-        reportedStoreIdxs.reserve(s.TheModel.Stores.size());
-        for (size_t storeId = 0; storeId < numStores; ++storeId)
+        size_t const noComp = numComps;
+        std::vector<size_t> compIdByStoreIdx(numStores, noComp);
+        for (size_t compId = 0; compId < numComps; ++compId)
         {
-            for (size_t compId = 0; compId < numComps; ++compId)
+            size_t idx = s.TheModel.ComponentMap.Idx[compId];
+            if (s.TheModel.ComponentMap.CompType[compId]
+                    == ComponentType::StoreType
+                && idx < numStores && compIdByStoreIdx[idx] == noComp
+                && compsToReport.contains(compId))
             {
-                if (!compsToReport.contains(compId))
-                {
-                    continue;
-                }
-                ComponentType type = s.TheModel.ComponentMap.CompType[compId];
-                size_t idx = s.TheModel.ComponentMap.Idx[compId];
-                if (type == ComponentType::StoreType && idx == storeId)
-                {
-                    reportedStoreIdxs.push_back(idx);
-                    storeTags.push_back(s.TheModel.ComponentMap.Tag[compId]);
-                    break;
-                }
+                compIdByStoreIdx[idx] = compId;
             }
         }
-        assert(storeTags.size() <= numStores);
-        std::vector<std::string> originalStoreTags(storeTags);
-        std::sort(storeTags.begin(), storeTags.end());
-        for (auto const& tag : storeTags)
+        std::vector<size_t> reportedStoreIdxs{};
+        std::vector<std::string> storeTags{};
+        reportedStoreIdxs.reserve(numStores);
+        storeTags.reserve(numStores);
+        for (size_t storeIdx = 0; storeIdx < numStores; ++storeIdx)
         {
-            for (size_t i = 0; i < reportedStoreIdxs.size(); ++i)
+            size_t compId = compIdByStoreIdx[storeIdx];
+            if (compId != noComp)
             {
-                if (tag == originalStoreTags[i])
-                {
-                    result.push_back(reportedStoreIdxs[i]);
-                }
+                reportedStoreIdxs.push_back(storeIdx);
+                storeTags.push_back(s.TheModel.ComponentMap.Tag[compId]);
             }
         }
-        assert(result.size() <= numStores);
+        std::vector<size_t> result{};
+        result.reserve(storeTags.size());
+        for (size_t i : CalculateTagOrder(storeTags))
+        {
+            result.push_back(reportedStoreIdxs[i]);
+        }
         return result;
     }
 
     std::vector<size_t>
     CalculateFailModeOrder(Simulation const& s)
     {
-        size_t const numFailModes = s.FailureModes.Tags.size();
-        std::vector<size_t> result;
-        std::vector<std::string> failTags(s.FailureModes.Tags);
-        std::sort(failTags.begin(), failTags.end());
-        for (auto const& t : failTags)
-        {
-            for (size_t i = 0; i < numFailModes; ++i)
-            {
-                if (s.FailureModes.Tags[i] == t)
-                {
-                    result.push_back(i);
-                    break;
-                }
-            }
-        }
-        assert(result.size() == numFailModes);
-        return result;
+        return CalculateTagOrder(s.FailureModes.Tags);
     }
 
     std::vector<size_t>
     CalculateFragilModeOrder(Simulation const& s)
     {
-        size_t const numFragModes = s.FragilityModes.Tags.size();
-        std::vector<size_t> result;
-        std::vector<std::string> fragTags(s.FragilityModes.Tags);
-        std::sort(fragTags.begin(), fragTags.end());
-        for (auto const& t : fragTags)
-        {
-            for (size_t i = 0; i < numFragModes; ++i)
-            {
-                if (s.FragilityModes.Tags[i] == t)
-                {
-                    result.push_back(i);
-                    break;
-                }
-            }
-        }
-        assert(result.size() == numFragModes);
-        return result;
+        return CalculateTagOrder(s.FragilityModes.Tags);
     }
 
     std::string
@@ -1958,43 +1905,46 @@ namespace erin
     std::vector<size_t>
     CalculateNodeConnectionOrder(
         Simulation const& s,
-        std::vector<NodeConnection> nodeConnections,
+        std::vector<NodeConnection> const& nodeConnections,
         bool aggregateGroups = true
     )
     {
-        size_t const nNodeConns = nodeConnections.size();
-        std::vector<std::string> originalNodeConnTags = {};
         std::vector<std::string> nodeConnTags = {};
-
-        originalNodeConnTags.reserve(nNodeConns);
-        nodeConnTags.reserve(nNodeConns);
+        nodeConnTags.reserve(nodeConnections.size());
         for (auto const& nodeConn : nodeConnections)
         {
-            std::string nodeConnTag = NodeConnectionToString(
+            nodeConnTags.push_back(NodeConnectionToString(
                 s.TheModel, nodeConn, true, aggregateGroups
-            );
-            originalNodeConnTags.push_back(nodeConnTag);
-            nodeConnTags.push_back(nodeConnTag);
+            ));
         }
-        std::sort(nodeConnTags.begin(), nodeConnTags.end());
+        return CalculateTagOrder(nodeConnTags);
+    }
 
-        std::vector<size_t> result;
-        result.reserve(nNodeConns);
-        for (auto const& nodeConnTag : nodeConnTags)
+    // hashes the fields compared by NodeConnection::operator==
+    struct NodeConnectionHash
+    {
+        static size_t
+        HashNodeId(NodeID const& id)
         {
-            for (size_t nodeConnId = 0; nodeConnId < nodeConnTags.size();
-                 ++nodeConnId)
+            if (id.index() == 0)
             {
-                if (nodeConnTag == originalNodeConnTags[nodeConnId])
-                {
-                    result.push_back(nodeConnId);
-                    break;
-                }
+                return std::hash<size_t>{}(std::get<0>(id).id);
             }
+            return std::hash<std::string>{}(std::get<1>(id).id) ^ 1;
         }
-        assert(result.size() == nNodeConns);
-        return result;
-    }
+
+        size_t
+        operator()(NodeConnection const& nc) const
+        {
+            size_t h = HashNodeId(nc.FromId);
+            for (size_t part :
+                 {nc.FromPort, HashNodeId(nc.ToId), nc.ToPort})
+            {
+                h ^= part + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+            }
+            return h;
+        }
+    };
 
     std::vector<NodeConnection>
     GetNodeConnections(Simulation& s, bool aggregateGroups)
@@ -2015,6 +1965,9 @@ namespace erin
         auto connOrder = CalculateConnectionOrder(s);
 
         auto nConn = connections.size();
+        std::unordered_map<NodeConnection, size_t, NodeConnectionHash>
+            nodeConnIdxs{};
+        nodeConnIdxs.reserve(nConn);
         for (size_t iOrdConn = 0; iOrdConn < nConn; ++iOrdConn)
         {
             auto& iConn = connOrder[iOrdConn];
@@ -2069,82 +2022,132 @@ namespace erin
                 nodeConn.ToPort = nPorts;
                 nPorts++;
             }
-            bool newConn = true;
-            for (auto& nodeConn0 : nodeConnections)
-            {
-                if (nodeConn0 == nodeConn)
-                {
-                    newConn = false;
-                    nodeConn0.origConnId.push_back(iConn);
-                    break;
-                }
-            }
+            auto [it, newConn] =
+                nodeConnIdxs.try_emplace(nodeConn, nodeConnections.size());
             if (newConn)
             {
                 nodeConn.origConnId = {iConn};
                 nodeConnections.push_back(nodeConn);
             }
+            else
+            {
+                nodeConnections[it->second].origConnId.push_back(iConn);
+            }
         }
 
         return nodeConnections;
     }
 
+    GroupAggregation
+    GroupAggregation_Create(std::vector<NodeConnection> const& nodeConnections)
+    {
+        GroupAggregation agg{};
+        agg.RowStarts.reserve(nodeConnections.size() + 1);
+        agg.RowStarts.push_back(0);
+        for (NodeConnection const& nodeConn : nodeConnections)
+        {
+            agg.ConnIds.insert(
+                agg.ConnIds.end(),
+                nodeConn.origConnId.begin(),
+                nodeConn.origConnId.end()
+            );
+            agg.RowStarts.push_back(agg.ConnIds.size());
+        }
+        return agg;
+    }
+
     void
-    AggregateGroups(
-        std::vector<TimeAndFlows>& results,
-        std::vector<NodeConnection> const& nodeConnections
+    GroupAggregation_Apply(
+        GroupAggregation const& agg,
+        std::vector<Flow> const& flows,
+        std::vector<Flow>& nodeFlows
     )
     {
-        auto num_events = results.size();
-        if (num_events == 0)
+        size_t const numNodeConns = agg.RowStarts.size() - 1;
+        nodeFlows.assign(numNodeConns, Flow{});
+        for (size_t i = 0; i < numNodeConns; ++i)
         {
-            return;
+            for (size_t k = agg.RowStarts[i]; k < agg.RowStarts[i + 1]; ++k)
+            {
+                nodeFlows[i] += flows[agg.ConnIds[k]];
+            }
         }
+    }
 
-        auto nNodeConn = nodeConnections.size();
-        auto nResult = results.size();
-        std::vector<TimeAndFlows> newResults(nResult);
-
-        for (size_t iResult = 0; iResult < nResult; ++iResult)
+    std::vector<size_t>
+    GroupAggregation_ConnectionsOf(
+        GroupAggregation const& agg,
+        std::vector<size_t> const& nodeConnIds
+    )
+    {
+        std::vector<size_t> connIds{};
+        for (size_t i : nodeConnIds)
         {
-            newResults[iResult].Time = results[iResult].Time;
-
-            auto& origFlows = results[iResult].Flows;
-            auto& newFlows = newResults[iResult].Flows;
-            newFlows.resize(nNodeConn);
+            connIds.insert(
+                connIds.end(),
+                agg.ConnIds.begin()
+                    + static_cast<std::ptrdiff_t>(agg.RowStarts[i]),
+                agg.ConnIds.begin()
+                    + static_cast<std::ptrdiff_t>(agg.RowStarts[i + 1])
+            );
+        }
+        std::sort(connIds.begin(), connIds.end());
+        connIds.erase(
+            std::unique(connIds.begin(), connIds.end()), connIds.end()
+        );
+        return connIds;
+    }
 
-            for (size_t iNodeConn = 0; iNodeConn < nNodeConn; ++iNodeConn)
+    GroupAggregation
+    GroupAggregation_Project(
+        GroupAggregation const& agg,
+        ResultProjection const& projection
+    )
+    {
+        std::unordered_map<size_t, size_t> slotByConnId{};
+        slotByConnId.reserve(projection.ConnIds.size());
+        for (size_t slot = 0; slot < projection.ConnIds.size(); ++slot)
+        {
+            slotByConnId[projection.ConnIds[slot]] = slot;
+        }
+        GroupAggregation projected{};
+        projected.RowStarts.reserve(agg.RowStarts.size());
+        projected.RowStarts.push_back(0);
+        for (size_t i = 0; i + 1 < agg.RowStarts.size(); ++i)
+        {
+            for (size_t k = agg.RowStarts[i]; k < agg.RowStarts[i + 1]; ++k)
             {
-                auto& nodeConn = nodeConnections[iNodeConn];
-                for (auto& iConn : nodeConn.origConnId)
+                auto it = slotByConnId.find(agg.ConnIds[k]);
+                if (it != slotByConnId.end())
                 {
-                    newFlows[iNodeConn] += origFlows[iConn];
-                    break;
+                    projected.ConnIds.push_back(it->second);
                 }
             }
-
-            newResults[iResult].StorageAmounts_J =
-                results[iResult].StorageAmounts_J;
+            projected.RowStarts.push_back(projected.ConnIds.size());
         }
-        results = newResults;
+        return projected;
     }
 
     void
     WriteResultsToEventFile(
-        std::ofstream& out,
-        std::vector<TimeAndFlows> results,
+        std::ostream& out,
+        std::vector<TimeAndFlows> const& results,
         Simulation const& s,
         std::string const& scenarioTag,
         std::string const& scenarioStartTimeTag,
         std::vector<size_t> const& nodeConnOrder,
         std::vector<size_t> const& storeOrder,
         std::vector<size_t> const& compOrder,
-        TimeUnit outputTimeUnit
+        TimeUnit outputTimeUnit,
+        GroupAggregation const* aggregation,
+        UniformTimeStepResampler* resampler,
+        bool changesOnly,
+        ResultProjection const* projection
     )
     {
         // TODO: pass in desired precision
         unsigned int precision = 1;
-        unsigned int storePrecision = 3;
+        unsigned int storePrecision = eventFileStorePrecision;
         Model const& m = s.TheModel;
         std::map<size_t, std::vector<TimeState>> relSchByCompId;
         for (size_t i = 0; i < m.Reliabilities.size(); ++i)
@@ -2152,118 +2155,281 @@ namespace erin
             size_t compId = m.Reliabilities[i].ComponentId;
             relSchByCompId[compId] = m.Reliabilities[i].TimeStates;
         }
+        // NOTE: index into the storage amounts of the results for each
+        // store in storeOrder
+        std::vector<size_t> storeSlots = storeOrder;
+        if (projection != nullptr)
+        {
+            for (size_t& slot : storeSlots)
+            {
+                auto it = std::find(
+                    projection->StoreIdxs.begin(),
+                    projection->StoreIdxs.end(),
+                    slot
+                );
+                assert(it != projection->StoreIdxs.end());
+                slot = static_cast<size_t>(
+                    std::distance(projection->StoreIdxs.begin(), it)
+                );
+            }
+        }
 
-        for (auto const& r : results)
+        // NOTE: the active reliability state of each component in compOrder
+        std::vector<TimeState> states(compOrder.size());
+        auto updateStates = [&](double time_s)
         {
-            assert(r.Flows.size() >= nodeConnOrder.size());
-            out << scenarioTag << "," << scenarioStartTimeTag << ",";
-            out << TimeInSecondsToDesiredUnit(r.Time, outputTimeUnit);
+            for (size_t k = 0; k < compOrder.size(); ++k)
+            {
+                auto it = relSchByCompId.find(compOrder[k]);
+                states[k] = it != relSchByCompId.end()
+                    ? TimeState_GetActiveTimeState(it->second, time_s)
+                    : TimeState{};
+            }
+        };
 
+        auto writeValues = [&](std::ostream& dst,
+                               std::vector<Flow> const& flows,
+                               std::vector<flow_t> const& storageAmounts_J)
+        {
+            assert(flows.size() >= nodeConnOrder.size());
             for (size_t const& i : nodeConnOrder)
             {
-                out << ","
-                    << FlowInWattsToString(r.Flows[i].Actual_W, precision);
+                dst << ","
+                    << FlowInWattsToString(flows[i].Actual_W, precision);
             }
             for (size_t const& i : nodeConnOrder)
             {
-                out << ","
-                    << FlowInWattsToString(r.Flows[i].Requested_W, precision);
+                dst << ","
+                    << FlowInWattsToString(flows[i].Requested_W, precision);
             }
             for (size_t const& i : nodeConnOrder)
             {
-                out << ","
-                    << FlowInWattsToString(r.Flows[i].Available_W, precision);
+                dst << ","
+                    << FlowInWattsToString(flows[i].Available_W, precision);
             }
             // NOTE: Amounts in kJ
-            for (size_t i : storeOrder)
+            for (size_t i : storeSlots)
             {
-                double store_J = static_cast<double>(r.StorageAmounts_J[i]);
+                double store_J = static_cast<double>(storageAmounts_J[i]);
                 double store_kJ = store_J / J_per_kJ;
-                out << "," << std::fixed << std::setprecision(storePrecision)
+                dst << "," << std::fixed << std::setprecision(storePrecision)
                     << store_kJ;
             }
             // NOTE: Store state in SOC
-            for (size_t i : storeOrder)
+            for (size_t k = 0; k < storeOrder.size(); ++k)
             {
+                Store const& store = m.Stores[storeOrder[k]];
                 double soc = 0.0;
-                if (m.Stores[i].Capacity_J > 0)
+                if (store.Capacity_J > 0)
                 {
-                    soc = static_cast<double>(r.StorageAmounts_J[i])
-                        / static_cast<double>(m.Stores[i].Capacity_J);
+                    soc = static_cast<double>(storageAmounts_J[storeSlots[k]])
+                        / static_cast<double>(store.Capacity_J);
                 }
-                out << "," << std::fixed << std::setprecision(storePrecision)
+                dst << "," << std::fixed << std::setprecision(storePrecision)
                     << soc;
             }
-            for (size_t i : compOrder)
+            for (size_t k = 0; k < compOrder.size(); ++k)
             {
-                if (!m.ComponentMap.Tag[i].empty())
+                if (!m.ComponentMap.Tag[compOrder[k]].empty())
                 {
-                    if (relSchByCompId.contains(i))
+                    TimeState const& ts = states[k];
+                    if (ts.state)
+                    {
+                        dst << ",available";
+                    }
+                    else
                     {
-                        TimeState ts = TimeState_GetActiveTimeState(
-                            relSchByCompId[i], r.Time
+                        // lookup the failure and fragility modes
+                        std::vector<size_t> failModes;
+                        failModes.reserve(ts.failureModeCauses.size());
+                        std::vector<size_t> fragModes;
+                        fragModes.reserve(ts.fragilityModeCauses.size());
+                        for (size_t fm : ts.failureModeCauses)
+                        {
+                            failModes.push_back(fm);
+                        }
+                        for (size_t fm : ts.fragilityModeCauses)
+                        {
+                            fragModes.push_back(fm);
+                        }
+                        std::sort(failModes.begin(), failModes.end());
+                        std::sort(fragModes.begin(), fragModes.end());
+                        std::vector<std::string> fmTags;
+                        fmTags.reserve(
+                            ts.failureModeCauses.size()
+                            + ts.fragilityModeCauses.size()
                         );
-                        if (ts.state)
+                        for (auto const& failModeId : failModes)
                         {
-                            out << ",available";
+                            fmTags.push_back(s.FailureModes.Tags[failModeId]);
                         }
-                        else
+                        for (auto const& fragModeId : fragModes)
                         {
-                            // lookup the failure and fragility modes
-                            std::vector<size_t> failModes;
-                            failModes.reserve(ts.failureModeCauses.size());
-                            std::vector<size_t> fragModes;
-                            fragModes.reserve(ts.fragilityModeCauses.size());
-                            for (size_t fm : ts.failureModeCauses)
-                            {
-                                failModes.push_back(fm);
-                            }
-                            for (size_t fm : ts.fragilityModeCauses)
-                            {
-                                fragModes.push_back(fm);
-                            }
-                            std::sort(failModes.begin(), failModes.end());
-                            std::sort(fragModes.begin(), fragModes.end());
-                            std::vector<std::string> fmTags;
-                            fmTags.reserve(
-                                ts.failureModeCauses.size()
-                                + ts.fragilityModeCauses.size()
-                            );
-                            for (auto const& failModeId : failModes)
-                            {
-                                fmTags.push_back(s.FailureModes.Tags[failModeId]
-                                );
-                            }
-                            for (auto const& fragModeId : fragModes)
-                            {
-                                fmTags.push_back(
-                                    s.FragilityModes.Tags[fragModeId]
-                                );
-                            }
-                            bool first = true;
-                            std::ostringstream oss{};
-                            for (std::string const& tag : fmTags)
-                            {
-                                oss << (first ? "" : " | ") << tag;
-                                first = false;
-                            }
-                            out << "," << oss.str();
+                            fmTags.push_back(s.FragilityModes.Tags[fragModeId]);
                         }
+                        bool first = true;
+                        std::ostringstream oss{};
+                        for (std::string const& tag : fmTags)
+                        {
+                            oss << (first ? "" : " | ") << tag;
+                            first = false;
+                        }
+                        dst << "," << oss.str();
                     }
-                    else
-                    {
-                        out << ",available";
-                    }
                 }
             }
-            out << std::endl;
+        };
+
+        // NOTE: in change-only mode a row is kept only if its values differ
+        // from those of the last row written. The raw values are compared
+        // first so that repeated rows are not formatted at all; rows that
+        // differ only below the written precision are formatted and then
+        // compared as text. The last row of the results is always kept to
+        // mark the end time.
+        std::ostringstream rowOut{};
+        rowOut.copyfmt(out);
+        std::vector<Flow> lastFlows(nodeConnOrder.size());
+        std::vector<flow_t> lastStorageAmounts_J(storeSlots.size());
+        std::vector<TimeState> lastStates(compOrder.size());
+        std::string lastValues{};
+        std::optional<double> skippedTime_s{};
+        bool anyWritten = false;
+        auto isSameAsLastWritten = [&](std::vector<Flow> const& flows,
+                                       std::vector<flow_t> const& amounts_J)
+        {
+            for (size_t k = 0; k < nodeConnOrder.size(); ++k)
+            {
+                Flow const& flow = flows[nodeConnOrder[k]];
+                if (flow.Actual_W != lastFlows[k].Actual_W
+                    || flow.Requested_W != lastFlows[k].Requested_W
+                    || flow.Available_W != lastFlows[k].Available_W)
+                {
+                    return false;
+                }
+            }
+            for (size_t k = 0; k < storeSlots.size(); ++k)
+            {
+                if (amounts_J[storeSlots[k]] != lastStorageAmounts_J[k])
+                {
+                    return false;
+                }
+            }
+            for (size_t k = 0; k < compOrder.size(); ++k)
+            {
+                TimeState const& ts = states[k];
+                TimeState const& last = lastStates[k];
+                if (ts.state != last.state
+                    || (!ts.state
+                        && (ts.failureModeCauses != last.failureModeCauses
+                            || ts.fragilityModeCauses
+                                != last.fragilityModeCauses)))
+                {
+                    return false;
+                }
+            }
+            return true;
+        };
+        auto writeRow = [&](double time_s,
+                            std::vector<Flow> const& flows,
+                            std::vector<flow_t> const& storageAmounts_J)
+        {
+            updateStates(time_s);
+            if (!changesOnly)
+            {
+                out << scenarioTag << "," << scenarioStartTimeTag << ",";
+                out << TimeInSecondsToDesiredUnit(time_s, outputTimeUnit);
+                writeValues(out, flows, storageAmounts_J);
+                out << std::endl;
+                return;
+            }
+            if (anyWritten && isSameAsLastWritten(flows, storageAmounts_J))
+            {
+                skippedTime_s = time_s;
+                return;
+            }
+            rowOut.str("");
+            rowOut << TimeInSecondsToDesiredUnit(time_s, outputTimeUnit);
+            size_t timeLength = rowOut.str().size();
+            writeValues(rowOut, flows, storageAmounts_J);
+            std::string row = rowOut.str();
+            if (anyWritten
+                && row.compare(timeLength, std::string::npos, lastValues) == 0)
+            {
+                skippedTime_s = time_s;
+                return;
+            }
+            out << scenarioTag << "," << scenarioStartTimeTag << "," << row
+                << "\n";
+            lastValues = row.substr(timeLength);
+            for (size_t k = 0; k < nodeConnOrder.size(); ++k)
+            {
+                lastFlows[k] = flows[nodeConnOrder[k]];
+            }
+            for (size_t k = 0; k < storeSlots.size(); ++k)
+            {
+                lastStorageAmounts_J[k] = storageAmounts_J[storeSlots[k]];
+            }
+            lastStates = states;
+            skippedTime_s.reset();
+            anyWritten = true;
+        };
+
+        if (resampler != nullptr)
+        {
+            UniformTimeStepResampler_Reset(*resampler);
+        }
+        std::vector<Flow> nodeFlows{};
+        for (auto const& r : results)
+        {
+            if (aggregation != nullptr)
+            {
+                ProfileTimer timer{ProfilePhase::Aggregate};
+                GroupAggregation_Apply(*aggregation, r.Flows, nodeFlows);
+            }
+            std::vector<Flow> const& flows =
+                aggregation != nullptr ? nodeFlows : r.Flows;
+            if (resampler == nullptr)
+            {
+                writeRow(r.Time, flows, r.StorageAmounts_J);
+                continue;
+            }
+            ProfileTimer timer{ProfilePhase::Resample};
+            UniformTimeStepResampler_Push(
+                *resampler,
+                r.Time,
+                flows,
+                r.StorageAmounts_J,
+                [&](TimeAndFlows const& report)
+                {
+                    ProfileTimer writeTimer{ProfilePhase::Write};
+                    writeRow(
+                        report.Time, report.Flows, report.StorageAmounts_J
+                    );
+                }
+            );
+        }
+        if (changesOnly)
+        {
+            if (skippedTime_s.has_value())
+            {
+                // NOTE: a skipped row has the values of the last row written
+                rowOut.str("");
+                rowOut << TimeInSecondsToDesiredUnit(
+                    *skippedTime_s, outputTimeUnit
+                );
+                out << scenarioTag << "," << scenarioStartTimeTag << ","
+                    << rowOut.str() << lastValues << "\n";
+            }
+            // NOTE: leave the stream as writing each row to it would
+            out.flags(rowOut.flags());
+            out.precision(rowOut.precision());
         }
     }
 
     Result
     SetLoadsForScenario(
         std::vector<ScheduleBasedLoad>& loads,
-        LoadDict loadMap,
+        LoadDict const& loadMap,
         size_t scenarioIdx
     )
     {
@@ -2272,17 +2438,7 @@ namespace erin
             if (loads[sblIdx].ScenarioIdToLoadId.contains(scenarioIdx))
             {
                 auto loadId = loads[sblIdx].ScenarioIdToLoadId.at(scenarioIdx);
-                std::vector<TimeAndAmount> schedule{};
-                size_t numEntries = loadMap.Loads[loadId].size();
-                schedule.reserve(numEntries);
-                for (size_t i = 0; i < numEntries; ++i)
-                {
-                    TimeAndAmount tal{};
-                    tal.Time_s = loadMap.Loads[loadId][i].Time_s;
-                    tal.Amount_W = loadMap.Loads[loadId][i].Amount_W;
-                    schedule.push_back(std::move(tal));
-                }
-                loads[sblIdx].TimesAndLoads = std::move(schedule);
+                loads[sblIdx].TimesAndLoads = loadMap.Loads[loadId];
             }
             else
             {
@@ -2298,7 +2454,7 @@ namespace erin
     Result
     SetSupplyForScenario(
         std::vector<ScheduleBasedSource>& loads,
-        LoadDict loadMap,
+        LoadDict const& loadMap,
         size_t scenarioIdx
     )
     {
@@ -2308,17 +2464,7 @@ namespace erin
             {
                 auto loadId =
                     loads[sblIdx].ScenarioIdToSourceId.at(scenarioIdx);
-                std::vector<TimeAndAmount> schedule{};
-                size_t numEntries = loadMap.Loads[loadId].size();
-                schedule.reserve(numEntries);
-                for (size_t i = 0; i < numEntries; ++i)
-                {
-                    TimeAndAmount tal{};
-                    tal.Time_s = loadMap.Loads[loadId][i].Time_s;
-                    tal.Amount_W = loadMap.Loads[loadId][i].Amount_W;
-                    schedule.push_back(std::move(tal));
-                }
-                loads[sblIdx].TimeAndAvails = std::move(schedule);
+                loads[sblIdx].TimeAndAvails = loadMap.Loads[loadId];
             }
             else
             {
@@ -2342,7 +2488,49 @@ namespace erin
         auto const distId = s.ScenarioMap.OccurrenceDistributionIds[scenIdx];
         double scenarioStartTime_s = 0.0;
         double maxTime_s = Time_ToSeconds(s.Info.MaxTime, s.Info.TheTimeUnit);
-        for (size_t i = 0; i < maxOccurrence; ++i)
+        // NOTE: draw in batches while the remaining time guarantees that
+        // every occurrence in the batch lands before maxTime_s (keeping one
+        // bounded advance in reserve for round-off). A batch ends at the
+        // first fraction above max_batch_fraction, whose advance is checked
+        // like any other, so the generator is consumed exactly as the scalar
+        // loop does.
+        double const maxAdvance_s =
+            s.TheModel.DistSys.max_time_advance(distId, max_batch_fraction);
+        constexpr size_t maxBatchSize = 512;
+        std::vector<double> advances_s;
+        size_t i = 0;
+        while (i < maxOccurrence && maxAdvance_s > 0.0
+               && std::isfinite(maxAdvance_s))
+        {
+            double const sureCount =
+                std::floor((maxTime_s - scenarioStartTime_s) / maxAdvance_s)
+                - 1.0;
+            if (!(sureCount >= 1.0))
+            {
+                break;
+            }
+            size_t batchSize = std::min(maxOccurrence - i, maxBatchSize);
+            if (sureCount < static_cast<double>(batchSize))
+            {
+                batchSize = static_cast<size_t>(sureCount);
+            }
+            advances_s.resize(batchSize);
+            size_t numDrawn = s.TheModel.DistSys.sample_n(
+                distId, advances_s, max_batch_fraction
+            );
+            occurrenceTimes_s.reserve(occurrenceTimes_s.size() + numDrawn);
+            for (size_t k = 0; k < numDrawn; ++k)
+            {
+                scenarioStartTime_s += advances_s[k];
+                if (scenarioStartTime_s > maxTime_s)
+                {
+                    return occurrenceTimes_s;
+                }
+                occurrenceTimes_s.push_back(scenarioStartTime_s);
+            }
+            i += numDrawn;
+        }
+        for (; i < maxOccurrence; ++i)
         {
             scenarioStartTime_s += s.TheModel.DistSys.next_time_advance(distId);
             if (scenarioStartTime_s > maxTime_s)
@@ -2354,6 +2542,43 @@ namespace erin
         return occurrenceTimes_s;
     }
 
+    double
+    ScenarioOccurrenceStats_GetMetric(
+        ScenarioOccurrenceStats const& sos,
+        ConvergenceMetric metric
+    )
+    {
+        switch (metric)
+        {
+            case ConvergenceMetric::EnergyAvailability:
+            {
+                return sos.Duration_s > 0.0 ? (sos.Uptime_s / sos.Duration_s)
+                                            : 1.0;
+            }
+            case ConvergenceMetric::EnergyRobustness:
+            {
+                return sos.OutflowRequest_kJ > 0.0
+                    ? (sos.OutflowAchieved_kJ / sos.OutflowRequest_kJ)
+                    : 1.0;
+            }
+            case ConvergenceMetric::LoadNotServed:
+            {
+                return sos.LoadNotServed_kJ;
+            }
+            case ConvergenceMetric::MaxSingleEventDowntime:
+            {
+                return sos.MaxSEDT_s / seconds_per_hour;
+            }
+            case ConvergenceMetric::GlobalAvailability:
+            {
+                return sos.Duration_s > 0.0
+                    ? (sos.Availability_s / sos.Duration_s)
+                    : 0.0;
+            }
+        }
+        return 0.0;
+    }
+
     std::unordered_map<size_t, double>
     GetIntensitiesForScenario(Simulation& s, size_t scenIdx)
     {
@@ -2463,8 +2688,8 @@ namespace erin
         std::vector<std::string> const& fragilityModeTags,
         std::vector<size_t> const& fragilityCurveCurveIds,
         std::vector<FragilityCurveType> const& fragilityCurveCurveTypes,
-        std::vector<LinearFragilityCurve> linearFragilityCurves,
-        std::vector<TabularFragilityCurve> tabularFragilityCurves,
+        std::vector<LinearFragilityCurve> const& linearFragilityCurves,
+        std::vector<TabularFragilityCurve> const& tabularFragilityCurves,
         DistributionSystem const& ds,
         double startTime_s,
         double endTime_s,
@@ -2472,7 +2697,11 @@ namespace erin
         std::unordered_map<size_t, std::vector<TimeState>> const&
             relSchByCompId,
         bool verbose,
-        Log const& log
+        Log const& log,
+        bool schedulesAreClipped,
+        double fragilityOddsFactor,
+        double* likelihoodRatio,
+        SampledRandom* sampledRandom
     )
     {
         std::vector<ScheduleBasedReliability> result;
@@ -2507,9 +2736,16 @@ namespace erin
                     )
                 );
             }
-            std::vector<TimeState> clip = TimeState_Clip(
-                sch, startTime_s + initialAge_s, endTime_s + initialAge_s, true
-            );
+            // NOTE: schedules from CreateFailureSchedules(..., true) are
+            // already clipped to the scenario and rezeroed
+            std::vector<TimeState> clip = schedulesAreClipped
+                ? sch
+                : TimeState_Clip(
+                      sch,
+                      startTime_s + initialAge_s,
+                      endTime_s + initialAge_s,
+                      true
+                  );
             // NOTE: Reliabilities have not yet been assigned so we can
             // just push_back()
             ScheduleBasedReliability sbr{};
@@ -2530,8 +2766,15 @@ namespace erin
                  cfmIdx < componentFragilityComponentIds.size();
                  ++cfmIdx)
             {
-                size_t fmId = componentFragilityFragilityModeIds[cfmIdx];
-                size_t fcId = fragilityModeFragilityCurveIds[fmId];
+                if (sampledRandom != nullptr)
+                {
+                    SampledRandom_StartStream(
+                        *sampledRandom,
+                        componentFailureModeComponentIds.size() + cfmIdx
+                    );
+                }
+                size_t fmId = componentFragilityFragilityModeIds[cfmIdx];
+                size_t fcId = fragilityModeFragilityCurveIds[fmId];
                 std::optional<size_t> repairId =
                     fragilityModeRepairDistIds[fmId];
                 FragilityCurveType curveType = fragilityCurveCurveTypes[fcId];
@@ -2542,7 +2785,8 @@ namespace erin
                 {
                     case (FragilityCurveType::Linear):
                     {
-                        LinearFragilityCurve lfc = linearFragilityCurves[fcIdx];
+                        LinearFragilityCurve const& lfc =
+                            linearFragilityCurves[fcIdx];
                         size_t vulnerId = lfc.VulnerabilityId;
                         if (intensityIdToAmount.contains(vulnerId))
                         {
@@ -2556,7 +2800,7 @@ namespace erin
                     break;
                     case (FragilityCurveType::Tabular):
                     {
-                        TabularFragilityCurve tfc =
+                        TabularFragilityCurve const& tfc =
                             tabularFragilityCurves[fcIdx];
                         size_t vulnerId = tfc.VulnerabilityId;
                         if (intensityIdToAmount.contains(vulnerId))
@@ -2588,6 +2832,20 @@ namespace erin
                 {
                     isFailed = false;
                 }
+                else if (fragilityOddsFactor != 1.0)
+                {
+                    // NOTE: importance sampling; failures are drawn with
+                    // their odds scaled and weighted back by p/q
+                    double q = ImportanceSampling_FailureProbability(
+                        failureFrac, fragilityOddsFactor
+                    );
+                    isFailed = randFn() <= q;
+                    if (likelihoodRatio != nullptr)
+                    {
+                        *likelihoodRatio *=
+                            ImportanceSampling_Weight(failureFrac, q, isFailed);
+                    }
+                }
                 else
                 {
                     isFailed = randFn() <= failureFrac;
@@ -2672,6 +2930,61 @@ namespace erin
         return result;
     }
 
+    std::string
+    ConvergenceFilePath(std::string const& statsPath)
+    {
+        std::filesystem::path p{statsPath};
+        std::string name = fmt::format(
+            "{}-convergence{}", p.stem().string(), p.extension().string()
+        );
+        return p.replace_filename(name).string();
+    }
+
+    // NOTE: the streaming estimate of each convergence metric by scenario;
+    // written next to the statistics file so that it stays one table
+    static void
+    WriteConvergenceToFile(
+        Simulation const& s,
+        std::string const& filePath,
+        std::vector<ScenarioConvergenceStats> const& convergenceStats
+    )
+    {
+        std::ofstream out;
+        out.open(filePath);
+        if (!out.good())
+        {
+            std::cout << "Could not open '" << filePath << "' for writing."
+                      << std::endl;
+            return;
+        }
+        double zScore = ConfidenceLevelToZScore(s.Info.ConfidenceLevel);
+        out << "scenario tag," << "metric," << "occurrences,"
+            << "max occurrences," << "mean," << "variance,"
+            << "confidence level," << "confidence half-width,"
+            << "target half-width," << "converged" << std::endl;
+        for (ScenarioConvergenceStats const& scs : convergenceStats)
+        {
+            for (size_t i = 0; i < scs.MetricStats.size(); ++i)
+            {
+                StreamingStats const& ms = scs.MetricStats[i];
+                out << s.ScenarioMap.Tags[scs.ScenarioId];
+                out << ","
+                    << ConvergenceMetricToTag(s.Info.ConvergenceMetrics[i]);
+                out << "," << scs.NumOccurrences;
+                out << "," << scs.MaxOccurrences;
+                out << "," << ms.Mean;
+                out << "," << StreamingStats_Variance(ms);
+                out << "," << s.Info.ConfidenceLevel;
+                out << "," << StreamingStats_HalfWidth(ms, zScore);
+                out << ","
+                    << (s.Info.ConvergenceTolerances[i] * std::abs(ms.Mean));
+                out << "," << (scs.IsConverged ? "true" : "false");
+                out << std::endl;
+            }
+        }
+        out.close();
+    }
+
     // TODO: change this to write all data in a columnar format
     // and THEN sort them and iterate through them to write the
     // header and rows in order. Otherwise, we separate the header
@@ -2683,7 +2996,9 @@ namespace erin
         std::vector<ScenarioOccurrenceStats> const& occurrenceStats,
         std::vector<size_t> const& compOrder,
         std::vector<size_t> const& failOrder,
-        std::vector<size_t> const& fragOrder
+        std::vector<size_t> const& fragOrder,
+        std::vector<ScenarioConvergenceStats> const& convergenceStats,
+        bool writeAllLinkedModes
     )
     {
         std::ofstream stats;
@@ -2703,6 +3018,11 @@ namespace erin
               << "energy availability [EA],"
               << "max single event downtime [MaxSEDT] (h),"
               << "global availability";
+        bool const writeWeights = s.Info.FragilityImportanceFactor > 1.0;
+        if (writeWeights)
+        {
+            stats << ",likelihood ratio weight";
+        }
         if (occurrenceStats.size() > 0)
         {
             for (auto const& statsByFlow : occurrenceStats[0].FlowTypeStats)
@@ -2765,10 +3085,26 @@ namespace erin
         }
         std::map<size_t, std::set<size_t>> failModeIdsByCompId;
         std::map<size_t, std::set<size_t>> fragModeIdsByCompId;
+        // NOTE: a shard's partial file has columns for every mode linked to
+        // a component, as any of them may occur in another shard; merging
+        // drops those that never occurred
+        if (writeAllLinkedModes)
+        {
+            for (size_t i = 0; i < s.ComponentFailureModes.ComponentIds.size();
+                 ++i)
+            {
+                failModeIdsByCompId[s.ComponentFailureModes.ComponentIds[i]]
+                    .insert(s.ComponentFailureModes.FailureModeIds[i]);
+            }
+            for (size_t i = 0; i < s.ComponentFragilities.ComponentIds.size();
+                 ++i)
+            {
+                fragModeIdsByCompId[s.ComponentFragilities.ComponentIds[i]]
+                    .insert(s.ComponentFragilities.FragilityModeIds[i]);
+            }
+        }
         for (size_t compId : compOrder)
         {
-            failModeIdsByCompId[compId] = std::set<size_t>{};
-            fragModeIdsByCompId[compId] = std::set<size_t>{};
             for (auto const& occ : occurrenceStats)
             {
                 if (occ.EventCountByCompIdByFailureModeId.contains(compId))
@@ -2861,6 +3197,10 @@ namespace erin
                   << ((os.Duration_s > 0.0)
                           ? (os.Availability_s / os.Duration_s)
                           : 0.0);
+            if (writeWeights)
+            {
+                stats << "," << os.Weight;
+            }
             // NOTE: written in alphabetical order by flowtype name
             for (auto const& statsByFlow : os.FlowTypeStats)
             {
@@ -3023,59 +3363,383 @@ namespace erin
             stats << std::endl;
         }
         stats.close();
+        if (convergenceStats.size() > 0)
+        {
+            WriteConvergenceToFile(
+                s, ConvergenceFilePath(statsFilePath), convergenceStats
+            );
+        }
     }
 
-    std::vector<TimeAndFlows>
-    ApplyUniformTimeStep(
-        std::vector<TimeAndFlows> const& results,
-        double const time_step_h
+    bool
+    Reliabilities_AreFailureFree(
+        std::vector<ScheduleBasedReliability> const& reliabilities
     )
     {
-        auto num_events = results.size();
-        if ((num_events == 0) || (time_step_h <= 0.0))
+        for (ScheduleBasedReliability const& sbr : reliabilities)
         {
-            return results;
+            for (TimeState const& ts : sbr.TimeStates)
+            {
+                if (!ts.state)
+                {
+                    return false;
+                }
+            }
         }
+        return true;
+    }
 
-        auto taf = results.front();
-        auto num_stored = taf.StorageAmounts_J.size();
+    double
+    Reliabilities_FirstEventTime(
+        std::vector<ScheduleBasedReliability> const& reliabilities
+    )
+    {
+        double firstTime_s = infinity;
+        for (ScheduleBasedReliability const& sbr : reliabilities)
+        {
+            for (TimeState const& ts : sbr.TimeStates)
+            {
+                // NOTE: clipped schedules start with an up entry at time 0;
+                // a component that is already up does not change anything
+                if (ts.state && ts.time == 0.0)
+                {
+                    continue;
+                }
+                if (firstTime_s == infinity || ts.time < firstTime_s)
+                {
+                    firstTime_s = ts.time;
+                }
+                break;
+            }
+        }
+        return firstTime_s;
+    }
 
-        std::vector<TimeAndFlows> modified_results = {taf};
+    bool
+    Reliabilities_AreEqual(
+        std::vector<ScheduleBasedReliability> const& a,
+        std::vector<ScheduleBasedReliability> const& b
+    )
+    {
+        if (a.size() != b.size())
+        {
+            return false;
+        }
+        for (size_t i = 0; i < a.size(); ++i)
+        {
+            if (a[i].ComponentId != b[i].ComponentId
+                || a[i].TimeStates != b[i].TimeStates)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
 
-        double t_prev_report_s = 0.0;
-        double T_report_s = 3600.0 * time_step_h;
+    void
+    WriteFailureFreeOccurrenceToEventFile(
+        std::ostream& out,
+        FailureFreeOccurrence& ffo,
+        Simulation const& s,
+        std::string const& scenarioTag,
+        std::string const& scenarioStartTimeTag,
+        std::vector<size_t> const& nodeConnOrder,
+        std::vector<size_t> const& storeOrder,
+        std::vector<size_t> const& compOrder,
+        TimeUnit outputTimeUnit,
+        GroupAggregation const& aggregation,
+        UniformTimeStepResampler* resampler,
+        bool changesOnly,
+        ResultProjection const* projection
+    )
+    {
+        // NOTE: the rows are formatted once and then only the scenario and
+        // start-time columns are written per occurrence. Number formatting
+        // depends on the stream's flags, so the rows are redone if those
+        // have changed since.
+        if (ffo.EventRows.empty() || ffo.FlagsBefore != out.flags()
+            || ffo.PrecisionBefore != out.precision())
+        {
+            ffo.FlagsBefore = out.flags();
+            ffo.PrecisionBefore = out.precision();
+            std::ostringstream oss{};
+            oss.copyfmt(out);
+            WriteResultsToEventFile(
+                oss,
+                ffo.EventResults,
+                s,
+                "",
+                "",
+                nodeConnOrder,
+                storeOrder,
+                compOrder,
+                outputTimeUnit,
+                &aggregation,
+                resampler,
+                changesOnly,
+                projection
+            );
+            ffo.EventRows.clear();
+            std::istringstream rows{oss.str()};
+            std::string row;
+            while (std::getline(rows, row))
+            {
+                // NOTE: drop the two empty leading columns
+                ffo.EventRows.push_back(row.substr(2));
+            }
+            ffo.FlagsAfter = oss.flags();
+            ffo.PrecisionAfter = oss.precision();
+        }
+        for (std::string const& row : ffo.EventRows)
+        {
+            out << scenarioTag << "," << scenarioStartTimeTag << "," << row
+                << "\n";
+        }
+        out.flags(ffo.FlagsAfter);
+        out.precision(ffo.PrecisionAfter);
+        out.flush();
+    }
 
-        for (auto& next_taf : results)
+    std::optional<ResampleMode>
+    TagToResampleMode(std::string const& tag)
+    {
+        if (tag == "sample")
+        {
+            return ResampleMode::Sample;
+        }
+        if (tag == "mean")
         {
+            return ResampleMode::Mean;
+        }
+        if (tag == "energy")
+        {
+            return ResampleMode::Energy;
+        }
+        if (tag == "max")
+        {
+            return ResampleMode::Max;
+        }
+        return {};
+    }
 
-            double t_next_report_s = t_prev_report_s + T_report_s;
-            while (t_next_report_s <= next_taf.Time)
+    std::string
+    ResampleModeToTag(ResampleMode mode)
+    {
+        switch (mode)
+        {
+            case ResampleMode::Sample:
+            {
+                return "sample";
+            }
+            case ResampleMode::Mean:
+            {
+                return "mean";
+            }
+            case ResampleMode::Energy:
+            {
+                return "energy";
+            }
+            case ResampleMode::Max:
             {
+                return "max";
+            }
+        }
+        WriteErrorMessage("ResampleModeToTag", "unhandled resample mode");
+        std::exit(1);
+    }
+
+    UniformTimeStepResampler
+    UniformTimeStepResampler_Create(double time_step_h, ResampleMode mode)
+    {
+        UniformTimeStepResampler resampler{};
+        resampler.Mode = mode;
+        resampler.TimeStep_s = 3600.0 * time_step_h;
+        return resampler;
+    }
+
+    void
+    UniformTimeStepResampler_Reset(UniformTimeStepResampler& resampler)
+    {
+        resampler.HasPrevious = false;
+        resampler.LastReport_s = 0.0;
+        resampler.Cursor_s = 0.0;
+    }
+
+    // NOTE: an unlimited flow makes its integral unlimited
+    static double
+    IntegrateFlow(flow_t flow_W, double dt_s)
+    {
+        return flow_W == max_flow_W ? std::numeric_limits<double>::infinity()
+                                    : static_cast<double>(flow_W) * dt_s;
+    }
 
-                auto mod_taf = taf;
-                if (t_next_report_s == next_taf.Time)
-                    mod_taf.Flows = next_taf.Flows;
+    static flow_t
+    IntegralToFlow(double value)
+    {
+        return std::isinf(value) ? max_flow_W
+                                 : static_cast<flow_t>(std::round(value));
+    }
 
-                mod_taf.Time = t_next_report_s;
-                double dt_orig_s = next_taf.Time - taf.Time;
-                if (dt_orig_s > 0.0)
+    // adds the previous flows over the time from the cursor to time_s
+    static void
+    UniformTimeStepResampler_Accumulate(
+        UniformTimeStepResampler& r,
+        double time_s
+    )
+    {
+        double dt_s = time_s - r.Cursor_s;
+        r.Cursor_s = time_s;
+        if (dt_s <= 0.0 || r.Mode == ResampleMode::Sample)
+        {
+            return;
+        }
+        std::vector<Flow> const& flows = r.Previous.Flows;
+        for (size_t i = 0; i < flows.size(); ++i)
+        {
+            if (r.Mode == ResampleMode::Max)
+            {
+                Flow& m = r.Maxima[i];
+                m.Requested_W = std::max(m.Requested_W, flows[i].Requested_W);
+                m.Available_W = std::max(m.Available_W, flows[i].Available_W);
+                m.Actual_W = std::max(m.Actual_W, flows[i].Actual_W);
+                continue;
+            }
+            FlowIntegral& f = r.Integrals[i];
+            f.Requested_J += IntegrateFlow(flows[i].Requested_W, dt_s);
+            f.Available_J += IntegrateFlow(flows[i].Available_W, dt_s);
+            f.Actual_J += IntegrateFlow(flows[i].Actual_W, dt_s);
+        }
+    }
+
+    // sets the report flows for the interval ending at report_s and starts
+    // the next interval
+    static void
+    UniformTimeStepResampler_SetReportFlows(
+        UniformTimeStepResampler& r,
+        double report_s,
+        double time_s,
+        std::vector<Flow> const& flows
+    )
+    {
+        size_t const numFlows = r.Previous.Flows.size();
+        switch (r.Mode)
+        {
+            case ResampleMode::Sample:
+            {
+                r.Report.Flows = report_s == time_s ? flows : r.Previous.Flows;
+            }
+            break;
+            case ResampleMode::Mean:
+            case ResampleMode::Energy:
+            {
+                double scale = r.Mode == ResampleMode::Mean
+                    ? 1.0 / (report_s - r.LastReport_s)
+                    : 1.0;
+                r.Report.Flows.resize(numFlows);
+                for (size_t i = 0; i < numFlows; ++i)
                 {
-                    double dt_s = t_next_report_s - taf.Time;
-                    double time_frac = dt_s / dt_orig_s;
-                    for (std::size_t i = 0; i < num_stored; ++i)
-                    {
-                        mod_taf.StorageAmounts_J[i] = static_cast<flow_t>(
-                            (1. - time_frac) * taf.StorageAmounts_J[i]
-                            + time_frac * next_taf.StorageAmounts_J[i]
-                        );
-                    }
+                    FlowIntegral const& f = r.Integrals[i];
+                    r.Report.Flows[i].Requested_W =
+                        IntegralToFlow(f.Requested_J * scale);
+                    r.Report.Flows[i].Available_W =
+                        IntegralToFlow(f.Available_J * scale);
+                    r.Report.Flows[i].Actual_W =
+                        IntegralToFlow(f.Actual_J * scale);
                 }
-                modified_results.push_back(mod_taf);
+                r.Integrals.assign(numFlows, FlowIntegral{});
+            }
+            break;
+            case ResampleMode::Max:
+            {
+                r.Report.Flows = r.Maxima;
+                r.Maxima.assign(numFlows, Flow{});
+            }
+            break;
+        }
+    }
 
-                t_prev_report_s = t_next_report_s;
-                t_next_report_s += T_report_s;
+    void
+    UniformTimeStepResampler_Push(
+        UniformTimeStepResampler& r,
+        double time_s,
+        std::vector<Flow> const& flows,
+        std::vector<flow_t> const& storageAmounts_J,
+        std::function<void(TimeAndFlows const&)> const& emit
+    )
+    {
+        if (!r.HasPrevious)
+        {
+            r.HasPrevious = true;
+            r.Previous.Time = time_s;
+            r.Previous.Flows = flows;
+            r.Previous.StorageAmounts_J = storageAmounts_J;
+            r.Cursor_s = time_s;
+            r.Integrals.assign(flows.size(), FlowIntegral{});
+            r.Maxima.assign(flows.size(), Flow{});
+            r.Report.Time = time_s;
+            r.Report.Flows = r.Mode == ResampleMode::Energy
+                ? std::vector<Flow>(flows.size(), Flow{})
+                : flows;
+            r.Report.StorageAmounts_J = storageAmounts_J;
+            emit(r.Report);
+        }
+        TimeAndFlows const& prev = r.Previous;
+        size_t const numStored = prev.StorageAmounts_J.size();
+        double nextReport_s = r.LastReport_s + r.TimeStep_s;
+        while (nextReport_s <= time_s)
+        {
+            UniformTimeStepResampler_Accumulate(r, nextReport_s);
+            UniformTimeStepResampler_SetReportFlows(
+                r, nextReport_s, time_s, flows
+            );
+            r.Report.Time = nextReport_s;
+            r.Report.StorageAmounts_J = prev.StorageAmounts_J;
+            double dt_orig_s = time_s - prev.Time;
+            if (dt_orig_s > 0.0)
+            {
+                double time_frac = (nextReport_s - prev.Time) / dt_orig_s;
+                for (size_t i = 0; i < numStored; ++i)
+                {
+                    r.Report.StorageAmounts_J[i] = static_cast<flow_t>(
+                        (1. - time_frac) * prev.StorageAmounts_J[i]
+                        + time_frac * storageAmounts_J[i]
+                    );
+                }
             }
-            taf = next_taf;
+            emit(r.Report);
+            r.LastReport_s = nextReport_s;
+            nextReport_s += r.TimeStep_s;
+        }
+        UniformTimeStepResampler_Accumulate(r, time_s);
+        r.Previous.Time = time_s;
+        r.Previous.Flows = flows;
+        r.Previous.StorageAmounts_J = storageAmounts_J;
+    }
+
+    std::vector<TimeAndFlows>
+    ApplyUniformTimeStep(
+        std::vector<TimeAndFlows> const& results,
+        double const time_step_h,
+        ResampleMode mode
+    )
+    {
+        if (results.empty() || time_step_h <= 0.0)
+        {
+            return results;
+        }
+        UniformTimeStepResampler resampler =
+            UniformTimeStepResampler_Create(time_step_h, mode);
+        std::vector<TimeAndFlows> modified_results;
+        for (TimeAndFlows const& taf : results)
+        {
+            UniformTimeStepResampler_Push(
+                resampler,
+                taf.Time,
+                taf.Flows,
+                taf.StorageAmounts_J,
+                [&](TimeAndFlows const& report)
+                { modified_results.push_back(report); }
+            );
         }
         return modified_results;
     }
@@ -3089,20 +3753,22 @@ namespace erin
         std::function<double()> const& randFn,
         DistributionSystem const& ds,
         double scenarioDuration_s,
-        double scenarioOffset_s
+        double scenarioOffset_s,
+        bool clipToScenario,
+        SampledRandom* sampledRandom
     )
     {
-        std::unordered_map<size_t, std::vector<TimeState>> relSchByCompFailId;
+        std::vector<std::vector<TimeState>> relSchByCompFailId;
         relSchByCompFailId.reserve(componentFailureModeComponentIds.size());
-        std::unordered_set<size_t> componentsWithFailures;
-        componentsWithFailures.reserve(componentFailureModeComponentIds.size());
+        std::unordered_map<size_t, std::vector<std::vector<TimeState> const*>>
+            relSchsByCompId;
+        relSchsByCompId.reserve(componentFailureModeComponentIds.size());
         for (size_t compFailId = 0;
              compFailId < componentFailureModeComponentIds.size();
              ++compFailId)
         {
             size_t fmId = componentFailureModeFailureModeIds[compFailId];
             size_t compId = componentFailureModeComponentIds[compFailId];
-            componentsWithFailures.insert(compId);
             double age_s = componentInitialAges_s[compId];
             // NOTE: Fix. ERIN is like the movie Groundhog's Day --
             // each "year" is repeated over and over again until the
@@ -3123,6 +3789,10 @@ namespace erin
             // (scenarioOffset + scenarioDuration). Offset will be from
             // the time the age is assessed.
             double endTime_s = age_s + scenarioOffset_s + scenarioDuration_s;
+            if (sampledRandom != nullptr)
+            {
+                SampledRandom_StartStream(*sampledRandom, compFailId);
+            }
             std::vector<TimeState> relSch =
                 rc.make_schedule_for_link(fmId, randFn, ds, endTime_s);
             for (auto& ts : relSch)
@@ -3132,23 +3802,46 @@ namespace erin
                     ts.failureModeCauses.insert(fmId);
                 }
             }
-            relSchByCompFailId.insert({compFailId, std::move(relSch)});
+            relSchByCompFailId.push_back(std::move(relSch));
+        }
+        // NOTE: pointers are taken only after relSchByCompFailId is complete
+        for (size_t compFailId = 0; compFailId < relSchByCompFailId.size();
+             ++compFailId)
+        {
+            size_t compId = componentFailureModeComponentIds[compFailId];
+            relSchsByCompId[compId].push_back(&relSchByCompFailId[compFailId]);
         }
-        // NOTE: combine reliability curves so they are per component
+        // NOTE: combine reliability curves so they are per component. All
+        // failure modes of a component are merged in a single pass, clipping
+        // to the scenario window along the way if requested.
         std::unordered_map<size_t, std::vector<TimeState>> relSchByCompId;
-        relSchByCompId.reserve(componentsWithFailures.size());
-        for (auto const& pair : relSchByCompFailId)
+        relSchByCompId.reserve(relSchsByCompId.size());
+        for (auto const& pair : relSchsByCompId)
         {
-            size_t compId = componentFailureModeComponentIds[pair.first];
-            if (relSchByCompId.contains(compId))
+            size_t compId = pair.first;
+            double age_s = componentInitialAges_s[compId];
+            double startTime_s = clipToScenario
+                ? age_s + scenarioOffset_s
+                : -std::numeric_limits<double>::infinity();
+            double endTime_s = clipToScenario
+                ? age_s + scenarioOffset_s + scenarioDuration_s
+                : std::numeric_limits<double>::infinity();
+            std::vector<TimeState>& relSch = relSchByCompId[compId];
+            if (pair.second.size() == 1 && !clipToScenario)
             {
-                std::vector<TimeState> combined =
-                    TimeState_Combine(pair.second, relSchByCompId.at(compId));
-                relSchByCompId[compId] = std::move(combined);
+                relSch = *pair.second[0];
+            }
+            else if (pair.second.size() == 1)
+            {
+                relSch = TimeState_Clip(
+                    *pair.second[0], startTime_s, endTime_s, true
+                );
             }
             else
             {
-                relSchByCompId[compId] = pair.second;
+                TimeState_MergeAndClip(
+                    pair.second, startTime_s, endTime_s, clipToScenario, relSch
+                );
             }
         }
         return relSchByCompId;
@@ -3274,7 +3967,204 @@ namespace erin
         return connsToReport;
     }
 
-    void
+    std::optional<ShardSpec>
+    ShardSpec_Parse(std::string const& text)
+    {
+        size_t slashIdx = text.find('/');
+        if (slashIdx == std::string::npos || slashIdx == 0
+            || slashIdx + 1 == text.size())
+        {
+            return {};
+        }
+        std::string indexText = text.substr(0, slashIdx);
+        std::string countText = text.substr(slashIdx + 1);
+        auto isDigit = [](char c) { return c >= '0' && c <= '9'; };
+        if (!std::all_of(indexText.begin(), indexText.end(), isDigit)
+            || !std::all_of(countText.begin(), countText.end(), isDigit))
+        {
+            return {};
+        }
+        ShardSpec shard{};
+        try
+        {
+            shard.Index = static_cast<size_t>(std::stoull(indexText));
+            shard.Count = static_cast<size_t>(std::stoull(countText));
+        }
+        catch (std::out_of_range const&)
+        {
+            return {};
+        }
+        if (shard.Index == 0 || shard.Index > shard.Count)
+        {
+            return {};
+        }
+        return shard;
+    }
+
+    std::pair<size_t, size_t>
+    ShardSpec_PairRange(ShardSpec const& shard, size_t numPairs)
+    {
+        assert(shard.Index >= 1 && shard.Index <= shard.Count);
+        // NOTE: sizes differ by at most one; the larger blocks come last
+        size_t first = ((shard.Index - 1) * numPairs) / shard.Count;
+        size_t last = (shard.Index * numPairs) / shard.Count;
+        return {first, last};
+    }
+
+    std::string
+    ShardSpec_FilePath(std::string const& path, ShardSpec const& shard)
+    {
+        if (shard.Count == 1)
+        {
+            return path;
+        }
+        std::filesystem::path p{path};
+        std::string name = fmt::format(
+            "{}.shard-{}-of-{}{}",
+            p.stem().string(),
+            shard.Index,
+            shard.Count,
+            p.extension().string()
+        );
+        return p.replace_filename(name).string();
+    }
+
+    std::vector<TimeAndAmount>
+    AmountSchedule_Coarsen(
+        AmountSchedule const& schedule,
+        double window_s,
+        ResampleMode mode
+    )
+    {
+        assert(mode == ResampleMode::Mean || mode == ResampleMode::Max);
+        assert(window_s > 0.0);
+        size_t numEntries = AmountSchedule_Size(schedule);
+        std::vector<TimeAndAmount> coarse{};
+        if (numEntries == 0)
+        {
+            return coarse;
+        }
+        double lastTime_s = AmountSchedule_TimeAt(schedule, numEntries - 1);
+        size_t numWindows = static_cast<size_t>(
+            std::ceil(std::max(lastTime_s, 0.0) / window_s)
+        );
+        coarse.reserve(numWindows + 1);
+        // NOTE: index of the first entry after the current time; the amount
+        // before the first entry is 0
+        size_t next = 0;
+        for (size_t window = 0; window < numWindows; ++window)
+        {
+            double start_s = static_cast<double>(window) * window_s;
+            double end_s = start_s + window_s;
+            while (next < numEntries
+                   && AmountSchedule_TimeAt(schedule, next) <= start_s)
+            {
+                ++next;
+            }
+            flow_t amount_W =
+                next == 0 ? 0 : AmountSchedule_AmountAt(schedule, next - 1);
+            flow_t max_W = amount_W;
+            double energy_J = 0.0;
+            double time_s = start_s;
+            while (next < numEntries
+                   && AmountSchedule_TimeAt(schedule, next) < end_s)
+            {
+                double nextTime_s = AmountSchedule_TimeAt(schedule, next);
+                energy_J +=
+                    static_cast<double>(amount_W) * (nextTime_s - time_s);
+                time_s = nextTime_s;
+                amount_W = AmountSchedule_AmountAt(schedule, next);
+                max_W = std::max(max_W, amount_W);
+                ++next;
+            }
+            energy_J += static_cast<double>(amount_W) * (end_s - time_s);
+            flow_t windowAmount_W = mode == ResampleMode::Max
+                ? max_W
+                : static_cast<flow_t>(std::llround(energy_J / window_s));
+            coarse.push_back({start_s, windowAmount_W});
+        }
+        coarse.push_back(
+            {static_cast<double>(numWindows) * window_s,
+             AmountSchedule_AmountAt(schedule, numEntries - 1)}
+        );
+        return coarse;
+    }
+
+    ScheduleCoarsening
+    Simulation_CoarsenSchedules(
+        Simulation& s,
+        double window_h,
+        ResampleMode mode
+    )
+    {
+        ScheduleCoarsening result{};
+        double window_s = window_h * seconds_per_hour;
+        for (AmountSchedule& schedule : s.LoadMap.Loads)
+        {
+            size_t numEntries = AmountSchedule_Size(schedule);
+            result.NumEntries += numEntries;
+            std::vector<TimeAndAmount> coarse =
+                AmountSchedule_Coarsen(schedule, window_s, mode);
+            if (coarse.size() < numEntries)
+            {
+                result.NumCoarseEntries += coarse.size();
+                schedule = AmountSchedule_Make(std::move(coarse));
+            }
+            else
+            {
+                result.NumCoarseEntries += numEntries;
+            }
+        }
+        return result;
+    }
+
+    ScheduleCompaction
+    Simulation_CompactSchedules(Simulation& s)
+    {
+        ScheduleCompaction result{};
+        for (AmountSchedule& schedule : s.LoadMap.Loads)
+        {
+            std::vector<TimeAndAmount> entries =
+                AmountSchedule_ToEntries(schedule);
+            size_t numEntries = entries.size();
+            result.NumEntries += numEntries;
+            size_t numRemoved = TimeAndAmount_Compact(entries);
+            if (numRemoved == 0)
+            {
+                continue;
+            }
+            // NOTE: compacted entries are no longer uniformly spaced; a
+            // uniform-step schedule is only replaced if its time and amount
+            // pairs take no more memory than its amounts
+            if (AmountSchedule_IsUniform(schedule)
+                && entries.size() * sizeof(TimeAndAmount)
+                    > numEntries * sizeof(flow_t))
+            {
+                ++result.NumUniformSchedulesKept;
+                continue;
+            }
+            result.NumEntriesRemoved += numRemoved;
+            schedule = AmountSchedule_Make(std::move(entries));
+        }
+        return result;
+    }
+
+    size_t
+    Simulation_ReduceModel(Simulation& s)
+    {
+        std::unordered_set<size_t> mayFailCompIds{
+            s.ComponentFailureModes.ComponentIds.begin(),
+            s.ComponentFailureModes.ComponentIds.end()
+        };
+        mayFailCompIds.insert(
+            s.ComponentFragilities.ComponentIds.begin(),
+            s.ComponentFragilities.ComponentIds.end()
+        );
+        return Model_Reduce(s.TheModel, mayFailCompIds)
+            + Model_MergeLoads(s.TheModel, mayFailCompIds);
+    }
+
+    SimulationRunMetrics
     Simulation_Run(
         Simulation& s,
         Log& log,
@@ -3283,9 +4173,13 @@ namespace erin
         double time_step_h /*-1.0*/,
         bool aggregateGroups,
         bool saveReliabilityCurves,
-        bool verbose
+        bool verbose,
+        std::optional<ShardSpec> const& shard,
+        ResampleMode resampleMode,
+        bool changesOnly
     )
     {
+        SimulationRunMetrics metrics{};
         // TODO: wrap into input options struct and pass in
         bool const checkNetwork = false;
         if (checkNetwork)
@@ -3342,6 +4236,52 @@ namespace erin
             }
             break;
         }
+        // NOTE: a seeded run draws each occurrence from its own stream
+        // seeded by (seed, scenario, occurrence) so that results do not
+        // depend on whether or how the occurrences are split into shards
+        bool const isSharded = shard.has_value();
+        if (isSharded)
+        {
+            if (s.Info.TypeOfRandom != RandomType::RandomFromSeed
+                && s.Info.TypeOfRandom != RandomType::FixedRandom)
+            {
+                Log_Error(
+                    log,
+                    "shard",
+                    "sharded runs require a random seed or a fixed random "
+                    "value"
+                );
+                return metrics;
+            }
+            if (s.Info.ConvergenceMetrics.size() > 0)
+            {
+                Log_Error(
+                    log, "shard", "sharded runs do not support convergence"
+                );
+                return metrics;
+            }
+            if (s.Info.Sampling != SamplingType::Independent)
+            {
+                Log_Error(
+                    log,
+                    "shard",
+                    "sharded runs only support independent sampling"
+                );
+                return metrics;
+            }
+        }
+        bool const writePartialFiles = isSharded && shard->Count > 1;
+        // NOTE: occurrence times are always drawn independently; sampling
+        // only shapes the draws made within each occurrence
+        SampledRandom sampledRandom{};
+        sampledRandom.Type = s.Info.Sampling;
+        sampledRandom.Base = [&s]() { return s.TheModel.RandFn(); };
+        std::function<double()> sampledRandFn = std::ref(sampledRandom);
+        bool const useSampling = s.Info.Sampling != SamplingType::Independent;
+        std::function<double()>& occurrenceRandFn =
+            useSampling ? sampledRandFn : s.TheModel.RandFn;
+        bool const useImportanceSampling =
+            s.Info.FragilityImportanceFactor > 1.0;
         // TODO: expose proper options
         // TODO: check the components and network:
         // -- that all components are hooked up to something
@@ -3376,16 +4316,22 @@ namespace erin
         // IDEA: use Apache Arrow for memory tables? Output parquet as primary
         // output format (instead of CSV)?
         // NOW, we want to do a simulation for each scenario
+        std::string const eventsPath = isSharded
+            ? ShardSpec_FilePath(eventsFilename, *shard)
+            : eventsFilename;
+        std::string const statsPath = isSharded
+            ? ShardSpec_FilePath(statsFilename, *shard)
+            : statsFilename;
         std::ofstream out;
-        out.open(eventsFilename);
+        out.open(eventsPath);
         if (!out.good())
         {
             Log_Warning(
                 log,
                 "file I/O",
-                fmt::format("Could not open '{}' for writing", eventsFilename)
+                fmt::format("Could not open '{}' for writing", eventsPath)
             );
-            return;
+            return metrics;
         }
 
         // TODO: need to account for WASTE component
@@ -3407,6 +4353,10 @@ namespace erin
             RemoveNonReportingIds(compOrder, compsToReport);
 
         auto nodeConnections = GetNodeConnections(s, aggregateGroups);
+        UniformTimeStepResampler resampler =
+            UniformTimeStepResampler_Create(time_step_h, resampleMode);
+        UniformTimeStepResampler* const resamplerOrNull =
+            time_step_h > 0.0 ? &resampler : nullptr;
         std::vector<size_t> nodeConnOrder =
             CalculateNodeConnectionOrder(s, nodeConnections, aggregateGroups);
         std::unordered_set<size_t> nodeConnsToReport{};
@@ -3421,6 +4371,17 @@ namespace erin
         }
         std::vector<size_t> nodeConnOrderForEvents =
             RemoveNonReportingIds(nodeConnOrder, nodeConnsToReport);
+        // NOTE: only the flows and stores written to the event file are
+        // kept per event; statistics are accumulated from the full state
+        GroupAggregation const fullAggregation =
+            GroupAggregation_Create(nodeConnections);
+        ResultProjection projection{};
+        projection.ConnIds = GroupAggregation_ConnectionsOf(
+            fullAggregation, nodeConnOrderForEvents
+        );
+        projection.StoreIdxs = storeOrderForEvents;
+        GroupAggregation const aggregation =
+            GroupAggregation_Project(fullAggregation, projection);
 
         WriteEventFileHeader(
             out,
@@ -3431,9 +4392,37 @@ namespace erin
             compOrderForEvents,
             outputTimeUnit,
             nodeConnections,
-            aggregateGroups
+            aggregateGroups,
+            time_step_h > 0.0 && resampleMode == ResampleMode::Energy ? "kJ"
+                                                                       : "kW"
         );
+        // NOTE: occurrence times come from the distribution system's own
+        // generator, so drawing them all up front gives every shard the
+        // same (scenario, occurrence) pairs
+        std::vector<std::vector<double>> occurrenceTimesByScenario(
+            s.ScenarioMap.Tags.size()
+        );
+        size_t numPairs = 0;
+        for (size_t scenIdx : scenarioOrder)
+        {
+            occurrenceTimesByScenario[scenIdx] =
+                DetermineScenarioOccurrenceTimes(s, scenIdx);
+            numPairs += occurrenceTimesByScenario[scenIdx].size();
+        }
+        auto const [firstPair, lastPair] = isSharded
+            ? ShardSpec_PairRange(*shard, numPairs)
+            : std::pair<size_t, size_t>{0, numPairs};
+        // NOTE: rows written before this shard's would have left the
+        // stream formatting storage amounts fixed-point
+        if (firstPair > 0 && storeOrderForEvents.size() > 0)
+        {
+            out << std::fixed << std::setprecision(eventFileStorePrecision);
+        }
+        size_t scenarioFirstPair = 0;
         std::vector<ScenarioOccurrenceStats> occurrenceStats;
+        std::vector<ScenarioConvergenceStats> convergenceStats;
+        double const convergenceZScore =
+            ConfidenceLevelToZScore(s.Info.ConfidenceLevel);
         for (size_t scenIdx : scenarioOrder)
         {
             double scenarioDuration_s = Time_ToSeconds(
@@ -3443,6 +4432,13 @@ namespace erin
             double scenarioOffset_s =
                 s.ScenarioMap.TimeOffsetsInSeconds[scenIdx];
             std::string const& scenarioTag = s.ScenarioMap.Tags[scenIdx];
+            TraceSpan scenarioSpan{"scenario", "Simulation_Run"};
+            if (scenarioSpan.Active)
+            {
+                scenarioSpan.Args = fmt::format(
+                    "\"scenario\": {}", Trace_JsonString(scenarioTag)
+                );
+            }
             if (verbose)
             {
                 Log_Info(log, "Scenario", scenarioTag);
@@ -3455,21 +4451,34 @@ namespace erin
                 == Result::Failure)
             {
                 Log_Warning(log, "", "Issue setting schedule loads");
-                return;
+                return metrics;
             }
+            Model_MergeLoadSchedules(s.TheModel);
             if (SetSupplyForScenario(
                     s.TheModel.ScheduledSrcs, s.LoadMap, scenIdx
                 )
                 == Result::Failure)
             {
                 Log_Warning(log, "", "Issue setting schedule sources");
-                return;
+                return metrics;
             }
             // TODO: implement load substitution for schedule-based sources
             // for (size_t sbsIdx = 0; sbsIdx < s.Model.ScheduleSrcs.size();
             // ++sbsIdx) {/* ... */}
-            std::vector<double> occurrenceTimes_s =
-                DetermineScenarioOccurrenceTimes(s, scenIdx);
+            std::vector<double> const& occurrenceTimes_s =
+                occurrenceTimesByScenario[scenIdx];
+            size_t const scenarioEndPair =
+                scenarioFirstPair + occurrenceTimes_s.size();
+            size_t const occBegin =
+                std::clamp(firstPair, scenarioFirstPair, scenarioEndPair)
+                - scenarioFirstPair;
+            size_t const occEnd =
+                std::clamp(lastPair, scenarioFirstPair, scenarioEndPair)
+                - scenarioFirstPair;
+            scenarioFirstPair = scenarioEndPair;
+            SampledRandom_StartScenario(
+                sampledRandom, occurrenceTimes_s.size()
+            );
             if (verbose)
             {
                 Log_Debug(
@@ -3485,23 +4494,57 @@ namespace erin
             // over all occurrences)
             std::unordered_map<size_t, double> intensityIdToAmount =
                 GetIntensitiesForScenario(s, scenIdx);
-            for (size_t occIdx = 0; occIdx < occurrenceTimes_s.size(); ++occIdx)
+            bool const useConvergence = s.Info.ConvergenceMetrics.size() > 0;
+            ScenarioConvergenceStats scs{};
+            scs.ScenarioId = scenIdx;
+            scs.MaxOccurrences = occurrenceTimes_s.size();
+            scs.MetricStats.resize(s.Info.ConvergenceMetrics.size());
+            FailureFreeOccurrence failureFree{};
+            BaselineSimulation baseline{};
+            baseline.SnapshotInterval_s =
+                scenarioDuration_s / baselineSnapshotsPerScenario;
+            baseline.Projection = &projection;
+            for (size_t occIdx = occBegin; occIdx < occEnd; ++occIdx)
             {
+                TraceSpan occurrenceSpan{"occurrence", "Simulation_Run"};
+                if (occurrenceSpan.Active)
+                {
+                    occurrenceSpan.Args = fmt::format(
+                        "\"scenario\": {}, \"occurrence\": {}",
+                        Trace_JsonString(scenarioTag),
+                        occIdx + 1
+                    );
+                }
                 if (verbose)
                 {
                     Log_Debug(log, fmt::format("... Occurrence #{}", occIdx));
                 }
+                if (s.Info.TypeOfRandom == RandomType::RandomFromSeed)
+                {
+                    fullRandom = CreateRandomWithSeed(
+                        DeriveSeed(s.Info.Seed, scenIdx, occIdx)
+                    );
+                    s.TheModel.RandFn = fullRandom;
+                }
+                Profile_BeginOccurrence(scenarioTag, occIdx + 1);
+                SampledRandom_StartOccurrence(sampledRandom, occIdx);
                 std::unordered_map<size_t, std::vector<TimeState>>
+                    relSchByCompId;
+                {
+                    ProfileTimer timer{ProfilePhase::CreateFailureSchedules};
                     relSchByCompId = CreateFailureSchedules(
                         s.ComponentFailureModes.ComponentIds,
                         s.ComponentFailureModes.FailureModeIds,
                         s.TheModel.ComponentMap.InitialAges_s,
                         s.TheModel.Rel,
-                        s.TheModel.RandFn,
+                        occurrenceRandFn,
                         s.TheModel.DistSys,
                         scenarioDuration_s,
-                        scenarioOffset_s
+                        scenarioOffset_s,
+                        true,
+                        useSampling ? &sampledRandom : nullptr
                     );
+                }
                 if (verbose)
                 {
                     Log_Info(log, "Generating reliability schedules");
@@ -3554,28 +4597,37 @@ namespace erin
                     );
                 }
                 s.TheModel.Reliabilities.clear();
-                s.TheModel.Reliabilities = ApplyReliabilitiesAndFragilities(
-                    s.TheModel.RandFn,
-                    s.ComponentFailureModes.ComponentIds,
-                    s.TheModel.ComponentMap.InitialAges_s,
-                    s.TheModel.ComponentMap.Tag,
-                    s.ComponentFragilities.ComponentIds,
-                    s.ComponentFragilities.FragilityModeIds,
-                    s.FragilityModes.FragilityCurveId,
-                    s.FragilityModes.RepairDistIds,
-                    s.FragilityModes.Tags,
-                    s.FragilityCurves.CurveId,
-                    s.FragilityCurves.CurveTypes,
-                    s.LinearFragilityCurves,
-                    s.TabularFragilityCurves,
-                    s.TheModel.DistSys,
-                    scenarioOffset_s,
-                    scenarioOffset_s + scenarioDuration_s,
-                    intensityIdToAmount,
-                    relSchByCompId,
-                    verbose,
-                    log
-                );
+                double weight = 1.0;
+                {
+                    ProfileTimer timer{ProfilePhase::ApplyReliabilities};
+                    s.TheModel.Reliabilities =
+                        ApplyReliabilitiesAndFragilities(
+                            occurrenceRandFn,
+                            s.ComponentFailureModes.ComponentIds,
+                            s.TheModel.ComponentMap.InitialAges_s,
+                            s.TheModel.ComponentMap.Tag,
+                            s.ComponentFragilities.ComponentIds,
+                            s.ComponentFragilities.FragilityModeIds,
+                            s.FragilityModes.FragilityCurveId,
+                            s.FragilityModes.RepairDistIds,
+                            s.FragilityModes.Tags,
+                            s.FragilityCurves.CurveId,
+                            s.FragilityCurves.CurveTypes,
+                            s.LinearFragilityCurves,
+                            s.TabularFragilityCurves,
+                            s.TheModel.DistSys,
+                            scenarioOffset_s,
+                            scenarioOffset_s + scenarioDuration_s,
+                            intensityIdToAmount,
+                            relSchByCompId,
+                            verbose,
+                            log,
+                            true,
+                            s.Info.FragilityImportanceFactor,
+                            &weight,
+                            useSampling ? &sampledRandom : nullptr
+                        );
+                }
                 if (verbose)
                 {
                     Log_Info(
@@ -3597,6 +4649,7 @@ namespace erin
                     {
                         Log_Debug(log, "Writing reliability curves...");
                     }
+                    ProfileTimer timer{ProfilePhase::Write};
                     WriteReliabilityCurves(
                         s.ScenarioMap.Tags[scenIdx], occIdx, s
                     );
@@ -3632,40 +4685,175 @@ namespace erin
                 // TODO: add an optional verbosity flag to SimInfo
                 // -- use that to set things like the print flag below
 
-                auto results = Simulate(s.TheModel, verbose, true, log);
+                // NOTE: without failures the scenario is deterministic, so
+                // an occurrence whose reliability schedules match those of
+                // the cached failure-free occurrence reuses its results
+                bool const isFailureFree =
+                    Reliabilities_AreFailureFree(s.TheModel.Reliabilities);
+                bool const reuseFailureFree = isFailureFree
+                    && failureFree.IsSet
+                    && Reliabilities_AreEqual(
+                        s.TheModel.Reliabilities, failureFree.Reliabilities
+                    );
+                ScenarioOccurrenceStats sos{};
+                if (reuseFailureFree)
                 {
-                    auto* output_results = &results;
-                    std::vector<TimeAndFlows> modified_results0 = {};
-                    if (time_step_h > 0.0)
+                    if (verbose)
                     {
-                        modified_results0 =
-                            ApplyUniformTimeStep(results, time_step_h);
-                        output_results = &modified_results0;
+                        Log_Info(
+                            log, "Reusing failure-free occurrence results"
+                        );
                     }
-
-                    std::vector<TimeAndFlows> modified_results1 =
-                        *output_results;
-                    AggregateGroups(modified_results1, nodeConnections);
-                    output_results = &modified_results1;
-
-                    // TODO: investigate putting output on another thread
-                    WriteResultsToEventFile(
+                    ProfileTimer timer{ProfilePhase::Write};
+                    WriteFailureFreeOccurrenceToEventFile(
                         out,
-                        *output_results,
+                        failureFree,
                         s,
                         scenarioTag,
                         scenarioStartTimeTag,
                         nodeConnOrderForEvents,
                         storeOrderForEvents,
                         compOrderForEvents,
-                        outputTimeUnit
+                        outputTimeUnit,
+                        aggregation,
+                        resamplerOrNull,
+                        changesOnly,
+                        &projection
                     );
+                    sos = failureFree.Stats;
+                    sos.OccurrenceNumber = occIdx + 1;
+                    metrics.EventsSimulated += failureFree.NumEvents;
                 }
-                ScenarioOccurrenceStats sos =
-                    ModelResults_CalculateScenarioOccurrenceStats(
-                        scenIdx, occIdx + 1, s.TheModel, s.FlowTypeMap, results
-                    );
+                else
+                {
+                    // NOTE: until the first reliability event the
+                    // occurrence matches the failure-free baseline, so
+                    // resume from the latest baseline snapshot before it
+                    std::vector<TimeAndFlows> results;
+                    OccurrenceStatsAccumulator stats{};
+                    ResultCapture const capture{
+                        .Projection = &projection,
+                        .Stats = &stats,
+                    };
+                    {
+                        ProfileTimer timer{ProfilePhase::Simulate};
+                        SimulationSnapshot const* snapshot = nullptr;
+                        double firstEvent_s = Reliabilities_FirstEventTime(
+                            s.TheModel.Reliabilities
+                        );
+                        if (!verbose
+                            && (firstEvent_s == infinity || firstEvent_s > 0.0))
+                        {
+                            BaselineSimulation_AdvanceTo(
+                                baseline, s.TheModel, firstEvent_s, true, log
+                            );
+                            snapshot = BaselineSimulation_FindSnapshot(
+                                baseline, firstEvent_s
+                            );
+                        }
+                        results = snapshot != nullptr
+                            ? Simulate_FromSnapshot(
+                                  s.TheModel,
+                                  *snapshot,
+                                  baseline.Results,
+                                  verbose,
+                                  true,
+                                  log,
+                                  capture
+                              )
+                            : Simulate(
+                                  s.TheModel, verbose, true, log, capture
+                              );
+                    }
+                    {
+                        // TODO: investigate putting output on another thread
+                        ProfileTimer timer{ProfilePhase::Write};
+                        WriteResultsToEventFile(
+                            out,
+                            results,
+                            s,
+                            scenarioTag,
+                            scenarioStartTimeTag,
+                            nodeConnOrderForEvents,
+                            storeOrderForEvents,
+                            compOrderForEvents,
+                            outputTimeUnit,
+                            &aggregation,
+                            resamplerOrNull,
+                            changesOnly,
+                            &projection
+                        );
+                    }
+                    {
+                        ProfileTimer timer{ProfilePhase::Stats};
+                        sos = OccurrenceStatsAccumulator_Finish(
+                            stats,
+                            scenIdx,
+                            occIdx + 1,
+                            s.TheModel,
+                            s.FlowTypeMap
+                        );
+                    }
+                    metrics.EventsSimulated += results.size();
+                    if (isFailureFree && !failureFree.IsSet)
+                    {
+                        failureFree.IsSet = true;
+                        failureFree.Reliabilities = s.TheModel.Reliabilities;
+                        failureFree.NumEvents = results.size();
+                        failureFree.EventResults = std::move(results);
+                        failureFree.Stats = sos;
+                        failureFree.EventRows.clear();
+                    }
+                }
+                sos.Weight = weight;
+                if (useConvergence)
+                {
+                    bool allConverged = true;
+                    for (size_t i = 0; i < s.Info.ConvergenceMetrics.size();
+                         ++i)
+                    {
+                        // NOTE: under importance sampling the weighted
+                        // values are what average to the true mean
+                        double value = ScenarioOccurrenceStats_GetMetric(
+                            sos, s.Info.ConvergenceMetrics[i]
+                        );
+                        StreamingStats_Add(
+                            scs.MetricStats[i],
+                            useImportanceSampling ? weight * value : value
+                        );
+                        if (!StreamingStats_IsConverged(
+                                scs.MetricStats[i],
+                                convergenceZScore,
+                                s.Info.ConvergenceTolerances[i]
+                            ))
+                        {
+                            allConverged = false;
+                        }
+                    }
+                    scs.NumOccurrences = occIdx + 1;
+                    scs.IsConverged = allConverged
+                        && scs.NumOccurrences >= s.Info.MinOccurrences;
+                }
+                ++metrics.OccurrencesSimulated;
+                Profile_EndOccurrence();
                 occurrenceStats.push_back(std::move(sos));
+                if (scs.IsConverged)
+                {
+                    Log_Info(
+                        log,
+                        fmt::format(
+                            "Scenario {} converged after {} of {} occurrences",
+                            scenarioTag,
+                            scs.NumOccurrences,
+                            scs.MaxOccurrences
+                        )
+                    );
+                    break;
+                }
+            }
+            if (useConvergence)
+            {
+                convergenceStats.push_back(std::move(scs));
             }
             if (verbose)
             {
@@ -3675,8 +4863,264 @@ namespace erin
             // scenario
         }
         out.close();
+        ProfileTimer writeStatsTimer{ProfilePhase::Write};
         WriteStatisticsToFile(
-            s, statsFilename, occurrenceStats, compOrder, failOrder, fragOrder
+            s,
+            statsPath,
+            occurrenceStats,
+            compOrder,
+            failOrder,
+            fragOrder,
+            convergenceStats,
+            writePartialFiles
         );
+        return metrics;
+    }
+
+    static std::vector<std::string>
+    SplitCsvLine(std::string const& line)
+    {
+        std::vector<std::string> fields;
+        size_t start = 0;
+        while (true)
+        {
+            size_t end = line.find(',', start);
+            if (end == std::string::npos)
+            {
+                fields.push_back(line.substr(start));
+                break;
+            }
+            fields.push_back(line.substr(start, end - start));
+            start = end + 1;
+        }
+        return fields;
+    }
+
+    static Result
+    MergeShardEventFiles(
+        std::string const& eventsFilename,
+        size_t numShards,
+        Log& log
+    )
+    {
+        std::ofstream out{eventsFilename};
+        if (!out.good())
+        {
+            Log_Error(
+                log,
+                "merge",
+                fmt::format("Could not open '{}' for writing", eventsFilename)
+            );
+            return Result::Failure;
+        }
+        // NOTE: shards hold contiguous blocks of rows in output order, so
+        // the merged file is the header followed by each shard's rows
+        std::string header;
+        for (size_t idx = 1; idx <= numShards; ++idx)
+        {
+            std::string path = ShardSpec_FilePath(
+                eventsFilename, ShardSpec{.Index = idx, .Count = numShards}
+            );
+            std::ifstream in{path};
+            std::string shardHeader;
+            if (!in.good() || !std::getline(in, shardHeader))
+            {
+                Log_Error(
+                    log, "merge", fmt::format("Could not read '{}'", path)
+                );
+                return Result::Failure;
+            }
+            if (idx == 1)
+            {
+                header = shardHeader;
+                out << header << "\n";
+            }
+            else if (shardHeader != header)
+            {
+                Log_Error(
+                    log,
+                    "merge",
+                    fmt::format("'{}' has a different header", path)
+                );
+                return Result::Failure;
+            }
+            if (in.peek() != std::ifstream::traits_type::eof())
+            {
+                out << in.rdbuf();
+            }
+        }
+        return Result::Success;
+    }
+
+    static Result
+    MergeShardStatisticsFiles(
+        std::string const& statsFilename,
+        size_t numShards,
+        Log& log
+    )
+    {
+        std::string header;
+        std::vector<std::string> rows;
+        bool haveRows = false;
+        for (size_t idx = 1; idx <= numShards; ++idx)
+        {
+            std::string path = ShardSpec_FilePath(
+                statsFilename, ShardSpec{.Index = idx, .Count = numShards}
+            );
+            std::ifstream in{path};
+            std::string shardHeader;
+            if (!in.good() || !std::getline(in, shardHeader))
+            {
+                Log_Error(
+                    log, "merge", fmt::format("Could not read '{}'", path)
+                );
+                return Result::Failure;
+            }
+            std::vector<std::string> shardRows;
+            std::string row;
+            while (std::getline(in, row))
+            {
+                if (!row.empty())
+                {
+                    shardRows.push_back(std::move(row));
+                }
+            }
+            // NOTE: the flow columns are taken from a shard's first row, so
+            // a shard without rows can have a shorter header
+            if (shardRows.empty())
+            {
+                if (idx == 1)
+                {
+                    header = shardHeader;
+                }
+                continue;
+            }
+            if (!haveRows)
+            {
+                header = shardHeader;
+                haveRows = true;
+            }
+            else if (shardHeader != header)
+            {
+                Log_Error(
+                    log,
+                    "merge",
+                    fmt::format("'{}' has a different header", path)
+                );
+                return Result::Failure;
+            }
+            rows.insert(
+                rows.end(),
+                std::make_move_iterator(shardRows.begin()),
+                std::make_move_iterator(shardRows.end())
+            );
+        }
+        std::vector<std::string> columns = SplitCsvLine(header);
+        std::vector<std::vector<std::string>> table;
+        table.reserve(rows.size());
+        for (std::string const& row : rows)
+        {
+            table.push_back(SplitCsvLine(row));
+            if (table.back().size() != columns.size())
+            {
+                Log_Error(
+                    log,
+                    "merge",
+                    fmt::format(
+                        "statistics row has {} fields; expected {}",
+                        table.back().size(),
+                        columns.size()
+                    )
+                );
+                return Result::Failure;
+            }
+        }
+        // NOTE: the shards write a count and time fraction column for every
+        // component and linked mode; an unsplit run only writes those whose
+        // count is nonzero in some occurrence
+        std::string const countPrefix = "count: ";
+        std::string const timeFractionPrefix = "time fraction: ";
+        std::unordered_map<std::string, bool> occurredByPair;
+        for (size_t col = 0; col < columns.size(); ++col)
+        {
+            if (!columns[col].starts_with(countPrefix))
+            {
+                continue;
+            }
+            bool occurred = false;
+            for (auto const& fields : table)
+            {
+                if (fields[col] != "0")
+                {
+                    occurred = true;
+                    break;
+                }
+            }
+            occurredByPair[columns[col].substr(countPrefix.size())] = occurred;
+        }
+        std::vector<size_t> columnsToKeep;
+        columnsToKeep.reserve(columns.size());
+        for (size_t col = 0; col < columns.size(); ++col)
+        {
+            std::string const& name = columns[col];
+            std::string pair;
+            if (name.starts_with(countPrefix))
+            {
+                pair = name.substr(countPrefix.size());
+            }
+            else if (name.starts_with(timeFractionPrefix))
+            {
+                pair = name.substr(timeFractionPrefix.size());
+            }
+            if (pair.empty() || occurredByPair[pair])
+            {
+                columnsToKeep.push_back(col);
+            }
+        }
+        std::ofstream out{statsFilename};
+        if (!out.good())
+        {
+            Log_Error(
+                log,
+                "merge",
+                fmt::format("Could not open '{}' for writing", statsFilename)
+            );
+            return Result::Failure;
+        }
+        auto writeRow = [&](std::vector<std::string> const& fields)
+        {
+            for (size_t i = 0; i < columnsToKeep.size(); ++i)
+            {
+                out << (i == 0 ? "" : ",") << fields[columnsToKeep[i]];
+            }
+            out << "\n";
+        };
+        writeRow(columns);
+        for (auto const& fields : table)
+        {
+            writeRow(fields);
+        }
+        return Result::Success;
+    }
+
+    Result
+    Simulation_MergeShards(
+        std::string const& eventsFilename,
+        std::string const& statsFilename,
+        size_t numShards,
+        Log& log
+    )
+    {
+        if (numShards < 2)
+        {
+            Log_Error(log, "merge", "at least two shards are required");
+            return Result::Failure;
+        }
+        if (MergeShardEventFiles(eventsFilename, numShards, log)
+            == Result::Failure)
+        {
+            return Result::Failure;
+        }
+        return MergeShardStatisticsFiles(statsFilename, numShards, log);
     }
 } // namespace erin
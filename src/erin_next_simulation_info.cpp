@@ -26,7 +26,13 @@ namespace erin
     std::unordered_set<std::string> const OptionalSimulationInfoFields{
         "fixed_random",
         "fixed_random_series",
-        "random_seed"
+        "random_seed",
+        "convergence_metrics",
+        "convergence_tolerances",
+        "confidence_level",
+        "min_occurrences",
+        "sampling",
+        "fragility_importance_factor",
     };
 
     // NOTE: pre-requisite, table already validated
@@ -101,6 +107,119 @@ namespace erin
             );
         }
         si.TypeOfRandom = rtype;
+        if (table.contains("convergence_metrics"))
+        {
+            std::vector<std::string> metricTags =
+                std::get<std::vector<std::string>>(
+                    table.at("convergence_metrics").Value
+                );
+            for (std::string const& tag : metricTags)
+            {
+                std::optional<ConvergenceMetric> maybeMetric =
+                    TagToConvergenceMetric(tag);
+                if (!maybeMetric.has_value())
+                {
+                    WriteErrorMessage(
+                        "simulation_info",
+                        "unhandled convergence metric '" + tag + "'"
+                    );
+                    return {};
+                }
+                si.ConvergenceMetrics.push_back(maybeMetric.value());
+            }
+            if (!table.contains("convergence_tolerances"))
+            {
+                WriteErrorMessage(
+                    "simulation_info",
+                    "convergence_metrics requires convergence_tolerances"
+                );
+                return {};
+            }
+            std::vector<double> tolerances = std::get<std::vector<double>>(
+                table.at("convergence_tolerances").Value
+            );
+            // NOTE: a single tolerance applies to all metrics
+            if (tolerances.size() == 1)
+            {
+                tolerances.resize(si.ConvergenceMetrics.size(), tolerances[0]);
+            }
+            if (tolerances.size() != si.ConvergenceMetrics.size())
+            {
+                WriteErrorMessage(
+                    "simulation_info",
+                    "convergence_tolerances must have one value "
+                    "or one value per convergence metric"
+                );
+                return {};
+            }
+            for (double tolerance : tolerances)
+            {
+                if (!(tolerance > 0.0))
+                {
+                    WriteErrorMessage(
+                        "simulation_info",
+                        "convergence_tolerances must be greater than 0"
+                    );
+                    return {};
+                }
+            }
+            si.ConvergenceTolerances = std::move(tolerances);
+        }
+        if (table.contains("confidence_level"))
+        {
+            double level = std::get<double>(table.at("confidence_level").Value);
+            if (!(level > 0.0 && level < 1.0))
+            {
+                WriteErrorMessage(
+                    "simulation_info",
+                    "confidence_level must be between 0 and 1 (exclusive)"
+                );
+                return {};
+            }
+            si.ConfidenceLevel = level;
+        }
+        if (table.contains("min_occurrences"))
+        {
+            int64_t minOccurrences =
+                std::get<int64_t>(table.at("min_occurrences").Value);
+            if (minOccurrences < 2)
+            {
+                WriteErrorMessage(
+                    "simulation_info", "min_occurrences must be at least 2"
+                );
+                return {};
+            }
+            si.MinOccurrences = static_cast<size_t>(minOccurrences);
+        }
+        if (table.contains("sampling"))
+        {
+            std::string tag =
+                std::get<std::string>(table.at("sampling").Value);
+            std::optional<SamplingType> maybeSampling = TagToSamplingType(tag);
+            if (!maybeSampling.has_value())
+            {
+                WriteErrorMessage(
+                    "simulation_info", "unhandled sampling '" + tag + "'"
+                );
+                return {};
+            }
+            si.Sampling = maybeSampling.value();
+        }
+        if (table.contains("fragility_importance_factor"))
+        {
+            double factor = std::get<double>(
+                table.at("fragility_importance_factor").Value
+            );
+            if (!(factor >= 1.0))
+            {
+                WriteErrorMessage(
+                    "simulation_info",
+                    "fragility_importance_factor must be at least 1"
+                );
+                return {};
+            }
+            si.FragilityImportanceFactor = factor;
+        }
         return si;
     }
 
@@ -0,0 +1,429 @@
+/* Copyright (c) 2024 Big Ladder Software LLC. All rights reserved.
+ * See the LICENSE.txt file for additional terms and conditions. */
+#include "erin_next/erin_next_synthetic.h"
+#include "erin_next/erin_next_random.h"
+#include <fmt/core.h>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <sstream>
+
+namespace erin
+{
+    static std::vector<std::string> const SyntheticFailureModes{
+        "fault",
+        "wear",
+        "outage",
+    };
+
+    struct SyntheticWriter
+    {
+        SyntheticModelOptions const& Options;
+        Random& Rng;
+        std::ostringstream Components;
+        std::vector<std::string> Connections;
+    };
+
+    static std::string
+    Synthetic_ScenarioTag(size_t scenarioIdx)
+    {
+        return fmt::format("scenario_{}", scenarioIdx + 1);
+    }
+
+    // NOTE: each component gets a failure mode with probability
+    // FailureModeDensity; components exposed to a hazard likewise get the
+    // matching fragility mode
+    static void
+    Synthetic_WriteReliability(
+        SyntheticWriter& w,
+        std::string const& fragilityMode
+    )
+    {
+        if (w.Rng() < w.Options.FailureModeDensity)
+        {
+            size_t idx = static_cast<size_t>(
+                w.Rng() * static_cast<double>(SyntheticFailureModes.size())
+            );
+            idx = std::min(idx, SyntheticFailureModes.size() - 1);
+            w.Components << "failure_modes = [\"" << SyntheticFailureModes[idx]
+                         << "\"]\n";
+        }
+        if (!fragilityMode.empty()
+            && w.Rng() < w.Options.FailureModeDensity)
+        {
+            w.Components << "fragility_modes = [\"" << fragilityMode
+                         << "\"]\n";
+        }
+    }
+
+    static void
+    Synthetic_WriteLoadsByScenario(
+        SyntheticWriter& w,
+        std::string const& loadTag
+    )
+    {
+        for (size_t i = 0; i < w.Options.NumScenarios; ++i)
+        {
+            w.Components << "loads_by_scenario." << Synthetic_ScenarioTag(i)
+                         << " = \"" << loadTag << "\"\n";
+        }
+    }
+
+    static void
+    Synthetic_Connect(
+        SyntheticWriter& w,
+        std::string const& from,
+        size_t fromPort,
+        std::string const& to,
+        size_t toPort,
+        std::string const& flow
+    )
+    {
+        w.Connections.push_back(fmt::format(
+            "[\"{}:OUT({})\", \"{}:IN({})\", \"{}\"]",
+            from,
+            fromPort,
+            to,
+            toPort,
+            flow
+        ));
+    }
+
+    // hourly profile over the scenario duration: a daily cycle around a
+    // random peak, returned as (hour, kW) pairs ending at zero
+    static std::vector<std::pair<double, double>>
+    Synthetic_MakeProfile(
+        Random& rng,
+        double minPeak_kW,
+        double maxPeak_kW,
+        double duration_h
+    )
+    {
+        double const twoPi = 2.0 * 3.14159265358979323846;
+        double peak_kW = minPeak_kW + (maxPeak_kW - minPeak_kW) * rng();
+        double phase_h = 24.0 * rng();
+        size_t numHours = static_cast<size_t>(std::ceil(duration_h));
+        std::vector<std::pair<double, double>> profile;
+        profile.reserve(numHours + 1);
+        for (size_t h = 0; h < numHours; ++h)
+        {
+            double hour = static_cast<double>(h);
+            double load_kW = peak_kW
+                * (0.6 + 0.4 * std::sin(twoPi * (hour + phase_h) / 24.0));
+            profile.push_back({hour, std::round(load_kW * 10.0) / 10.0});
+        }
+        profile.push_back({duration_h, 0.0});
+        return profile;
+    }
+
+    static void
+    Synthetic_WriteLoad(
+        std::ostringstream& toml,
+        std::vector<LoadProfileFile>& loadFiles,
+        std::string const& loadFilePrefix,
+        std::string const& tag,
+        std::vector<std::pair<double, double>> const& profile
+    )
+    {
+        toml << "[loads." << tag << "]\n";
+        if (loadFilePrefix.empty())
+        {
+            toml << "time_unit = \"hours\"\n"
+                 << "rate_unit = \"kW\"\n"
+                 << "time_rate_pairs = [";
+            for (size_t i = 0; i < profile.size(); ++i)
+            {
+                toml << (i == 0 ? "" : ",") << "[" << profile[i].first << ","
+                     << profile[i].second << "]";
+            }
+            toml << "]\n";
+            return;
+        }
+        LoadProfileFile file{};
+        file.Path = loadFilePrefix + tag + ".csv";
+        std::ostringstream csv{};
+        csv << "hours,kW\n";
+        for (auto const& [hour, load_kW] : profile)
+        {
+            csv << hour << "," << load_kW << "\n";
+        }
+        file.Contents = csv.str();
+        toml << "csv_file = \"" << file.Path << "\"\n";
+        loadFiles.push_back(std::move(file));
+    }
+
+    // Writes the mux tree from the utility down to the feeders. The fanout
+    // is the smallest that reaches every feeder in NetworkDepth levels.
+    static void
+    Synthetic_WriteDistributionTree(
+        SyntheticWriter& w,
+        std::vector<std::string> const& feeders
+    )
+    {
+        size_t const depth = std::max<size_t>(w.Options.NetworkDepth, 1);
+        size_t fanout = 2;
+        while (std::pow(static_cast<double>(fanout), static_cast<double>(depth))
+               < static_cast<double>(feeders.size()))
+        {
+            ++fanout;
+        }
+        std::vector<std::string> children = feeders;
+        std::vector<std::string> levels(depth);
+        for (size_t level = depth; level-- > 0;)
+        {
+            std::ostringstream muxes{};
+            std::vector<std::string> parents;
+            for (size_t first = 0; first < children.size(); first += fanout)
+            {
+                size_t last = std::min(first + fanout, children.size());
+                std::string tag =
+                    fmt::format("mux_{}_{}", level + 1, parents.size() + 1);
+                muxes << "[components." << tag << "]\n"
+                      << "type = \"mux\"\n"
+                      << "flow = \"electricity\"\n"
+                      << "num_inflows = 1\n"
+                      << "num_outflows = " << (last - first) << "\n";
+                for (size_t i = first; i < last; ++i)
+                {
+                    Synthetic_Connect(
+                        w, tag, i - first, children[i], 0, "electricity"
+                    );
+                }
+                parents.push_back(std::move(tag));
+            }
+            levels[level] = muxes.str();
+            children = std::move(parents);
+        }
+        assert(children.size() == 1);
+        Synthetic_Connect(w, "utility", 0, children[0], 0, "electricity");
+        for (std::string const& muxes : levels)
+        {
+            w.Components << muxes;
+        }
+    }
+
+    SyntheticModel
+    SyntheticModel_Generate(
+        SyntheticModelOptions const& options,
+        std::string const& loadFilePrefix
+    )
+    {
+        assert(options.NumBuildings > 0);
+        assert(options.NumScenarios > 0);
+        assert(options.NumLoadProfiles > 0);
+        SyntheticModel model{};
+        Random rng = CreateRandomWithSeed(options.Seed);
+        SyntheticWriter w{
+            .Options = options,
+            .Rng = rng,
+            .Components = {},
+            .Connections = {},
+        };
+        std::ostringstream toml{};
+        // NOTE: occurrences are 5 to 15 years apart, so the maximum time
+        // leaves room for all of them
+        toml << "[simulation_info]\n"
+             << "input_format_version = \"0.2\"\n"
+             << "rate_unit = \"kW\"\n"
+             << "quantity_unit = \"kJ\"\n"
+             << "time_unit = \"years\"\n"
+             << "max_time = " << (15 * options.NumOccurrences + 15) << "\n"
+             << "random_seed = " << options.Seed << "\n";
+        for (size_t p = 0; p < options.NumLoadProfiles; ++p)
+        {
+            Synthetic_WriteLoad(
+                toml,
+                model.LoadFiles,
+                loadFilePrefix,
+                fmt::format("electric_{}", p + 1),
+                Synthetic_MakeProfile(
+                    rng, 50.0, 150.0, options.ScenarioDuration_h
+                )
+            );
+            Synthetic_WriteLoad(
+                toml,
+                model.LoadFiles,
+                loadFilePrefix,
+                fmt::format("cooling_{}", p + 1),
+                Synthetic_MakeProfile(
+                    rng, 30.0, 90.0, options.ScenarioDuration_h
+                )
+            );
+        }
+        w.Components << "[components.utility]\n"
+                     << "type = \"source\"\n"
+                     << "outflow = \"electricity\"\n";
+        Synthetic_WriteReliability(w, "");
+        std::vector<std::string> feeders;
+        feeders.reserve(options.NumBuildings);
+        for (size_t b = 1; b <= options.NumBuildings; ++b)
+        {
+            std::string feeder = fmt::format("feeder_{}", b);
+            std::string battery = fmt::format("battery_{}", b);
+            std::string gas = fmt::format("gas_{}", b);
+            std::string genset = fmt::format("genset_{}", b);
+            std::string ats = fmt::format("switch_{}", b);
+            std::string panel = fmt::format("panel_{}", b);
+            std::string electricLoad = fmt::format("electric_load_{}", b);
+            std::string chiller = fmt::format("chiller_{}", b);
+            std::string coolingLoad = fmt::format("cooling_load_{}", b);
+            size_t profile = (b - 1) % options.NumLoadProfiles + 1;
+            bool hasBattery = rng() < options.StorageFraction;
+            feeders.push_back(feeder);
+            w.Components << "[components." << feeder << "]\n"
+                         << "type = \"pass_through\"\n"
+                         << "flow = \"electricity\"\n";
+            Synthetic_WriteReliability(w, "wind_damage");
+            if (hasBattery)
+            {
+                w.Components << "[components." << battery << "]\n"
+                             << "type = \"store\"\n"
+                             << "flow = \"electricity\"\n"
+                             << "capacity_unit = \"kWh\"\n"
+                             << "capacity = 200.0\n"
+                             << "rate_unit = \"kW\"\n"
+                             << "max_charge = 50.0\n"
+                             << "max_discharge = 150.0\n"
+                             << "charge_at_soc = 0.8\n"
+                             << "init_soc = 1.0\n";
+                // NOTE: stores and switches are not given reliability; the
+                // engine does not implement failing or restoring them
+                Synthetic_Connect(w, feeder, 0, battery, 0, "electricity");
+                Synthetic_Connect(w, battery, 0, ats, 0, "electricity");
+            }
+            else
+            {
+                Synthetic_Connect(w, feeder, 0, ats, 0, "electricity");
+            }
+            w.Components << "[components." << gas << "]\n"
+                         << "type = \"source\"\n"
+                         << "outflow = \"natural_gas\"\n";
+            Synthetic_WriteReliability(w, "");
+            w.Components << "[components." << genset << "]\n"
+                         << "type = \"converter\"\n"
+                         << "inflow = \"natural_gas\"\n"
+                         << "outflow = \"electricity\"\n"
+                         << "constant_efficiency = 0.35\n";
+            Synthetic_WriteReliability(w, "flood_damage");
+            w.Components << "[components." << ats << "]\n"
+                         << "type = \"switch\"\n"
+                         << "flow = \"electricity\"\n";
+            w.Components << "[components." << panel << "]\n"
+                         << "type = \"mux\"\n"
+                         << "flow = \"electricity\"\n"
+                         << "num_inflows = 1\n"
+                         << "num_outflows = 2\n";
+            w.Components << "[components." << electricLoad << "]\n"
+                         << "type = \"load\"\n"
+                         << "inflow = \"electricity\"\n";
+            Synthetic_WriteLoadsByScenario(
+                w, fmt::format("electric_{}", profile)
+            );
+            w.Components << "[components." << chiller << "]\n"
+                         << "type = \"mover\"\n"
+                         << "inflow = \"electricity\"\n"
+                         << "outflow = \"cooling\"\n"
+                         << "cop = 4.0\n";
+            Synthetic_WriteReliability(w, "");
+            w.Components << "[components." << coolingLoad << "]\n"
+                         << "type = \"load\"\n"
+                         << "inflow = \"cooling\"\n";
+            Synthetic_WriteLoadsByScenario(
+                w, fmt::format("cooling_{}", profile)
+            );
+            Synthetic_Connect(w, gas, 0, genset, 0, "natural_gas");
+            Synthetic_Connect(w, genset, 0, ats, 1, "electricity");
+            Synthetic_Connect(w, ats, 0, panel, 0, "electricity");
+            Synthetic_Connect(w, panel, 0, electricLoad, 0, "electricity");
+            Synthetic_Connect(w, panel, 1, chiller, 0, "electricity");
+            Synthetic_Connect(w, chiller, 0, coolingLoad, 0, "cooling");
+        }
+        Synthetic_WriteDistributionTree(w, feeders);
+        toml << w.Components.str();
+        toml << "[network]\n"
+             << "connections = [\n";
+        for (std::string const& conn : w.Connections)
+        {
+            toml << "  " << conn << ",\n";
+        }
+        toml << "]\n";
+        toml << "[dist.occurrence]\n"
+             << "type = \"uniform\"\n"
+             << "lower_bound = 5\n"
+             << "upper_bound = 15\n"
+             << "time_unit = \"years\"\n"
+             << "[dist.fault_failure]\n"
+             << "type = \"weibull\"\n"
+             << "shape = 1.5\n"
+             << "scale = 8760\n"
+             << "time_unit = \"hours\"\n"
+             << "[dist.fault_repair]\n"
+             << "type = \"fixed\"\n"
+             << "value = 8\n"
+             << "time_unit = \"hours\"\n"
+             << "[dist.wear_failure]\n"
+             << "type = \"uniform\"\n"
+             << "lower_bound = 2000\n"
+             << "upper_bound = 20000\n"
+             << "time_unit = \"hours\"\n"
+             << "[dist.wear_repair]\n"
+             << "type = \"uniform\"\n"
+             << "lower_bound = 24\n"
+             << "upper_bound = 96\n"
+             << "time_unit = \"hours\"\n"
+             << "[dist.outage_failure]\n"
+             << "type = \"weibull\"\n"
+             << "shape = 0.8\n"
+             << "scale = 20000\n"
+             << "time_unit = \"hours\"\n"
+             << "[dist.outage_repair]\n"
+             << "type = \"weibull\"\n"
+             << "shape = 2.0\n"
+             << "scale = 12\n"
+             << "time_unit = \"hours\"\n"
+             << "[dist.damage_repair]\n"
+             << "type = \"uniform\"\n"
+             << "lower_bound = 48\n"
+             << "upper_bound = 240\n"
+             << "time_unit = \"hours\"\n";
+        for (std::string const& fm : SyntheticFailureModes)
+        {
+            toml << "[failure_mode." << fm << "]\n"
+                 << "failure_dist = \"" << fm << "_failure\"\n"
+                 << "repair_dist = \"" << fm << "_repair\"\n";
+        }
+        toml << "[fragility_mode.wind_damage]\n"
+             << "fragility_curve = \"wind_curve\"\n"
+             << "repair_dist = \"damage_repair\"\n"
+             << "[fragility_mode.flood_damage]\n"
+             << "fragility_curve = \"flood_curve\"\n"
+             << "repair_dist = \"damage_repair\"\n"
+             << "[fragility_curve.wind_curve]\n"
+             << "vulnerable_to = \"wind_speed_mph\"\n"
+             << "type = \"linear\"\n"
+             << "lower_bound = 80.0\n"
+             << "upper_bound = 180.0\n"
+             << "[fragility_curve.flood_curve]\n"
+             << "vulnerable_to = \"inundation_depth_ft\"\n"
+             << "type = \"linear\"\n"
+             << "lower_bound = 2.0\n"
+             << "upper_bound = 14.0\n";
+        // NOTE: later scenarios are progressively more severe
+        for (size_t i = 0; i < options.NumScenarios; ++i)
+        {
+            double severity = static_cast<double>(i + 1)
+                / static_cast<double>(options.NumScenarios);
+            toml << "[scenarios." << Synthetic_ScenarioTag(i) << "]\n"
+                 << "time_unit = \"hours\"\n"
+                 << "occurrence_distribution = \"occurrence\"\n"
+                 << "duration = " << options.ScenarioDuration_h << "\n"
+                 << "max_occurrences = " << options.NumOccurrences << "\n"
+                 << "intensity.wind_speed_mph = " << (60.0 + 120.0 * severity)
+                 << "\n"
+                 << "intensity.inundation_depth_ft = " << (12.0 * severity)
+                 << "\n";
+        }
+        model.Toml = toml.str();
+        return model;
+    }
+} // namespace erin
@@ -11,4 +11,84 @@ namespace erin
            << "Amount_W=" << timeAndLoad.Amount_W << "}";
         return os;
     }
+
+    bool
+    operator==(TimeAndAmount const& a, TimeAndAmount const& b)
+    {
+        return a.Time_s == b.Time_s && a.Amount_W == b.Amount_W;
+    }
+
+    size_t
+    TimeAndAmount_Compact(std::vector<TimeAndAmount>& series)
+    {
+        if (series.empty())
+        {
+            return 0;
+        }
+        size_t numKept = 1;
+        for (size_t i = 1; i < series.size(); ++i)
+        {
+            if (series[i].Amount_W != series[numKept - 1].Amount_W)
+            {
+                series[numKept] = series[i];
+                ++numKept;
+            }
+        }
+        size_t numRemoved = series.size() - numKept;
+        series.resize(numKept);
+        return numRemoved;
+    }
+
+    AmountSchedule
+    AmountSchedule_Make(std::vector<TimeAndAmount> entries)
+    {
+        AmountSchedule schedule{};
+        bool isUniform = entries.size() > 1;
+        double start_s = isUniform ? entries[0].Time_s : 0.0;
+        double timeStep_s = isUniform ? entries[1].Time_s - start_s : 0.0;
+        isUniform = isUniform && timeStep_s > 0.0;
+        for (size_t i = 0; isUniform && i < entries.size(); ++i)
+        {
+            isUniform = entries[i].Time_s
+                == start_s + static_cast<double>(i) * timeStep_s;
+        }
+        if (!isUniform)
+        {
+            schedule.Entries = std::move(entries);
+            return schedule;
+        }
+        schedule.Start_s = start_s;
+        schedule.TimeStep_s = timeStep_s;
+        schedule.Amounts_W.reserve(entries.size());
+        for (TimeAndAmount const& entry : entries)
+        {
+            schedule.Amounts_W.push_back(entry.Amount_W);
+        }
+        return schedule;
+    }
+
+    std::vector<TimeAndAmount>
+    AmountSchedule_ToEntries(AmountSchedule const& schedule)
+    {
+        if (!AmountSchedule_IsUniform(schedule))
+        {
+            return schedule.Entries;
+        }
+        std::vector<TimeAndAmount> entries;
+        entries.reserve(schedule.Amounts_W.size());
+        for (size_t i = 0; i < schedule.Amounts_W.size(); ++i)
+        {
+            entries.push_back(
+                {AmountSchedule_TimeAt(schedule, i), schedule.Amounts_W[i]}
+            );
+        }
+        return entries;
+    }
+
+    bool
+    operator==(AmountSchedule const& a, AmountSchedule const& b)
+    {
+        return a.Entries == b.Entries && a.Start_s == b.Start_s
+            && a.TimeStep_s == b.TimeStep_s && a.Amounts_W == b.Amounts_W;
+    }
 } // namespace erin
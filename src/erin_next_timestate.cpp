@@ -3,11 +3,248 @@
 #include "erin_next/erin_next_timestate.h"
 #include "erin_next/erin_next_utils.h"
 #include <assert.h>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <set>
 #include <sstream>
+#include <stdexcept>
 
 namespace erin
 {
 
+    size_t const causeSetChunkBits = 12;
+    size_t const causeSetChunkSize = size_t{1} << causeSetChunkBits;
+    size_t const numCauseSetChunks = maxCauseSets / causeSetChunkSize;
+
+    // NOTE: one table per process, shared by all simulations. Sets are kept
+    // in fixed-size chunks that are never moved or freed, so a set can be
+    // read by id without a lock: the set is written before its id is handed
+    // out and its chunk pointer is published with release ordering. Index
+    // finds the id of a set by value and is only touched under Mutex.
+    struct CauseSetTable
+    {
+        std::array<std::atomic<std::vector<size_t>*>, numCauseSetChunks>
+            Chunks{};
+        std::atomic<uint32_t> Count{0};
+        std::mutex Mutex;
+
+        std::vector<size_t> const&
+        Get(uint32_t id) const
+        {
+            std::vector<size_t> const* chunk =
+                Chunks[id >> causeSetChunkBits].load(std::memory_order_acquire);
+            return chunk[id & (causeSetChunkSize - 1)];
+        }
+
+        // NOTE: orders set ids by the sets they refer to so that the index
+        // keeps a single copy of each set and can be searched by value
+        struct Less
+        {
+            using is_transparent = void;
+
+            CauseSetTable const* Table = nullptr;
+
+            std::vector<size_t> const&
+            Get(uint32_t id) const
+            {
+                return Table->Get(id);
+            }
+
+            std::vector<size_t> const&
+            Get(std::vector<size_t> const& ids) const
+            {
+                return ids;
+            }
+
+            template<typename A, typename B>
+            bool
+            operator()(A const& a, B const& b) const
+            {
+                return Get(a) < Get(b);
+            }
+        };
+
+        std::set<uint32_t, Less> Index{Less{this}};
+
+        CauseSetTable()
+        {
+            // NOTE: the empty set is always id 0
+            Add(std::vector<size_t>{});
+        }
+
+        ~CauseSetTable()
+        {
+            for (auto& chunk : Chunks)
+            {
+                delete[] chunk.load(std::memory_order_relaxed);
+            }
+        }
+
+        CauseSetTable(CauseSetTable const&) = delete;
+        CauseSetTable&
+        operator=(CauseSetTable const&) = delete;
+
+        // NOTE: call with Mutex held
+        uint32_t
+        Add(std::vector<size_t>&& ids)
+        {
+            uint32_t id = Count.load(std::memory_order_relaxed);
+            if (id >= maxCauseSets)
+            {
+                throw std::length_error("too many distinct cause sets");
+            }
+            size_t chunkIdx = id >> causeSetChunkBits;
+            std::vector<size_t>* chunk =
+                Chunks[chunkIdx].load(std::memory_order_relaxed);
+            if (chunk == nullptr)
+            {
+                chunk = new std::vector<size_t>[causeSetChunkSize];
+                Chunks[chunkIdx].store(chunk, std::memory_order_release);
+            }
+            chunk[id & (causeSetChunkSize - 1)] = std::move(ids);
+            Count.store(id + 1, std::memory_order_release);
+            Index.insert(id);
+            return id;
+        }
+    };
+
+    static CauseSetTable&
+    CauseSet_GetTable()
+    {
+        static CauseSetTable table{};
+        return table;
+    }
+
+    // NOTE: ids must be sorted and unique
+    static uint32_t
+    CauseSet_Intern(std::vector<size_t>&& ids)
+    {
+        if (ids.empty())
+        {
+            return 0;
+        }
+        CauseSetTable& table = CauseSet_GetTable();
+        std::lock_guard<std::mutex> lock{table.Mutex};
+        auto it = table.Index.find(ids);
+        if (it != table.Index.end())
+        {
+            return *it;
+        }
+        return table.Add(std::move(ids));
+    }
+
+    static std::vector<size_t> const&
+    CauseSet_GetIds(uint32_t id)
+    {
+        CauseSetTable const& table = CauseSet_GetTable();
+        assert(id < table.Count.load(std::memory_order_relaxed));
+        return table.Get(id);
+    }
+
+    void
+    CauseSet::SetId(uint32_t id)
+    {
+        assert(id < maxCauseSets);
+        IdBytes[0] = static_cast<uint8_t>(id & 0xFF);
+        IdBytes[1] = static_cast<uint8_t>((id >> 8) & 0xFF);
+        IdBytes[2] = static_cast<uint8_t>((id >> 16) & 0xFF);
+    }
+
+    CauseSet::CauseSet(std::initializer_list<size_t> ids)
+    {
+        std::vector<size_t> sorted{ids};
+        std::sort(sorted.begin(), sorted.end());
+        sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+        SetId(CauseSet_Intern(std::move(sorted)));
+    }
+
+    CauseSet::CauseSet(std::set<size_t> const& ids)
+    {
+        SetId(CauseSet_Intern(std::vector<size_t>(ids.begin(), ids.end())));
+    }
+
+    std::vector<size_t>::const_iterator
+    CauseSet::begin() const
+    {
+        return CauseSet_GetIds(GetId()).cbegin();
+    }
+
+    std::vector<size_t>::const_iterator
+    CauseSet::end() const
+    {
+        return CauseSet_GetIds(GetId()).cend();
+    }
+
+    size_t
+    CauseSet::size() const
+    {
+        return CauseSet_GetIds(GetId()).size();
+    }
+
+    bool
+    CauseSet::empty() const
+    {
+        return GetId() == 0;
+    }
+
+    bool
+    CauseSet::contains(size_t id) const
+    {
+        std::vector<size_t> const& ids = CauseSet_GetIds(GetId());
+        return std::binary_search(ids.begin(), ids.end(), id);
+    }
+
+    void
+    CauseSet::insert(size_t id)
+    {
+        if (contains(id))
+        {
+            return;
+        }
+        std::vector<size_t> const& ids = CauseSet_GetIds(GetId());
+        std::vector<size_t> newIds;
+        newIds.reserve(ids.size() + 1);
+        auto pos = std::lower_bound(ids.begin(), ids.end(), id);
+        newIds.insert(newIds.end(), ids.begin(), pos);
+        newIds.push_back(id);
+        newIds.insert(newIds.end(), pos, ids.end());
+        SetId(CauseSet_Intern(std::move(newIds)));
+    }
+
+    CauseSet
+    CauseSet_Union(CauseSet const& a, CauseSet const& b)
+    {
+        if (a.GetId() == b.GetId() || b.empty())
+        {
+            return a;
+        }
+        if (a.empty())
+        {
+            return b;
+        }
+        std::vector<size_t> const& aIds = CauseSet_GetIds(a.GetId());
+        std::vector<size_t> const& bIds = CauseSet_GetIds(b.GetId());
+        std::vector<size_t> ids;
+        ids.reserve(aIds.size() + bIds.size());
+        std::set_union(
+            aIds.begin(),
+            aIds.end(),
+            bIds.begin(),
+            bIds.end(),
+            std::back_inserter(ids)
+        );
+        CauseSet result{};
+        result.SetId(CauseSet_Intern(std::move(ids)));
+        return result;
+    }
+
+    size_t
+    CauseSet_NumberInterned()
+    {
+        return CauseSet_GetTable().Count.load(std::memory_order_acquire);
+    }
+
     std::ostream&
     operator<<(std::ostream& os, const TimeState& ts)
     {
@@ -34,36 +271,9 @@ namespace erin
     bool
     operator==(TimeState const& a, TimeState const& b)
     {
-        bool result = true;
-        result = result && a.time == b.time;
-        result = result && a.state == b.state;
-        result =
-            result && a.failureModeCauses.size() == b.failureModeCauses.size();
-        result = result
-            && a.fragilityModeCauses.size() == b.fragilityModeCauses.size();
-        if (result)
-        {
-            for (auto const& aFm : a.failureModeCauses)
-            {
-                result = result && b.failureModeCauses.contains(aFm);
-                if (!result)
-                {
-                    break;
-                }
-            }
-        }
-        if (result)
-        {
-            for (auto const& aFm : a.fragilityModeCauses)
-            {
-                result = result && b.fragilityModeCauses.contains(aFm);
-                if (!result)
-                {
-                    break;
-                }
-            }
-        }
-        return result;
+        return a.time == b.time && a.state == b.state
+            && a.failureModeCauses == b.failureModeCauses
+            && a.fragilityModeCauses == b.fragilityModeCauses;
     }
 
     bool
@@ -81,26 +291,17 @@ namespace erin
         std::vector<TimeState> result;
         if (a.size() == 0 && b.size() > 0)
         {
-            result.reserve(b.size());
-            for (size_t i = 0; i < b.size(); ++i)
-            {
-                result.push_back(TimeState_Copy(b.at(i)));
-            }
-            return result;
+            return b;
         }
         else if (a.size() > 0 && b.size() == 0)
         {
-            result.reserve(a.size());
-            for (size_t i = 0; i < a.size(); ++i)
-            {
-                result.push_back(TimeState_Copy(a.at(i)));
-            }
-            return result;
+            return a;
         }
         else if (a.size() == 0 && b.size() == 0)
         {
             return result;
         }
+        result.reserve(a.size() + b.size());
         size_t aIdx = 0;
         size_t bIdx = 0;
         double time = 0.0;
@@ -110,8 +311,8 @@ namespace erin
         {
             TimeState const& nextA = a.at(aIdx);
             TimeState const& nextB = b.at(bIdx);
-            std::set<size_t> failureModes{};
-            std::set<size_t> fragilityModes{};
+            CauseSet failureModes{};
+            CauseSet fragilityModes{};
             if (time >= nextA.time && time >= nextB.time)
             {
                 state = nextA.state && nextB.state;
@@ -144,31 +345,21 @@ namespace erin
             }
             if (time >= nextA.time && !nextA.state)
             {
-                for (auto const& fmA : nextA.failureModeCauses)
-                {
-                    failureModes.insert(fmA);
-                }
-                for (auto const& fmA : nextA.fragilityModeCauses)
-                {
-                    fragilityModes.insert(fmA);
-                }
+                failureModes = nextA.failureModeCauses;
+                fragilityModes = nextA.fragilityModeCauses;
             }
             if (time >= nextB.time && !nextB.state)
             {
-                for (auto const& fmB : nextB.failureModeCauses)
-                {
-                    failureModes.insert(fmB);
-                }
-                for (auto const& fmB : nextB.fragilityModeCauses)
-                {
-                    fragilityModes.insert(fmB);
-                }
+                failureModes =
+                    CauseSet_Union(failureModes, nextB.failureModeCauses);
+                fragilityModes =
+                    CauseSet_Union(fragilityModes, nextB.fragilityModeCauses);
             }
             result.push_back({
                 .time = time,
                 .state = state,
-                .failureModeCauses = std::move(failureModes),
-                .fragilityModeCauses = std::move(fragilityModes),
+                .failureModeCauses = failureModes,
+                .fragilityModeCauses = fragilityModes,
             });
             // increment to the lowest time (ta or tb) ahead of t
             bool aCanInc = (aIdx + 1) < a.size();
@@ -268,6 +459,102 @@ namespace erin
         return result;
     }
 
+    void
+    TimeState_MergeAndClip(
+        std::vector<std::vector<TimeState> const*> const& inputs,
+        double startTime_s,
+        double endTime_s,
+        bool rezeroTime,
+        std::vector<TimeState>& result
+    )
+    {
+        assert(startTime_s <= endTime_s);
+        result.clear();
+        size_t numInputs = inputs.size();
+        size_t totalSize = 0;
+        for (auto const* input : inputs)
+        {
+            totalSize += input->size();
+        }
+        result.reserve(totalSize + 1);
+        // NOTE: min-heap of (time, input index) over the next unconsumed entry
+        // of each input
+        using HeapItem = std::pair<double, size_t>;
+        auto heapCompare = [](HeapItem const& a, HeapItem const& b) -> bool
+        { return a.first > b.first; };
+        std::vector<HeapItem> heap;
+        heap.reserve(numInputs);
+        std::vector<size_t> nextIdx(numInputs, 0);
+        std::vector<TimeState const*> active(numInputs, nullptr);
+        for (size_t i = 0; i < numInputs; ++i)
+        {
+            if (inputs[i]->size() > 0)
+            {
+                heap.push_back({(*inputs[i])[0].time, i});
+            }
+        }
+        std::make_heap(heap.begin(), heap.end(), heapCompare);
+        bool hasPriorState = false;
+        TimeState priorState{};
+        while (!heap.empty())
+        {
+            double time = heap.front().first;
+            if (time > endTime_s)
+            {
+                break;
+            }
+            while (!heap.empty() && heap.front().first == time)
+            {
+                std::pop_heap(heap.begin(), heap.end(), heapCompare);
+                size_t inputIdx = heap.back().second;
+                heap.pop_back();
+                std::vector<TimeState> const& input = *inputs[inputIdx];
+                size_t idx = nextIdx[inputIdx];
+                while ((idx + 1) < input.size() && input[idx + 1].time == time)
+                {
+                    ++idx;
+                }
+                active[inputIdx] = &input[idx];
+                nextIdx[inputIdx] = idx + 1;
+                if (nextIdx[inputIdx] < input.size())
+                {
+                    heap.push_back({input[nextIdx[inputIdx]].time, inputIdx});
+                    std::push_heap(heap.begin(), heap.end(), heapCompare);
+                }
+            }
+            TimeState ts{time, true, {}, {}};
+            for (TimeState const* a : active)
+            {
+                if (a != nullptr && !a->state)
+                {
+                    ts.state = false;
+                    ts.failureModeCauses = CauseSet_Union(
+                        ts.failureModeCauses, a->failureModeCauses
+                    );
+                    ts.fragilityModeCauses = CauseSet_Union(
+                        ts.fragilityModeCauses, a->fragilityModeCauses
+                    );
+                }
+            }
+            if (time < startTime_s)
+            {
+                priorState = ts;
+                hasPriorState = true;
+                continue;
+            }
+            if (result.size() == 0 && time > startTime_s && hasPriorState)
+            {
+                priorState.time = rezeroTime ? 0.0 : startTime_s;
+                result.push_back(priorState);
+            }
+            if (rezeroTime)
+            {
+                ts.time -= startTime_s;
+            }
+            result.push_back(ts);
+        }
+    }
+
     std::vector<TimeState>
     TimeState_Translate(std::vector<TimeState> const& input, double dt_s)
     {
@@ -289,18 +576,8 @@ namespace erin
     TimeState
     TimeState_Copy(TimeState const& ts)
     {
-        TimeState result;
-        result.time = ts.time;
-        result.state = ts.state;
-        for (auto x : ts.failureModeCauses)
-        {
-            result.failureModeCauses.insert(x);
-        }
-        for (auto x : ts.fragilityModeCauses)
-        {
-            result.fragilityModeCauses.insert(x);
-        }
-        return result;
+        // NOTE: causes are interned handles so a plain copy is a deep copy
+        return ts;
     }
 
     double
@@ -0,0 +1,168 @@
+/* Copyright (c) 2024 Big Ladder Software LLC. All rights reserved.
+ * See the LICENSE.txt file for additional terms and conditions. */
+#include "erin_next/erin_next_trace.h"
+#include <fmt/core.h>
+#include <fstream>
+
+namespace erin
+{
+    Trace TheTrace{};
+
+    void
+    Trace_Enable()
+    {
+        std::lock_guard<std::mutex> lock{TheTrace.BuffersMutex};
+        TheTrace.Buffers.clear();
+        TheTrace.Generation.fetch_add(1, std::memory_order_relaxed);
+        TheTrace.Start = std::chrono::steady_clock::now();
+        TheTrace.Enabled.store(true, std::memory_order_release);
+    }
+
+    void
+    Trace_Disable()
+    {
+        std::lock_guard<std::mutex> lock{TheTrace.BuffersMutex};
+        TheTrace.Enabled.store(false, std::memory_order_relaxed);
+        TheTrace.Buffers.clear();
+        TheTrace.Generation.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    double
+    Trace_Now_us()
+    {
+        std::chrono::duration<double, std::micro> elapsed =
+            std::chrono::steady_clock::now() - TheTrace.Start;
+        return elapsed.count();
+    }
+
+    static TraceBuffer&
+    Trace_ThreadBuffer()
+    {
+        thread_local TraceBuffer* buffer = nullptr;
+        thread_local uint64_t generation = 0;
+        uint64_t current = TheTrace.Generation.load(std::memory_order_relaxed);
+        if (buffer == nullptr || generation != current)
+        {
+            // NOTE: only taken on a thread's first event of a trace
+            std::lock_guard<std::mutex> lock{TheTrace.BuffersMutex};
+            auto newBuffer = std::make_unique<TraceBuffer>();
+            newBuffer->ThreadIndex = TheTrace.Buffers.size();
+            buffer = newBuffer.get();
+            generation = current;
+            TheTrace.Buffers.push_back(std::move(newBuffer));
+        }
+        return *buffer;
+    }
+
+    void
+    Trace_AddEvent(TraceEvent event)
+    {
+        Trace_ThreadBuffer().Events.push_back(std::move(event));
+    }
+
+    void
+    Trace_AddCounter(char const* name, std::string args)
+    {
+        TraceEvent event{};
+        event.Name = name;
+        event.Category = "counter";
+        event.Phase = 'C';
+        event.Time_us = Trace_Now_us();
+        event.Args = std::move(args);
+        Trace_AddEvent(std::move(event));
+    }
+
+    void
+    Trace_AddInstant(char const* name, char const* category, std::string args)
+    {
+        TraceEvent event{};
+        event.Name = name;
+        event.Category = category;
+        event.Phase = 'i';
+        event.Time_us = Trace_Now_us();
+        event.Args = std::move(args);
+        Trace_AddEvent(std::move(event));
+    }
+
+    void
+    TraceSpan::Stop()
+    {
+        TraceEvent event{};
+        event.Name = Name;
+        event.Category = Category;
+        event.Phase = 'X';
+        event.Time_us = Start_us;
+        event.Duration_us = Trace_Now_us() - Start_us;
+        event.Args = std::move(Args);
+        Trace_AddEvent(std::move(event));
+    }
+
+    std::string
+    Trace_JsonString(std::string const& s)
+    {
+        std::string quoted = "\"";
+        for (char c : s)
+        {
+            if (c == '"' || c == '\\')
+            {
+                quoted.push_back('\\');
+            }
+            quoted.push_back(c);
+        }
+        quoted.push_back('"');
+        return quoted;
+    }
+
+    Result
+    Trace_WriteJson(std::string const& filename)
+    {
+        std::ofstream out{filename};
+        if (!out.good())
+        {
+            return Result::Failure;
+        }
+        std::lock_guard<std::mutex> lock{TheTrace.BuffersMutex};
+        out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+        bool first = true;
+        for (auto const& buffer : TheTrace.Buffers)
+        {
+            size_t tid = buffer->ThreadIndex + 1;
+            out << (first ? "" : ",\n")
+                << fmt::format(
+                       "{{\"name\": \"thread_name\", \"ph\": \"M\", "
+                       "\"pid\": 1, \"tid\": {}, \"args\": "
+                       "{{\"name\": \"erin {}\"}}}}",
+                       tid,
+                       tid
+                   );
+            first = false;
+            for (TraceEvent const& event : buffer->Events)
+            {
+                out << ",\n"
+                    << fmt::format(
+                           "{{\"name\": \"{}\", \"cat\": \"{}\", "
+                           "\"ph\": \"{}\", \"ts\": {:.3f}, ",
+                           event.Name,
+                           event.Category,
+                           event.Phase,
+                           event.Time_us
+                       );
+                if (event.Phase == 'X')
+                {
+                    out << fmt::format("\"dur\": {:.3f}, ", event.Duration_us);
+                }
+                else if (event.Phase == 'i')
+                {
+                    out << "\"s\": \"t\", ";
+                }
+                out << fmt::format(
+                    "\"pid\": 1, \"tid\": {}, \"args\": {{{}}}}}",
+                    tid,
+                    event.Args
+                );
+            }
+        }
+        out << "\n]}\n";
+        return out.good() ? Result::Success : Result::Failure;
+    }
+} // namespace erin
@@ -3,6 +3,13 @@
 #include "erin_next/erin_next_utils.h"
 #include <cmath>
 #include <sstream>
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
 
 namespace erin
 {
@@ -129,4 +136,68 @@ namespace erin
         return WriteTaggedCategoryToString("ERROR", tag, message);
     }
 
+    double
+    GetProcessCpuTime_s()
+    {
+#if defined(_WIN32)
+        FILETIME creation;
+        FILETIME exit;
+        FILETIME kernel;
+        FILETIME user;
+        if (!GetProcessTimes(
+                GetCurrentProcess(), &creation, &exit, &kernel, &user
+            ))
+        {
+            return 0.0;
+        }
+        auto toSeconds = [](FILETIME const& ft) -> double
+        {
+            // NOTE: FILETIME counts 100-nanosecond intervals
+            ULARGE_INTEGER ticks;
+            ticks.LowPart = ft.dwLowDateTime;
+            ticks.HighPart = ft.dwHighDateTime;
+            return static_cast<double>(ticks.QuadPart) * 1e-7;
+        };
+        return toSeconds(kernel) + toSeconds(user);
+#else
+        rusage usage{};
+        if (getrusage(RUSAGE_SELF, &usage) != 0)
+        {
+            return 0.0;
+        }
+        return static_cast<double>(usage.ru_utime.tv_sec)
+            + static_cast<double>(usage.ru_stime.tv_sec)
+            + (static_cast<double>(usage.ru_utime.tv_usec)
+               + static_cast<double>(usage.ru_stime.tv_usec))
+            * 1e-6;
+#endif
+    }
+
+    uint64_t
+    GetPeakResidentSetSize_bytes()
+    {
+#if defined(_WIN32)
+        PROCESS_MEMORY_COUNTERS counters{};
+        if (!GetProcessMemoryInfo(
+                GetCurrentProcess(), &counters, sizeof(counters)
+            ))
+        {
+            return 0;
+        }
+        return static_cast<uint64_t>(counters.PeakWorkingSetSize);
+#else
+        rusage usage{};
+        if (getrusage(RUSAGE_SELF, &usage) != 0)
+        {
+            return 0;
+        }
+#if defined(__APPLE__)
+        // NOTE: macOS reports bytes, Linux reports kilobytes
+        return static_cast<uint64_t>(usage.ru_maxrss);
+#else
+        return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+    }
+
 } // namespace erin
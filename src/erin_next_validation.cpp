@@ -446,6 +446,84 @@ namespace erin
                         InputSection::SimulationInfo,
                     },
             },
+            FieldInfo{
+                .FieldName = "convergence_metrics",
+                .Type = InputType::ArrayOfString,
+                .IsRequired = false,
+                .InformIfMissing = false,
+                .Default = "",
+                .EnumValues = {},
+                .Aliases = {},
+                .Sections =
+                    {
+                        InputSection::SimulationInfo,
+                    },
+            },
+            FieldInfo{
+                .FieldName = "convergence_tolerances",
+                .Type = InputType::ArrayOfDouble,
+                .IsRequired = false,
+                .InformIfMissing = false,
+                .Default = "",
+                .EnumValues = {},
+                .Aliases = {},
+                .Sections =
+                    {
+                        InputSection::SimulationInfo,
+                    },
+            },
+            FieldInfo{
+                .FieldName = "confidence_level",
+                .Type = InputType::Number,
+                .IsRequired = false,
+                .InformIfMissing = false,
+                .Default = "",
+                .EnumValues = {},
+                .Aliases = {},
+                .Sections =
+                    {
+                        InputSection::SimulationInfo,
+                    },
+            },
+            FieldInfo{
+                .FieldName = "min_occurrences",
+                .Type = InputType::Integer,
+                .IsRequired = false,
+                .InformIfMissing = false,
+                .Default = "",
+                .EnumValues = {},
+                .Aliases = {},
+                .Sections =
+                    {
+                        InputSection::SimulationInfo,
+                    },
+            },
+            FieldInfo{
+                .FieldName = "sampling",
+                .Type = InputType::EnumString,
+                .IsRequired = false,
+                .InformIfMissing = false,
+                .Default = "independent",
+                .EnumValues = ValidSamplingTypes,
+                .Aliases = {},
+                .Sections =
+                    {
+                        InputSection::SimulationInfo,
+                    },
+            },
+            FieldInfo{
+                .FieldName = "fragility_importance_factor",
+                .Type = InputType::Number,
+                .IsRequired = false,
+                .InformIfMissing = false,
+                .Default = "",
+                .EnumValues = {},
+                .Aliases = {},
+                .Sections =
+                    {
+                        InputSection::SimulationInfo,
+                    },
+            },
             // Loads -- File-Based
             FieldInfo{
                 .FieldName = "csv_file",
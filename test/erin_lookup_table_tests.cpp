@@ -2,6 +2,7 @@
  * See the LICENSE.txt file for additional terms and conditions. */
 #include "erin_next/erin_next_lookup_table.h"
 #include <gtest/gtest.h>
+#include <cmath>
 #include <vector>
 
 TEST(LookupTable, TestInterp)
@@ -33,3 +34,111 @@ TEST(LookupTable, TestLookupStairstep)
     double actual = erin::LookupTable_LookupStairStep(xs, ys, x);
     EXPECT_NEAR(expected, actual, 1e-6);
 }
+
+static void
+ExpectTableMatchesFreeFunctions(
+    std::vector<double> const& xs,
+    std::vector<double> const& ys,
+    erin::LookupMethod expectedMethod
+)
+{
+    erin::LookupTable table = erin::LookupTable_Make(xs, ys);
+    EXPECT_EQ(table.Method, expectedMethod);
+    double lo = xs.front() - 2.0;
+    double hi = xs.back() + 2.0;
+    // NOTE: sweep back and forth so the cursor has to move both ways
+    std::vector<double> queries(xs.begin(), xs.end());
+    for (size_t i = 0; i <= 1'000; ++i)
+    {
+        queries.push_back(lo + (hi - lo) * static_cast<double>(i) / 1'000.0);
+    }
+    for (size_t i = 0; i <= 1'000; ++i)
+    {
+        queries.push_back(hi - (hi - lo) * static_cast<double>(i) / 997.0);
+    }
+    size_t interpCursor = 0;
+    size_t stairStepCursor = 0;
+    for (double x : queries)
+    {
+        EXPECT_EQ(
+            erin::LookupTable_Interp(table, x),
+            erin::LookupTable_LookupInterp(xs, ys, x)
+        ) << "x = " << x;
+        EXPECT_EQ(
+            erin::LookupTable_StairStep(table, x),
+            erin::LookupTable_LookupStairStep(xs, ys, x)
+        ) << "x = " << x;
+        EXPECT_EQ(
+            erin::LookupTable_Interp(table, x, interpCursor),
+            erin::LookupTable_LookupInterp(xs, ys, x)
+        ) << "x = " << x;
+        EXPECT_EQ(
+            erin::LookupTable_StairStep(table, x, stairStepCursor),
+            erin::LookupTable_LookupStairStep(xs, ys, x)
+        ) << "x = " << x;
+    }
+}
+
+TEST(LookupTable, TestTableMatchesFreeFunctions)
+{
+    ExpectTableMatchesFreeFunctions(
+        {0.0, 10.0, 20.0, 30.0, 40.0},
+        {0.5, 0.7, 0.85, 0.9, 0.8},
+        erin::LookupMethod::UniformGrid
+    );
+    ExpectTableMatchesFreeFunctions(
+        {0.0, 0.1, 0.3, 0.7, 3.0},
+        {1.0, 2.0, 4.0, 3.0, 3.5},
+        erin::LookupMethod::Cursor
+    );
+    std::vector<double> xs;
+    std::vector<double> ys;
+    for (size_t i = 0; i < 40; ++i)
+    {
+        double x = static_cast<double>(i);
+        xs.push_back(x * x / 3.0);
+        ys.push_back(std::sin(x));
+    }
+    ExpectTableMatchesFreeFunctions(xs, ys, erin::LookupMethod::Binary);
+    // NOTE: inflow-based efficiency tables need not be increasing
+    ExpectTableMatchesFreeFunctions(
+        {0.0, 12.0, 11.0, 30.0},
+        {0.4, 0.9, 1.0, 0.95},
+        erin::LookupMethod::Scan
+    );
+}
+
+TEST(LookupTable, TestCursorBelongsToTheCaller)
+{
+    erin::LookupTable const table = erin::LookupTable_Make(
+        {0.0, 0.1, 0.3, 0.7, 3.0}, {1.0, 2.0, 4.0, 3.0, 3.5}
+    );
+    ASSERT_EQ(table.Method, erin::LookupMethod::Cursor);
+    size_t near = 0;
+    size_t far = 0;
+    EXPECT_DOUBLE_EQ(erin::LookupTable_Interp(table, 0.2, near), 3.0);
+    EXPECT_EQ(near, 1);
+    EXPECT_DOUBLE_EQ(erin::LookupTable_Interp(table, 1.85, far), 3.25);
+    EXPECT_EQ(far, 3);
+    // NOTE: one caller's lookups do not move another's cursor
+    EXPECT_EQ(near, 1);
+    // NOTE: a stale or out-of-range cursor is only a starting point
+    size_t stale = 100;
+    EXPECT_DOUBLE_EQ(erin::LookupTable_Interp(table, 0.05, stale), 1.5);
+    EXPECT_EQ(stale, 0);
+}
+
+TEST(LookupTable, TestInterpBySlope)
+{
+    std::vector<double> xs{0.0, 1.0, 4.0, 6.0, 9.0, 10.0};
+    std::vector<double> ys{0.0, 0.3, 0.7, 0.8, 0.95, 1.0};
+    erin::LookupTable table = erin::LookupTable_Make(xs, ys);
+    EXPECT_EQ(erin::LookupTable_InterpBySlope(table, -1.0), 0.0);
+    EXPECT_EQ(erin::LookupTable_InterpBySlope(table, 7.0), 0.85);
+    EXPECT_EQ(erin::LookupTable_InterpBySlope(table, 12.0), 1.0);
+    // NOTE: segments are closed on the right
+    EXPECT_EQ(
+        erin::LookupTable_InterpBySlope(table, 4.0),
+        0.3 + (3.0 * ((0.7 - 0.3) / 3.0))
+    );
+}
@@ -1,5 +1,6 @@
 #include "erin_next/erin_next_random.h"
 #include <gtest/gtest.h>
+#include <vector>
 
 std::streamsize const width = 30;
 
@@ -45,3 +46,162 @@ TEST(ErinRandom, FromClock)
         EXPECT_TRUE((r() >= 0.0) && (r() <= 1.0));
     }
 }
+
+TEST(ErinRandom, AntitheticPairs)
+{
+    erin::SampledRandom sr{};
+    sr.Type = erin::SamplingType::Antithetic;
+    sr.Base = erin::CreateRandomWithSeed(17);
+    erin::SampledRandom_StartScenario(sr, 4);
+    erin::SampledRandom_StartOccurrence(sr, 0);
+    double u0 = sr();
+    double u1 = sr();
+    erin::SampledRandom_StartOccurrence(sr, 1);
+    EXPECT_EQ(sr(), 1.0 - u0);
+    EXPECT_EQ(sr(), 1.0 - u1);
+    // NOTE: draws past those of the first occurrence are independent
+    double u2 = sr();
+    EXPECT_TRUE(u2 >= 0.0 && u2 <= 1.0);
+    erin::SampledRandom_StartOccurrence(sr, 2);
+    double v0 = sr();
+    EXPECT_NE(v0, u0);
+    erin::SampledRandom_StartOccurrence(sr, 3);
+    EXPECT_EQ(sr(), 1.0 - v0);
+}
+
+TEST(ErinRandom, LatinHypercubeStratifiesEachCoordinate)
+{
+    size_t const numOccurrences = 50;
+    size_t const numDims = 3;
+    erin::SampledRandom sr{};
+    sr.Type = erin::SamplingType::LatinHypercube;
+    sr.Base = erin::CreateRandomWithSeed(17);
+    erin::SampledRandom_StartScenario(sr, numOccurrences);
+    std::vector<std::vector<size_t>> countsByDim(
+        numDims, std::vector<size_t>(numOccurrences, 0)
+    );
+    for (size_t occIdx = 0; occIdx < numOccurrences; ++occIdx)
+    {
+        erin::SampledRandom_StartOccurrence(sr, occIdx);
+        for (size_t dim = 0; dim < numDims; ++dim)
+        {
+            erin::SampledRandom_StartStream(sr, dim);
+            double u = sr();
+            ASSERT_TRUE(u >= 0.0 && u < 1.0);
+            ++countsByDim[dim][static_cast<size_t>(
+                u * static_cast<double>(numOccurrences)
+            )];
+        }
+    }
+    for (auto const& counts : countsByDim)
+    {
+        for (size_t count : counts)
+        {
+            EXPECT_EQ(count, 1);
+        }
+    }
+}
+
+TEST(ErinRandom, LatinHypercubeStratifiesTheFirstDrawOfEachStream)
+{
+    size_t const numOccurrences = 40;
+    erin::SampledRandom sr{};
+    sr.Type = erin::SamplingType::LatinHypercube;
+    sr.Base = erin::CreateRandomWithSeed(17);
+    erin::SampledRandom_StartScenario(sr, numOccurrences);
+    std::vector<size_t> counts(numOccurrences, 0);
+    for (size_t occIdx = 0; occIdx < numOccurrences; ++occIdx)
+    {
+        erin::SampledRandom_StartOccurrence(sr, occIdx);
+        // NOTE: stream 0 makes a different number of draws per occurrence;
+        // that must not shift which coordinate stream 1 gets
+        erin::SampledRandom_StartStream(sr, 0);
+        for (size_t i = 0; i <= occIdx % 3; ++i)
+        {
+            sr();
+        }
+        erin::SampledRandom_StartStream(sr, 1);
+        double u = sr();
+        ASSERT_TRUE(u >= 0.0 && u < 1.0);
+        ++counts[static_cast<size_t>(u * static_cast<double>(numOccurrences))];
+    }
+    for (size_t count : counts)
+    {
+        EXPECT_EQ(count, 1);
+    }
+    EXPECT_EQ(sr.Strata.size(), 2);
+}
+
+TEST(ErinRandom, LatinHypercubeStratifiesOnlyLeadingCoordinates)
+{
+    size_t const numOccurrences = 1'000;
+    size_t const numDims = 200;
+    erin::SampledRandom sr{};
+    sr.Type = erin::SamplingType::LatinHypercube;
+    sr.Base = erin::CreateRandomWithSeed(17);
+    erin::SampledRandom_StartScenario(sr, numOccurrences);
+    for (size_t occIdx = 0; occIdx < 3; ++occIdx)
+    {
+        erin::SampledRandom_StartOccurrence(sr, occIdx);
+        for (size_t dim = 0; dim < numDims; ++dim)
+        {
+            erin::SampledRandom_StartStream(sr, dim);
+            double u = sr();
+            ASSERT_TRUE(u >= 0.0 && u < 1.0);
+        }
+    }
+    EXPECT_EQ(sr.Strata.size(), erin::Sobol_NumDimensions());
+}
+
+TEST(ErinRandom, SobolStratifiesEachCoordinate)
+{
+    size_t const numPoints = 64;
+    erin::SampledRandom sr{};
+    sr.Type = erin::SamplingType::Sobol;
+    sr.Base = erin::CreateRandomWithSeed(17);
+    erin::SampledRandom_StartScenario(sr, numPoints);
+    std::vector<std::vector<size_t>> countsByDim(
+        erin::Sobol_NumDimensions(), std::vector<size_t>(numPoints, 0)
+    );
+    for (size_t occIdx = 0; occIdx < numPoints; ++occIdx)
+    {
+        erin::SampledRandom_StartOccurrence(sr, occIdx);
+        for (size_t dim = 0; dim < erin::Sobol_NumDimensions(); ++dim)
+        {
+            erin::SampledRandom_StartStream(sr, dim);
+            double u = sr();
+            ASSERT_TRUE(u > 0.0 && u < 1.0);
+            ++countsByDim[dim][static_cast<size_t>(
+                u * static_cast<double>(numPoints)
+            )];
+        }
+    }
+    for (auto const& counts : countsByDim)
+    {
+        for (size_t count : counts)
+        {
+            EXPECT_EQ(count, 1);
+        }
+    }
+    EXPECT_EQ(erin::Sobol_Point(1, 0), 0x8000'0000u);
+    EXPECT_EQ(erin::Sobol_Point(2, 1), 0xC000'0000u);
+}
+
+TEST(ErinRandom, ImportanceSamplingWeights)
+{
+    double p = 0.01;
+    double q = erin::ImportanceSampling_FailureProbability(p, 10.0);
+    EXPECT_NEAR(q / (1.0 - q), 10.0 * p / (1.0 - p), 1e-12);
+    double expectedWeight = q * erin::ImportanceSampling_Weight(p, q, true)
+        + (1.0 - q) * erin::ImportanceSampling_Weight(p, q, false);
+    EXPECT_NEAR(expectedWeight, 1.0, 1e-12);
+    EXPECT_NEAR(q * erin::ImportanceSampling_Weight(p, q, true), p, 1e-12);
+    EXPECT_EQ(erin::ImportanceSampling_FailureProbability(p, 1.0), p);
+    EXPECT_EQ(erin::ImportanceSampling_FailureProbability(1.0, 10.0), 1.0);
+    EXPECT_EQ(erin::SamplingTypeToTag(erin::SamplingType::Sobol), "sobol");
+    EXPECT_EQ(
+        erin::TagToSamplingType("latin_hypercube"),
+        erin::SamplingType::LatinHypercube
+    );
+    EXPECT_FALSE(erin::TagToSamplingType("bogus").has_value());
+}
@@ -2,13 +2,25 @@
  * See the LICENSE.txt file for additional terms and conditions. */
 #include "erin_next/erin_next.h"
 #include "erin_next/erin_next_distribution.h"
+#include "erin_next/erin_next_profile.h"
+#include "erin_next/erin_next_random.h"
 #include "erin_next/erin_next_reliability.h"
 #include "erin_next/erin_next_simulation.h"
+#include "erin_next/erin_next_synthetic.h"
 #include "erin_next/erin_next_timestate.h"
+#include "erin_next/erin_next_toml.h"
+#include "erin_next/erin_next_trace.h"
+#include "erin_next/erin_next_validation.h"
 #include "gtest/gtest.h"
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
 #include <optional>
+#include <sstream>
+#include <thread>
 #include <unordered_map>
+#include <unordered_set>
 
 using namespace erin;
 
@@ -105,6 +117,249 @@ TEST(ErinSim, TestCreateFailureSchedulesWithInitialAgeAndOffset)
     }
 }
 
+TEST(ErinSim, TestCreateFailureSchedulesClippedMatchesClip)
+{
+    DistributionSystem ds{};
+    ReliabilityCoordinator rc{};
+    size_t breakDistId = ds.add_fixed("break", 10.0);
+    size_t fixDistId = ds.add_fixed("fix", 2.0);
+    size_t slowBreakDistId = ds.add_fixed("slow break", 25.0);
+    size_t slowFixDistId = ds.add_fixed("slow fix", 5.0);
+    size_t fmId = rc.add_failure_mode("fm", breakDistId, fixDistId);
+    size_t slowFmId =
+        rc.add_failure_mode("slow fm", slowBreakDistId, slowFixDistId);
+    rc.link_component_with_failure_mode(0, fmId);
+    rc.link_component_with_failure_mode(0, slowFmId);
+    rc.link_component_with_failure_mode(1, slowFmId);
+    std::vector<size_t> componentFailureModeComponentIds{0, 0, 1};
+    std::vector<size_t> componentFailureModeFailureModeIds{
+        fmId, slowFmId, slowFmId
+    };
+    std::vector<double> componentInitialAges_s{12.0, 0.0};
+    double scenarioDuration_s = 144.0;
+    double scenarioOffset_s = 24.0;
+    auto randFn = []() { return 0.5; };
+    std::unordered_map<size_t, std::vector<TimeState>> unclipped =
+        CreateFailureSchedules(
+            componentFailureModeComponentIds,
+            componentFailureModeFailureModeIds,
+            componentInitialAges_s,
+            rc,
+            randFn,
+            ds,
+            scenarioDuration_s,
+            scenarioOffset_s
+        );
+    std::unordered_map<size_t, std::vector<TimeState>> clipped =
+        CreateFailureSchedules(
+            componentFailureModeComponentIds,
+            componentFailureModeFailureModeIds,
+            componentInitialAges_s,
+            rc,
+            randFn,
+            ds,
+            scenarioDuration_s,
+            scenarioOffset_s,
+            true
+        );
+    EXPECT_EQ(unclipped.size(), 2);
+    EXPECT_EQ(clipped.size(), 2);
+    for (auto const& pair : unclipped)
+    {
+        double age_s = componentInitialAges_s[pair.first];
+        std::vector<TimeState> expected = TimeState_Clip(
+            pair.second,
+            age_s + scenarioOffset_s,
+            age_s + scenarioOffset_s + scenarioDuration_s,
+            true
+        );
+        ASSERT_TRUE(clipped.contains(pair.first));
+        EXPECT_EQ(expected, clipped.at(pair.first));
+    }
+}
+
+TEST(ErinSim, TestSampleNMatchesNextTimeAdvance)
+{
+    DistributionSystem ds{};
+    std::vector<size_t> distIds{
+        ds.add_fixed("fixed", 10.0),
+        ds.add_uniform("uniform", 2.5, 20.0),
+        ds.add_normal("normal", 100.0, 30.0),
+        ds.add_weibull("weibull", 1.5, 50.0, 5.0),
+        ds.add_quantile_table(
+            "table", {0.0, 0.25, 0.75, 1.0}, {1.0, 10.0, 40.0, 90.0}
+        ),
+    };
+    std::vector<double> fractions{
+        0.0, 0.1, 0.25, 0.3, 0.5, 0.75, 0.9, 0.9999, 0.99999, 1.0
+    };
+    for (size_t i = 0; i < 100; ++i)
+    {
+        fractions.push_back(static_cast<double>(i) / 100.0 + 0.003);
+    }
+    std::vector<double> out(fractions.size(), 0.0);
+    for (size_t distId : distIds)
+    {
+        ds.sample_n(distId, fractions, out);
+        double maxAdvance = ds.max_time_advance(distId);
+        double boundedAdvance =
+            ds.max_time_advance(distId, max_batch_fraction);
+        EXPECT_TRUE(std::isfinite(boundedAdvance));
+        for (size_t i = 0; i < fractions.size(); ++i)
+        {
+            EXPECT_EQ(ds.next_time_advance(distId, fractions[i]), out[i])
+                << "distId = " << distId << ", fraction = " << fractions[i];
+            EXPECT_LE(out[i], maxAdvance);
+            if (fractions[i] <= max_batch_fraction)
+            {
+                EXPECT_LE(out[i], boundedAdvance);
+            }
+        }
+    }
+}
+
+TEST(ErinSim, TestMakeScheduleForLinkMatchesScalarDraws)
+{
+    DistributionSystem ds{};
+    ReliabilityCoordinator rc{};
+    size_t breakDistId = ds.add_weibull("break", 2.0, 3'600.0, 600.0);
+    size_t fixDistId = ds.add_normal("fix", 300.0, 60.0);
+    size_t fmId = rc.add_failure_mode("fm", breakDistId, fixDistId);
+    size_t linkId = rc.link_component_with_failure_mode(0, fmId);
+    double finalTime_s = 10.0 * 8'760.0 * 3'600.0;
+    // NOTE: the bounded cycle leaves room for many batched cycles even
+    // though both distributions are unbounded
+    double maxCycle_s = ds.max_time_advance(breakDistId, max_batch_fraction)
+        + ds.max_time_advance(fixDistId, max_batch_fraction);
+    ASSERT_TRUE(std::isfinite(maxCycle_s));
+    EXPECT_GT(finalTime_s / maxCycle_s, 1'000.0);
+    // NOTE: the second case forces a failure fraction (draw 101) and a
+    // repair fraction (draw 2,000) above max_batch_fraction to end batches
+    std::vector<std::vector<size_t>> extremeDrawCases{{}, {101, 2'000}};
+    for (std::vector<size_t> const& extremeDraws : extremeDrawCases)
+    {
+        auto makeFractions = [&extremeDraws]()
+        {
+            return [&extremeDraws,
+                    random = CreateRandomWithSeed(17),
+                    numDraws = size_t{0}]() mutable
+            {
+                ++numDraws;
+                double fraction = random();
+                bool isExtreme =
+                    std::find(
+                        extremeDraws.begin(), extremeDraws.end(), numDraws
+                    )
+                    != extremeDraws.end();
+                return isExtreme ? 1.0 - 1.0e-9 : fraction;
+            };
+        };
+        auto fractions = makeFractions();
+        size_t numDraws = 0;
+        std::function<double()> randFn = [&]()
+        {
+            ++numDraws;
+            return fractions();
+        };
+        std::vector<TimeState> actual =
+            rc.make_schedule_for_link(linkId, randFn, ds, finalTime_s);
+        // NOTE: only the fractions actually used may be drawn
+        EXPECT_EQ(numDraws, actual.size());
+        auto reference = makeFractions();
+        double time_s = 0.0;
+        for (size_t i = 0; i < actual.size(); ++i)
+        {
+            bool isFailure = (i % 2) == 0;
+            time_s += ds.next_time_advance(
+                isFailure ? breakDistId : fixDistId, reference()
+            );
+            EXPECT_EQ(actual[i].time, time_s);
+            EXPECT_EQ(actual[i].state, !isFailure);
+        }
+        ASSERT_TRUE(actual.size() > 2'000);
+        EXPECT_TRUE(actual.back().time >= finalTime_s);
+        EXPECT_TRUE(actual[actual.size() - 2].time < finalTime_s);
+    }
+}
+
+TEST(ErinSim, TestBatchedOccurrenceTimesMatchScalarDraws)
+{
+    std::string input = R"toml(
+[simulation_info]
+input_format_version = "0.2"
+rate_unit = "kW"
+quantity_unit = "kJ"
+time_unit = "years"
+max_time = 100
+[loads.building]
+time_unit = "hours"
+rate_unit = "kW"
+time_rate_pairs = [[0.0, 1.0], [4.0, 0.0]]
+[components.utility]
+type = "source"
+outflow = "electricity"
+[components.building]
+type = "load"
+inflow = "electricity"
+loads_by_scenario.storm = "building"
+[network]
+connections = [["utility:OUT(0)", "building:IN(0)", "electricity"]]
+[dist.every_month]
+type = "normal"
+time_unit = "hours"
+mean = 730.0
+standard_deviation = 200.0
+[scenarios.storm]
+time_unit = "hours"
+occurrence_distribution = "every_month"
+duration = 4
+max_occurrences = 2000
+)toml";
+    std::istringstream iss{input};
+    toml::value data = toml::parse(iss, "occurrences.toml");
+    InputValidationMap validationInfo = SetupGlobalValidationInfo();
+    auto maybeSim = Simulation_ReadFromToml(
+        data, validationInfo, TOMLTable_ParseComponentTagsInUse(data)
+    );
+    ASSERT_TRUE(maybeSim.has_value());
+    Simulation& s = maybeSim.value();
+    size_t distId = s.ScenarioMap.OccurrenceDistributionIds[0];
+    double maxTime_s = Time_ToSeconds(s.Info.MaxTime, s.Info.TheTimeUnit);
+    double maxAdvance_s =
+        s.TheModel.DistSys.max_time_advance(distId, max_batch_fraction);
+    ASSERT_TRUE(std::isfinite(maxAdvance_s));
+    EXPECT_GT(maxTime_s / maxAdvance_s, 100.0);
+    DistributionSystem reference = s.TheModel.DistSys;
+    std::vector<double> actual = DetermineScenarioOccurrenceTimes(s, 0);
+    std::vector<double> expected;
+    double time_s = 0.0;
+    for (size_t i = 0; i < 2'000; ++i)
+    {
+        time_s += reference.next_time_advance(distId);
+        if (time_s > maxTime_s)
+        {
+            break;
+        }
+        expected.push_back(time_s);
+    }
+    EXPECT_GT(expected.size(), 1'000);
+    EXPECT_EQ(actual, expected);
+    // NOTE: a bounded batch ends after its first fraction above the bound
+    DistributionSystem bounded = reference;
+    std::vector<double> advances_s(100, 0.0);
+    size_t numDrawn = bounded.sample_n(distId, advances_s, 0.5);
+    ASSERT_GT(numDrawn, 0);
+    ASSERT_LT(numDrawn, advances_s.size());
+    for (size_t i = 0; i < numDrawn; ++i)
+    {
+        EXPECT_EQ(advances_s[i], reference.next_time_advance(distId));
+    }
+    EXPECT_GT(advances_s[numDrawn - 1], bounded.max_time_advance(distId, 0.5));
+    EXPECT_EQ(
+        bounded.next_time_advance(distId), reference.next_time_advance(distId)
+    );
+}
+
 std::vector<ScheduleBasedReliability>
 RunApplyReliabilitiesAndFragilities(
     double scenarioOffset_s,
@@ -519,3 +774,612 @@ TEST(ErinSim, TestFragility_Reliability_Repair_Offset_Age)
         }
     }
 }
+
+TEST(ErinSim, TestLatinHypercubeStratifiesEachFragilityDraw)
+{
+    // NOTE: component 0 has a failure mode whose number of draws varies by
+    // occurrence; component 1 fails from a fragility with probability 1/4.
+    // With the fragility draw on its own stream, its marginal is stratified
+    // so exactly a quarter of the occurrences see the fragility failure.
+    size_t const numOccurrences = 40;
+    DistributionSystem ds{};
+    ReliabilityCoordinator rc{};
+    size_t breakDistId = ds.add_uniform("break", 0.0, 50.0);
+    size_t fixDistId = ds.add_fixed("fix", 10.0);
+    size_t fmId = rc.add_failure_mode("fm", breakDistId, fixDistId);
+    rc.link_component_with_failure_mode(0, fmId);
+    std::vector<size_t> componentFailureModeComponentIds{0};
+    std::vector<size_t> componentFailureModeFailureModeIds{fmId};
+    std::vector<double> componentInitialAges_s{0.0, 0.0};
+    std::vector<std::string> componentTags{"S", "L"};
+    std::vector<size_t> componentFragilityComponentIds{1};
+    std::vector<size_t> componentFragilityFragilityModeIds{0};
+    std::vector<size_t> fragilityModeFragilityCurveIds{0};
+    std::vector<std::optional<size_t>> fragilityModeRepairDistIds{{}};
+    std::vector<std::string> fragilityModeTags{"vulnerable_to_wind"};
+    std::vector<size_t> fragilityCurveCurveIds{0};
+    std::vector<FragilityCurveType> fragilityCurveCurveTypes{
+        FragilityCurveType::Linear
+    };
+    std::vector<LinearFragilityCurve> linearFragilityCurves{
+        {.VulnerabilityId = 0, .LowerBound = 80.0, .UpperBound = 140.0}
+    };
+    std::vector<TabularFragilityCurve> tabularFragilityCurves{};
+    std::unordered_map<size_t, double> intensityIdToAmount{{0, 95.0}};
+    double scenarioDuration_s = 200.0;
+    Log log{};
+    SampledRandom sr{};
+    sr.Type = SamplingType::LatinHypercube;
+    sr.Base = CreateRandomWithSeed(17);
+    std::function<double()> randFn = std::ref(sr);
+    SampledRandom_StartScenario(sr, numOccurrences);
+    size_t numFragilityFailures = 0;
+    std::unordered_set<size_t> failureDrawCounts;
+    for (size_t occIdx = 0; occIdx < numOccurrences; ++occIdx)
+    {
+        SampledRandom_StartOccurrence(sr, occIdx);
+        std::unordered_map<size_t, std::vector<TimeState>> relSchByCompId =
+            CreateFailureSchedules(
+                componentFailureModeComponentIds,
+                componentFailureModeFailureModeIds,
+                componentInitialAges_s,
+                rc,
+                randFn,
+                ds,
+                scenarioDuration_s,
+                0.0,
+                true,
+                &sr
+            );
+        failureDrawCounts.insert(sr.StreamDrawIdx);
+        std::vector<ScheduleBasedReliability> reliabilities =
+            ApplyReliabilitiesAndFragilities(
+                randFn,
+                componentFailureModeComponentIds,
+                componentInitialAges_s,
+                componentTags,
+                componentFragilityComponentIds,
+                componentFragilityFragilityModeIds,
+                fragilityModeFragilityCurveIds,
+                fragilityModeRepairDistIds,
+                fragilityModeTags,
+                fragilityCurveCurveIds,
+                fragilityCurveCurveTypes,
+                linearFragilityCurves,
+                tabularFragilityCurves,
+                ds,
+                0.0,
+                scenarioDuration_s,
+                intensityIdToAmount,
+                relSchByCompId,
+                false,
+                log,
+                true,
+                1.0,
+                nullptr,
+                &sr
+            );
+        for (ScheduleBasedReliability const& sbr : reliabilities)
+        {
+            if (sbr.ComponentId == 1)
+            {
+                ++numFragilityFailures;
+            }
+        }
+    }
+    EXPECT_GT(failureDrawCounts.size(), 1);
+    EXPECT_EQ(numFragilityFailures, numOccurrences / 4);
+}
+
+TEST(ErinSim, TestReliabilitiesAreFailureFree)
+{
+    std::vector<ScheduleBasedReliability> none{};
+    EXPECT_TRUE(Reliabilities_AreFailureFree(none));
+    TimeState up{};
+    up.time = 0.0;
+    up.state = true;
+    ScheduleBasedReliability upOnly{};
+    upOnly.ComponentId = 1;
+    upOnly.TimeStates = {up};
+    std::vector<ScheduleBasedReliability> allUp{upOnly};
+    EXPECT_TRUE(Reliabilities_AreFailureFree(allUp));
+    EXPECT_FALSE(Reliabilities_AreEqual(none, allUp));
+    EXPECT_TRUE(Reliabilities_AreEqual(allUp, allUp));
+    ScheduleBasedReliability down = upOnly;
+    TimeState fail{};
+    fail.time = 10.0;
+    fail.state = false;
+    down.TimeStates.push_back(fail);
+    std::vector<ScheduleBasedReliability> withFailure{down};
+    EXPECT_FALSE(Reliabilities_AreFailureFree(withFailure));
+    EXPECT_FALSE(Reliabilities_AreEqual(allUp, withFailure));
+}
+
+TEST(ErinSim, TestMidHorizonFailureResumesFromSnapshot)
+{
+    std::vector<TimeAndAmount> timesAndLoads = {};
+    for (size_t i = 0; i < 10; ++i)
+    {
+        timesAndLoads.push_back(
+            {static_cast<double>(i) * 10.0, static_cast<flow_t>(5 + (i % 3))}
+        );
+    }
+    Model m = {};
+    m.FinalTime = 100.0;
+    auto srcId = Model_AddConstantSource(m, 4);
+    auto storeId = Model_AddStore(m, 100, 10, 10, 0, 100);
+    auto convId = Model_AddConstantEfficiencyConverter(m, 1, 1);
+    auto loadId = Model_AddScheduleBasedLoad(m, timesAndLoads);
+    Model_AddConnection(m, srcId, 0, storeId, 0);
+    Model_AddConnection(m, storeId, 0, convId.Id, 0);
+    Model_AddConnection(m, convId.Id, 0, loadId, 0);
+    // NOTE: a clipped schedule as made for an occurrence; the converter is
+    // up from the start, fails at 55 s, and is repaired at 72 s
+    TimeState up{};
+    up.time = 0.0;
+    up.state = true;
+    TimeState down{};
+    down.time = 55.0;
+    down.state = false;
+    TimeState repaired{};
+    repaired.time = 72.0;
+    repaired.state = true;
+    ScheduleBasedReliability sbr{};
+    sbr.ComponentId = convId.Id;
+    sbr.TimeStates = {up, down, repaired};
+    ScheduleBasedReliability srcUp{};
+    srcUp.ComponentId = srcId;
+    srcUp.TimeStates = {up};
+    m.Reliabilities = {srcUp, sbr};
+    double firstEvent_s = Reliabilities_FirstEventTime(m.Reliabilities);
+    EXPECT_EQ(firstEvent_s, down.time);
+    auto expected = Simulate(m, false);
+    BaselineSimulation baseline{};
+    baseline.SnapshotInterval_s = 25.0;
+    BaselineSimulation_AdvanceTo(baseline, m, firstEvent_s);
+    SimulationSnapshot const* snapshot =
+        BaselineSimulation_FindSnapshot(baseline, firstEvent_s);
+    ASSERT_TRUE(snapshot != nullptr);
+    EXPECT_GT(snapshot->Time, 0.0);
+    EXPECT_LT(snapshot->Time, down.time);
+    auto actual = Simulate_FromSnapshot(m, *snapshot, baseline.Results);
+    ASSERT_EQ(actual.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+        EXPECT_EQ(actual[i].Time, expected[i].Time);
+        EXPECT_EQ(actual[i].StorageAmounts_J, expected[i].StorageAmounts_J);
+        ASSERT_EQ(actual[i].Flows.size(), expected[i].Flows.size());
+        for (size_t j = 0; j < expected[i].Flows.size(); ++j)
+        {
+            EXPECT_EQ(
+                actual[i].Flows[j].Actual_W, expected[i].Flows[j].Actual_W
+            );
+            EXPECT_EQ(
+                actual[i].Flows[j].Requested_W,
+                expected[i].Flows[j].Requested_W
+            );
+        }
+    }
+    // a fragility hit at time 0 leaves nothing to resume from
+    TimeState hit{};
+    hit.time = 0.0;
+    hit.state = false;
+    hit.fragilityModeCauses.insert(0);
+    ScheduleBasedReliability fragile{};
+    fragile.ComponentId = loadId;
+    fragile.TimeStates = {hit};
+    m.Reliabilities.push_back(fragile);
+    EXPECT_EQ(Reliabilities_FirstEventTime(m.Reliabilities), 0.0);
+    std::vector<ScheduleBasedReliability> allUp{srcUp};
+    EXPECT_EQ(Reliabilities_FirstEventTime(allUp), infinity);
+}
+
+TEST(ErinSim, TestShardSpec)
+{
+    auto shard = ShardSpec_Parse("2/3");
+    ASSERT_TRUE(shard.has_value());
+    EXPECT_EQ(shard->Index, 2);
+    EXPECT_EQ(shard->Count, 3);
+    EXPECT_FALSE(ShardSpec_Parse("0/3").has_value());
+    EXPECT_FALSE(ShardSpec_Parse("4/3").has_value());
+    EXPECT_FALSE(ShardSpec_Parse("2").has_value());
+    EXPECT_FALSE(ShardSpec_Parse("-1/3").has_value());
+    EXPECT_FALSE(ShardSpec_Parse("1/").has_value());
+    size_t const numPairs = 10;
+    size_t expectedFirst = 0;
+    for (size_t idx = 1; idx <= 3; ++idx)
+    {
+        auto [first, last] = ShardSpec_PairRange(
+            ShardSpec{.Index = idx, .Count = 3}, numPairs
+        );
+        EXPECT_EQ(first, expectedFirst);
+        EXPECT_GE(last - first, 3);
+        EXPECT_LE(last - first, 4);
+        expectedFirst = last;
+    }
+    EXPECT_EQ(expectedFirst, numPairs);
+    EXPECT_EQ(
+        ShardSpec_FilePath("out/events.csv", ShardSpec{.Index = 2, .Count = 4}),
+        "out/events.shard-2-of-4.csv"
+    );
+    EXPECT_EQ(
+        ShardSpec_FilePath("stats.csv", ShardSpec{.Index = 1, .Count = 1}),
+        "stats.csv"
+    );
+}
+
+TEST(ErinSim, TestSyntheticModelReads)
+{
+    SyntheticModelOptions options{};
+    options.NumBuildings = 12;
+    options.NetworkDepth = 3;
+    options.StorageFraction = 0.5;
+    options.FailureModeDensity = 1.0;
+    options.NumScenarios = 3;
+    SyntheticModel model = SyntheticModel_Generate(options);
+    EXPECT_TRUE(model.LoadFiles.empty());
+    std::istringstream iss{model.Toml};
+    toml::value data = toml::parse(iss, "synthetic.toml");
+    InputValidationMap validationInfo = SetupGlobalValidationInfo();
+    auto maybeSim = Simulation_ReadFromToml(
+        data, validationInfo, TOMLTable_ParseComponentTagsInUse(data)
+    );
+    ASSERT_TRUE(maybeSim.has_value());
+    EXPECT_EQ(maybeSim->ScenarioMap.Tags.size(), options.NumScenarios);
+    EXPECT_EQ(SyntheticModel_Generate(options).Toml, model.Toml);
+    SyntheticModel withFiles = SyntheticModel_Generate(options, "loads-");
+    EXPECT_EQ(withFiles.LoadFiles.size(), 2 * options.NumLoadProfiles);
+}
+
+TEST(ErinSim, TestSyntheticModelSimulates)
+{
+    SyntheticModelOptions options{};
+    options.NumBuildings = 6;
+    options.NetworkDepth = 2;
+    options.StorageFraction = 0.5;
+    options.FailureModeDensity = 0.5;
+    options.NumScenarios = 2;
+    options.NumOccurrences = 3;
+    options.NumLoadProfiles = 2;
+    options.ScenarioDuration_h = 72.0;
+    options.Seed = 5;
+    SyntheticModel model = SyntheticModel_Generate(options);
+    std::istringstream iss{model.Toml};
+    toml::value data = toml::parse(iss, "synthetic.toml");
+    InputValidationMap validationInfo = SetupGlobalValidationInfo();
+    auto maybeSim = Simulation_ReadFromToml(
+        data, validationInfo, TOMLTable_ParseComponentTagsInUse(data)
+    );
+    ASSERT_TRUE(maybeSim.has_value());
+    Simulation& s = maybeSim.value();
+    EXPECT_TRUE(Model_CheckNetwork(s.TheModel).empty());
+    std::filesystem::path dir = std::filesystem::temp_directory_path();
+    std::string eventsPath = (dir / "erin-synthetic-out.csv").string();
+    std::string statsPath = (dir / "erin-synthetic-stats.csv").string();
+    // NOTE: the courier log throws on any logged error
+    Logger logger{};
+    Log log = Log_MakeFromCourier(logger);
+    SimulationRunMetrics metrics =
+        Simulation_Run(s, log, eventsPath, statsPath);
+    EXPECT_GE(metrics.OccurrencesSimulated, options.NumScenarios);
+    EXPECT_GT(metrics.EventsSimulated, metrics.OccurrencesSimulated);
+    EXPECT_GT(std::filesystem::file_size(eventsPath), 0);
+    EXPECT_GT(std::filesystem::file_size(statsPath), 0);
+    std::filesystem::remove(eventsPath);
+    std::filesystem::remove(statsPath);
+}
+
+static std::string
+ReadFileToString(std::string const& path)
+{
+    std::ifstream ifs{path};
+    std::ostringstream oss{};
+    oss << ifs.rdbuf();
+    return oss.str();
+}
+
+TEST(ErinSim, TestMergedShardsMatchUnshardedRun)
+{
+    SyntheticModelOptions options{};
+    options.NumBuildings = 6;
+    options.NetworkDepth = 2;
+    options.StorageFraction = 0.5;
+    options.FailureModeDensity = 0.5;
+    options.NumScenarios = 2;
+    options.NumOccurrences = 3;
+    options.NumLoadProfiles = 2;
+    options.ScenarioDuration_h = 72.0;
+    options.Seed = 5;
+    SyntheticModel model = SyntheticModel_Generate(options);
+    InputValidationMap validationInfo = SetupGlobalValidationInfo();
+    std::filesystem::path dir = std::filesystem::temp_directory_path();
+    Logger logger{};
+    Log log = Log_MakeFromCourier(logger);
+    auto run = [&](std::string const& eventsPath,
+                   std::string const& statsPath,
+                   std::optional<ShardSpec> const& shard)
+    {
+        std::istringstream iss{model.Toml};
+        toml::value data = toml::parse(iss, "synthetic.toml");
+        auto maybeSim = Simulation_ReadFromToml(
+            data, validationInfo, TOMLTable_ParseComponentTagsInUse(data)
+        );
+        ASSERT_TRUE(maybeSim.has_value());
+        Simulation_Run(
+            maybeSim.value(),
+            log,
+            eventsPath,
+            statsPath,
+            -1.0,
+            true,
+            false,
+            false,
+            shard
+        );
+    };
+    std::string unshardedEventsPath =
+        (dir / "erin-unsharded-out.csv").string();
+    std::string unshardedStatsPath =
+        (dir / "erin-unsharded-stats.csv").string();
+    run(unshardedEventsPath, unshardedStatsPath, {});
+    std::string eventsPath = (dir / "erin-sharded-out.csv").string();
+    std::string statsPath = (dir / "erin-sharded-stats.csv").string();
+    for (size_t idx = 1; idx <= 2; ++idx)
+    {
+        run(eventsPath, statsPath, ShardSpec{.Index = idx, .Count = 2});
+    }
+    ASSERT_EQ(
+        Simulation_MergeShards(eventsPath, statsPath, 2, log), Result::Success
+    );
+    std::string unshardedEvents = ReadFileToString(unshardedEventsPath);
+    EXPECT_GT(unshardedEvents.size(), 0);
+    EXPECT_EQ(ReadFileToString(eventsPath), unshardedEvents);
+    EXPECT_EQ(
+        ReadFileToString(statsPath), ReadFileToString(unshardedStatsPath)
+    );
+    for (std::string const& path :
+         {unshardedEventsPath, unshardedStatsPath, eventsPath, statsPath})
+    {
+        std::filesystem::remove(path);
+    }
+    for (size_t idx = 1; idx <= 2; ++idx)
+    {
+        ShardSpec shard{.Index = idx, .Count = 2};
+        std::filesystem::remove(ShardSpec_FilePath(eventsPath, shard));
+        std::filesystem::remove(ShardSpec_FilePath(statsPath, shard));
+    }
+}
+
+TEST(ErinSim, TestConvergenceTableIsWrittenToItsOwnFile)
+{
+    std::string input = R"toml(
+[simulation_info]
+input_format_version = "0.2"
+rate_unit = "kW"
+quantity_unit = "kJ"
+time_unit = "hours"
+max_time = 1000
+random_seed = 17
+convergence_metrics = ["energy_availability"]
+convergence_tolerances = [0.5]
+min_occurrences = 2
+[loads.building]
+time_unit = "hours"
+rate_unit = "kW"
+time_rate_pairs = [[0.0, 1.0], [4.0, 0.0]]
+[components.utility]
+type = "source"
+outflow = "electricity"
+[components.building]
+type = "load"
+inflow = "electricity"
+loads_by_scenario.storm = "building"
+[network]
+connections = [["utility:OUT(0)", "building:IN(0)", "electricity"]]
+[dist.every_100_hours]
+type = "fixed"
+value = 100
+time_unit = "hours"
+[scenarios.storm]
+time_unit = "hours"
+occurrence_distribution = "every_100_hours"
+duration = 4
+max_occurrences = 10
+)toml";
+    std::istringstream iss{input};
+    toml::value data = toml::parse(iss, "convergence.toml");
+    InputValidationMap validationInfo = SetupGlobalValidationInfo();
+    auto maybeSim = Simulation_ReadFromToml(
+        data, validationInfo, TOMLTable_ParseComponentTagsInUse(data)
+    );
+    ASSERT_TRUE(maybeSim.has_value());
+    Simulation& s = maybeSim.value();
+    std::filesystem::path dir = std::filesystem::temp_directory_path();
+    std::string eventsPath = (dir / "erin-convergence-out.csv").string();
+    std::string statsPath = (dir / "erin-convergence-stats.csv").string();
+    std::string convergencePath = ConvergenceFilePath(statsPath);
+    EXPECT_EQ(
+        convergencePath,
+        (dir / "erin-convergence-stats-convergence.csv").string()
+    );
+    Logger logger{};
+    Log log = Log_MakeFromCourier(logger);
+    Simulation_Run(s, log, eventsPath, statsPath);
+    // NOTE: the statistics file stays one rectangular table
+    std::ifstream stats{statsPath};
+    std::string line;
+    ASSERT_TRUE(std::getline(stats, line));
+    size_t numColumns = std::count(line.begin(), line.end(), ',');
+    size_t numRows = 0;
+    while (std::getline(stats, line))
+    {
+        EXPECT_EQ(std::count(line.begin(), line.end(), ','), numColumns);
+        ++numRows;
+    }
+    EXPECT_GE(numRows, 2);
+    std::ifstream convergence{convergencePath};
+    ASSERT_TRUE(std::getline(convergence, line));
+    EXPECT_EQ(line.rfind("scenario tag,metric,occurrences,", 0), 0);
+    ASSERT_TRUE(std::getline(convergence, line));
+    EXPECT_EQ(line.rfind("storm,energy_availability,", 0), 0);
+    EXPECT_FALSE(std::getline(convergence, line));
+    stats.close();
+    convergence.close();
+    std::filesystem::remove(eventsPath);
+    std::filesystem::remove(statsPath);
+    std::filesystem::remove(convergencePath);
+}
+
+TEST(ErinSim, TestProfileCountsPerOccurrence)
+{
+    Profile_Count(ProfileCounter::Events);
+    EXPECT_EQ(Profile_Total(TheProfile).Counts[0], 0);
+    Profile_Enable();
+    Profile_Count(ProfileCounter::SwitchFlips);
+    Profile_BeginOccurrence("blue_sky", 1);
+    {
+        ProfileTimer outer{ProfilePhase::Simulate};
+        ProfileTimer inner{ProfilePhase::Stats};
+        Profile_Count(ProfileCounter::Events, 3);
+    }
+    Profile_EndOccurrence();
+    Profile_BeginOccurrence("blue_sky", 2);
+    Profile_Count(ProfileCounter::Events, 2);
+    Profile_EndOccurrence();
+    size_t const events = static_cast<size_t>(ProfileCounter::Events);
+    size_t const flips = static_cast<size_t>(ProfileCounter::SwitchFlips);
+    ASSERT_EQ(TheProfile.Occurrences.size(), 2);
+    EXPECT_EQ(TheProfile.Occurrences[0].ScenarioTag, "blue_sky");
+    EXPECT_EQ(TheProfile.Occurrences[1].OccurrenceNumber, 2);
+    EXPECT_EQ(TheProfile.Occurrences[0].Counts[events], 3);
+    EXPECT_EQ(TheProfile.Outside.Counts[flips], 1);
+    ProfileRecord total = Profile_Total(TheProfile);
+    EXPECT_EQ(total.Counts[events], 5);
+    EXPECT_EQ(total.Counts[flips], 1);
+    EXPECT_GE(
+        total.PhaseTimes_s[static_cast<size_t>(ProfilePhase::Simulate)], 0.0
+    );
+    EXPECT_TRUE(TheProfile.ChildTimes_s.empty());
+    Profile_Disable();
+    EXPECT_TRUE(TheProfile.Occurrences.empty());
+}
+
+TEST(ErinSim, TestTraceBuffersPerThread)
+{
+    {
+        TraceSpan span{"ignored", "test"};
+        EXPECT_FALSE(span.Active);
+    }
+    EXPECT_TRUE(TheTrace.Buffers.empty());
+    Trace_Enable();
+    {
+        TraceSpan span{"outer", "test"};
+        Trace_AddCounter("count", "\"value\": 1");
+    }
+    std::thread worker{
+        []()
+        {
+            TraceSpan span{"worker", "test"};
+            Trace_AddInstant("mark", "test", "");
+        }
+    };
+    worker.join();
+    ASSERT_EQ(TheTrace.Buffers.size(), 2);
+    ASSERT_EQ(TheTrace.Buffers[0]->Events.size(), 2);
+    EXPECT_EQ(TheTrace.Buffers[0]->Events[0].Phase, 'C');
+    EXPECT_EQ(TheTrace.Buffers[0]->Events[1].Phase, 'X');
+    ASSERT_EQ(TheTrace.Buffers[1]->Events.size(), 2);
+    EXPECT_EQ(TheTrace.Buffers[1]->Events[0].Phase, 'i');
+    EXPECT_EQ(Trace_JsonString("a\"b"), "\"a\\\"b\"");
+    // NOTE: a new trace starts new buffers for threads that traced before
+    Trace_Enable();
+    Trace_AddCounter("count", "\"value\": 2");
+    ASSERT_EQ(TheTrace.Buffers.size(), 1);
+    EXPECT_EQ(TheTrace.Buffers[0]->Events.size(), 1);
+    Trace_Disable();
+    EXPECT_TRUE(TheTrace.Buffers.empty());
+}
+
+TEST(ErinSim, TestCalculateTagOrder)
+{
+    std::vector<std::string> tags{"c", "a", "b", "a"};
+    std::vector<size_t> expected{1, 3, 2, 0};
+    EXPECT_EQ(CalculateTagOrder(tags), expected);
+    EXPECT_TRUE(CalculateTagOrder({}).empty());
+}
+
+TEST(ErinSim, TestGroupAggregationSumsAllConnections)
+{
+    std::vector<NodeConnection> nodeConns(2);
+    nodeConns[0].origConnId = {2, 0};
+    nodeConns[1].origConnId = {1};
+    GroupAggregation agg = GroupAggregation_Create(nodeConns);
+    std::vector<size_t> expectedRowStarts{0, 2, 3};
+    EXPECT_EQ(agg.RowStarts, expectedRowStarts);
+    std::vector<Flow> flows(3);
+    flows[0].Actual_W = 10;
+    flows[1].Actual_W = 20;
+    flows[2].Actual_W = 30;
+    flows[2].Requested_W = 5;
+    std::vector<Flow> nodeFlows{};
+    GroupAggregation_Apply(agg, flows, nodeFlows);
+    ASSERT_EQ(nodeFlows.size(), 2);
+    EXPECT_EQ(nodeFlows[0].Actual_W, 40);
+    EXPECT_EQ(nodeFlows[0].Requested_W, 5);
+    EXPECT_EQ(nodeFlows[1].Actual_W, 20);
+}
+
+TEST(ErinSim, TestWriteResultsChangesOnly)
+{
+    Simulation s{};
+    Simulation_Init(s);
+    std::vector<double> times_s{0.0, 3'600.0, 7'200.0, 10'800.0, 14'400.0};
+    std::vector<flow_t> flows_W{1'000, 1'000, 2'000, 2'000, 2'000};
+    std::vector<TimeAndFlows> results(times_s.size());
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        results[i].Time = times_s[i];
+        results[i].Flows.resize(1);
+        results[i].Flows[0].Actual_W = flows_W[i];
+    }
+    std::vector<size_t> connOrder{0};
+    std::ostringstream out{};
+    WriteResultsToEventFile(
+        out,
+        results,
+        s,
+        "blue_sky",
+        "P0D",
+        connOrder,
+        {},
+        {},
+        TimeUnit::Hour,
+        nullptr,
+        nullptr,
+        true
+    );
+    std::string expected = "blue_sky,P0D,0,1,0,0\n"
+                           "blue_sky,P0D,2,2,0,0\n"
+                           "blue_sky,P0D,4,2,0,0\n";
+    EXPECT_EQ(out.str(), expected);
+    // NOTE: flows that differ only below the written precision are not
+    // changes; the last row keeps the values of the last row written
+    results[3].Flows[0].Actual_W = 2'001;
+    results[4].Flows[0].Actual_W = 2'002;
+    std::ostringstream belowPrecision{};
+    WriteResultsToEventFile(
+        belowPrecision,
+        results,
+        s,
+        "blue_sky",
+        "P0D",
+        connOrder,
+        {},
+        {},
+        TimeUnit::Hour,
+        nullptr,
+        nullptr,
+        true
+    );
+    EXPECT_EQ(belowPrecision.str(), expected);
+}
@@ -104,3 +104,28 @@ TEST(Switch, TestSimulateSwitchWithLogic)
     EXPECT_EQ(src1ToSecondaryResults.value().Available_W, 250);
     EXPECT_EQ(src1ToSecondaryResults.value().Actual_W, 200);
 }
+
+TEST(Switch, TestHotspotsCountSwitchReruns)
+{
+    Model m = {};
+    auto src0 = Model_AddConstantSource(m, 100, 0, "src0");
+    auto src1 = Model_AddConstantSource(m, 250, 0, "src1");
+    auto switchIdx = Model_AddSwitch(m, 0, "ATS");
+    auto load = Model_AddConstantLoad(m, 200);
+    Model_AddConnection(m, src0, 0, switchIdx, 0, true);
+    Model_AddConnection(m, src1, 0, switchIdx, 1, true);
+    Model_AddConnection(m, switchIdx, 0, load, 0, true);
+    size_t const switchToLoadIdx = 2;
+    Hotspots_Enable();
+    Simulate(m, false, true);
+    ASSERT_GT(TheHotspots.SwitchFlips.size(), switchIdx);
+    EXPECT_EQ(TheHotspots.SwitchFlips[switchIdx], 1);
+    // NOTE: the flip re-activates the switch's outflow within the event
+    ASSERT_GT(TheHotspots.Backward.Runs.size(), switchToLoadIdx);
+    EXPECT_EQ(TheHotspots.Backward.Runs[switchToLoadIdx], 2);
+    EXPECT_EQ(TheHotspots.Backward.Reactivations[switchToLoadIdx], 1);
+    EXPECT_EQ(TheHotspots.Backward.MaxRunsPerEvent[switchToLoadIdx], 2);
+    EXPECT_TRUE(TheHotspots.Backward.Touched.empty());
+    Hotspots_Disable();
+    EXPECT_TRUE(TheHotspots.SwitchFlips.empty());
+}
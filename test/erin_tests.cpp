@@ -6,6 +6,7 @@
 #include <gtest/gtest.h>
 #include <iomanip>
 #include <limits>
+#include <thread>
 #include <unordered_set>
 #include <vector>
 #include <unordered_map>
@@ -449,6 +450,51 @@ TEST(Erin, Test8)
         << "store to load available should be 5";
 }
 
+TEST(Erin, TestStoreDoesNotDriftPastEmpty)
+{
+    // NOTE: the load repeats its amount every half second, so those events
+    // change no flows; each step drains 2.5 J from the store, which must
+    // empty exactly when 100 J at a net 5 W runs out, at 20 s
+    std::vector<TimeAndAmount> timesAndLoads;
+    for (size_t i = 0; i <= 60; ++i)
+    {
+        timesAndLoads.push_back({0.5 * static_cast<double>(i), 9});
+    }
+    Model m = {};
+    m.FinalTime = 30.0;
+    auto srcId = Model_AddConstantSource(m, 4);
+    auto storeId = Model_AddStore(m, 100, 10, 10, 0, 100);
+    auto loadId = Model_AddScheduleBasedLoad(m, timesAndLoads);
+    Model_AddConnection(m, srcId, 0, storeId, 0);
+    auto storeToLoadConn = Model_AddConnection(m, storeId, 0, loadId, 0);
+    auto results = Simulate(m, false);
+    bool emptied = false;
+    for (TimeAndFlows const& r : results)
+    {
+        ASSERT_EQ(r.StorageAmounts_J.size(), 1);
+        EXPECT_LE(r.StorageAmounts_J[0], 100);
+        if (!emptied)
+        {
+            // the stored energy stays within half a joule of 100 J - 5 W x t
+            double expected_J = 100.0 - 5.0 * r.Time;
+            EXPECT_NEAR(
+                static_cast<double>(r.StorageAmounts_J[0]), expected_J, 0.5
+            );
+        }
+        if (r.StorageAmounts_J[0] == 0 && !emptied)
+        {
+            emptied = true;
+            EXPECT_DOUBLE_EQ(r.Time, 20.0);
+            auto storeToLoad = ModelResults_GetFlowForConnection(
+                m, storeToLoadConn, r.Time, results
+            );
+            ASSERT_TRUE(storeToLoad.has_value());
+            EXPECT_EQ(storeToLoad.value().Actual_W, 4);
+        }
+    }
+    EXPECT_TRUE(emptied);
+}
+
 TEST(Erin, Test9)
 {
     std::vector<TimeAndAmount> timesAndLoads = {};
@@ -1409,6 +1455,59 @@ TEST(Erin, Test13)
     auto results = Simulate(m, false);
 }
 
+TEST(Erin, TestTwoMoversKeepTheirOwnConnections)
+{
+    Model m = {};
+    m.FinalTime = 1.0;
+    auto srcId = Model_AddConstantSource(m, 100);
+    auto muxId = Model_AddMux(m, 1, 2);
+    auto firstMover = Model_AddMover(m, 4.0);
+    auto secondMover = Model_AddMover(m, 2.0);
+    auto firstLoadId = Model_AddConstantLoad(m, 40);
+    auto secondLoadId = Model_AddConstantLoad(m, 20);
+    Model_AddConnection(m, srcId, 0, muxId, 0);
+    auto muxToFirstConn = Model_AddConnection(m, muxId, 0, firstMover.Id, 0);
+    auto muxToSecondConn = Model_AddConnection(m, muxId, 1, secondMover.Id, 0);
+    Model_AddConnection(m, firstMover.Id, 0, firstLoadId, 0);
+    Model_AddConnection(m, secondMover.Id, 0, secondLoadId, 0);
+    EXPECT_EQ(m.ComponentMap.Idx[firstMover.Id], 0);
+    EXPECT_EQ(m.ComponentMap.Idx[secondMover.Id], 1);
+    EXPECT_TRUE(Model_CheckNetwork(m).empty());
+    auto results = Simulate(m, false);
+    auto firstInflow =
+        ModelResults_GetFlowForConnection(m, muxToFirstConn, 0.0, results);
+    auto secondInflow =
+        ModelResults_GetFlowForConnection(m, muxToSecondConn, 0.0, results);
+    ASSERT_TRUE(firstInflow.has_value());
+    ASSERT_TRUE(secondInflow.has_value());
+    EXPECT_EQ(firstInflow.value().Requested_W, 10);
+    EXPECT_EQ(secondInflow.value().Requested_W, 10);
+}
+
+TEST(Erin, TestTwoVariableEfficiencyMoversKeepTheirOwnIndex)
+{
+    Model m = {};
+    auto firstMover = Model_AddVariableEfficiencyMover(
+        m,
+        std::vector<double>{0.0, 100.0},
+        std::vector<double>{4.0, 3.0},
+        0,
+        0,
+        "first"
+    );
+    auto secondMover = Model_AddVariableEfficiencyMover(
+        m,
+        std::vector<double>{0.0, 100.0},
+        std::vector<double>{2.0, 1.5},
+        0,
+        0,
+        "second"
+    );
+    EXPECT_EQ(m.ComponentMap.Idx[firstMover.Id], 0);
+    EXPECT_EQ(m.ComponentMap.Idx[secondMover.Id], 1);
+    EXPECT_EQ(m.VarEffMovers.size(), 2);
+}
+
 TEST(Erin, Test14)
 {
     Model m = {};
@@ -2033,6 +2132,42 @@ TEST(Erin, Test19)
     }
 }
 
+TEST(Erin, Test19a_TimeState_MergeAndClip)
+{
+    std::vector<TimeState> A{
+        {0.0, false, {}, {0}},
+        {100.0, true},
+    };
+    std::vector<TimeState> B{
+        {0.0, true},
+        {120.0, false, {0}},
+        {180.0, true},
+    };
+    std::vector<TimeState> C{
+        {0.0, true},
+        {60.0, false, {1}},
+        {140.0, true},
+    };
+    std::vector<TimeState> combined =
+        TimeState_Combine(TimeState_Combine(A, B), C);
+    std::vector<TimeState> actual;
+    TimeState_MergeAndClip(
+        {&A, &B, &C},
+        -std::numeric_limits<double>::infinity(),
+        std::numeric_limits<double>::infinity(),
+        false,
+        actual
+    );
+    EXPECT_EQ(combined, actual);
+    for (bool rezero : {false, true})
+    {
+        std::vector<TimeState> expected =
+            TimeState_Clip(combined, 80.0, 150.0, rezero);
+        TimeState_MergeAndClip({&C, &A, &B}, 80.0, 150.0, rezero, actual);
+        EXPECT_EQ(expected, actual);
+    }
+}
+
 TEST(Erin, Test20)
 {
     std::vector<TimeState> input{
@@ -2143,6 +2278,77 @@ TEST(Erin, Test21)
     }
 }
 
+TEST(Erin, Test21a_CauseSet_IsInterned)
+{
+    CauseSet empty{};
+    EXPECT_TRUE(empty.empty());
+    EXPECT_EQ(empty.size(), 0);
+    CauseSet a{3, 1, 3};
+    EXPECT_EQ(a.size(), 2);
+    EXPECT_TRUE(a.contains(1));
+    EXPECT_TRUE(a.contains(3));
+    EXPECT_FALSE(a.contains(2));
+    std::vector<size_t> ids{a.begin(), a.end()};
+    EXPECT_EQ(ids, (std::vector<size_t>{1, 3}));
+    CauseSet b{};
+    b.insert(3);
+    b.insert(1);
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(a.GetId(), b.GetId());
+    CauseSet c = CauseSet_Union(b, CauseSet{2});
+    EXPECT_EQ(c, (CauseSet{1, 2, 3}));
+    EXPECT_NE(c, a);
+    EXPECT_EQ(CauseSet_Union(a, empty), a);
+    size_t numInterned = CauseSet_NumberInterned();
+    std::vector<TimeState> tss;
+    for (size_t i = 0; i < 1'000; ++i)
+    {
+        bool isUp = (i % 2) == 0;
+        tss.push_back({
+            .time = static_cast<double>(i),
+            .state = isUp,
+            .failureModeCauses = isUp ? empty : a,
+            .fragilityModeCauses = isUp ? empty : c,
+        });
+    }
+    std::vector<TimeState> combined = TimeState_Combine(tss, tss);
+    EXPECT_EQ(combined, tss);
+    EXPECT_EQ(CauseSet_NumberInterned(), numInterned);
+    EXPECT_EQ(sizeof(TimeState), 16);
+}
+
+TEST(Erin, TestCauseSetInternConcurrently)
+{
+    size_t const numThreads = 4;
+    std::vector<std::vector<uint32_t>> idsByThread(numThreads);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < numThreads; ++i)
+    {
+        threads.emplace_back(
+            [&idsByThread, i]()
+            {
+                // NOTE: enough sets to fill more than one chunk of the table
+                // while other threads read theirs
+                for (size_t j = 0; j < 5'000; ++j)
+                {
+                    CauseSet set{10'000 + j, 20'000 + (j % 7)};
+                    idsByThread[i].push_back(set.GetId());
+                    EXPECT_TRUE(set.contains(10'000 + j));
+                    EXPECT_EQ(set.size(), 2);
+                }
+            }
+        );
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    for (size_t i = 1; i < numThreads; ++i)
+    {
+        EXPECT_EQ(idsByThread[i], idsByThread[0]);
+    }
+}
+
 TEST(Erin, Test22)
 {
     TabularFragilityCurve tfc{};
@@ -2339,3 +2545,435 @@ TEST(Erin, TestApplyUniformTimeStep)
     EXPECT_EQ(modified_results[14].StorageAmounts_J[0], kWh_as_J(1.0))
         << "incorrect storage amount";
 }
+
+TEST(Erin, TestApplyUniformTimeStepModes)
+{
+    std::vector<TimeAndFlows> results(4);
+    std::vector<double> times_s{0.0, 1'800.0, 3'600.0, 7'200.0};
+    std::vector<flow_t> actuals_W{100, 300, 0, 0};
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        results[i].Time = times_s[i];
+        results[i].Flows.resize(1);
+        results[i].Flows[0].Actual_W = actuals_W[i];
+        results[i].Flows[0].Available_W = max_flow_W;
+        results[i].StorageAmounts_J = {static_cast<flow_t>(i == 3 ? 1000 : 0)};
+    }
+    auto means = ApplyUniformTimeStep(results, 1.0, ResampleMode::Mean);
+    ASSERT_EQ(means.size(), 3);
+    EXPECT_EQ(means[0].Flows[0].Actual_W, 100);
+    EXPECT_EQ(means[1].Time, 3'600.0);
+    EXPECT_EQ(means[1].Flows[0].Actual_W, 200);
+    EXPECT_EQ(means[1].Flows[0].Available_W, max_flow_W);
+    EXPECT_EQ(means[2].Flows[0].Actual_W, 0);
+    EXPECT_EQ(means[2].StorageAmounts_J[0], 1000);
+    auto energies = ApplyUniformTimeStep(results, 1.0, ResampleMode::Energy);
+    ASSERT_EQ(energies.size(), 3);
+    EXPECT_EQ(energies[0].Flows[0].Actual_W, 0);
+    EXPECT_EQ(energies[1].Flows[0].Actual_W, 720'000);
+    auto maxima = ApplyUniformTimeStep(results, 1.0, ResampleMode::Max);
+    ASSERT_EQ(maxima.size(), 3);
+    EXPECT_EQ(maxima[1].Flows[0].Actual_W, 300);
+    EXPECT_EQ(maxima[2].Flows[0].Actual_W, 0);
+    auto samples = ApplyUniformTimeStep(results, 1.0);
+    ASSERT_EQ(samples.size(), 3);
+    EXPECT_EQ(samples[1].Flows[0].Actual_W, 0);
+    EXPECT_EQ(TagToResampleMode("energy"), ResampleMode::Energy);
+    EXPECT_FALSE(TagToResampleMode("median").has_value());
+}
+
+TEST(Erin, TestStreamingStats)
+{
+    std::vector<double> values{2.0, 4.0, 4.0, 4.0, 5.0, 5.0, 7.0, 9.0};
+    StreamingStats ss{};
+    for (double v : values)
+    {
+        StreamingStats_Add(ss, v);
+    }
+    EXPECT_EQ(ss.Count, values.size());
+    EXPECT_NEAR(ss.Mean, 5.0, 1e-12);
+    EXPECT_NEAR(StreamingStats_Variance(ss), 32.0 / 7.0, 1e-12);
+    double z = ConfidenceLevelToZScore(0.95);
+    EXPECT_NEAR(z, 1.959964, 1e-6);
+    EXPECT_NEAR(ConfidenceLevelToZScore(0.99), 2.575829, 1e-6);
+    double halfWidth = StreamingStats_HalfWidth(ss, z);
+    EXPECT_NEAR(halfWidth, z * std::sqrt((32.0 / 7.0) / 8.0), 1e-12);
+    EXPECT_FALSE(StreamingStats_IsConverged(ss, z, 0.1));
+    EXPECT_TRUE(StreamingStats_IsConverged(ss, z, 0.5));
+    StreamingStats constant{};
+    StreamingStats_Add(constant, 1.0);
+    EXPECT_FALSE(StreamingStats_IsConverged(constant, z, 0.01));
+    StreamingStats_Add(constant, 1.0);
+    EXPECT_TRUE(StreamingStats_IsConverged(constant, z, 0.01));
+}
+
+TEST(Erin, TestSimulateFromBaselineSnapshot)
+{
+    std::vector<TimeAndAmount> timesAndLoads = {};
+    for (size_t i = 0; i < 10; ++i)
+    {
+        timesAndLoads.push_back(
+            {static_cast<double>(i) * 10.0, static_cast<flow_t>(5 + (i % 3))}
+        );
+    }
+    Model m = {};
+    m.FinalTime = 100.0;
+    auto srcId = Model_AddConstantSource(m, 4);
+    auto storeId = Model_AddStore(m, 100, 10, 10, 0, 100);
+    auto convId = Model_AddConstantEfficiencyConverter(m, 1, 1);
+    auto loadId = Model_AddScheduleBasedLoad(m, timesAndLoads);
+    Model_AddConnection(m, srcId, 0, storeId, 0);
+    Model_AddConnection(m, storeId, 0, convId.Id, 0);
+    Model_AddConnection(m, convId.Id, 0, loadId, 0);
+    BaselineSimulation baseline{};
+    baseline.SnapshotInterval_s = 25.0;
+    BaselineSimulation_AdvanceTo(baseline, m, infinity);
+    EXPECT_TRUE(baseline.IsFinished);
+    auto expectedBaseline = Simulate(m, false);
+    ASSERT_EQ(baseline.Results.size(), expectedBaseline.size());
+    for (size_t i = 0; i < expectedBaseline.size(); ++i)
+    {
+        EXPECT_EQ(baseline.Results[i].Time, expectedBaseline[i].Time);
+        EXPECT_EQ(
+            baseline.Results[i].StorageAmounts_J,
+            expectedBaseline[i].StorageAmounts_J
+        );
+    }
+    EXPECT_GT(baseline.Snapshots.size(), 1);
+    // fail the converter from 55 s to 72 s
+    TimeState down{};
+    down.time = 55.0;
+    down.state = false;
+    TimeState up{};
+    up.time = 72.0;
+    up.state = true;
+    ScheduleBasedReliability sbr{};
+    sbr.ComponentId = convId.Id;
+    sbr.TimeStates = {down, up};
+    m.Reliabilities.push_back(sbr);
+    auto expected = Simulate(m, false);
+    SimulationSnapshot const* snapshot =
+        BaselineSimulation_FindSnapshot(baseline, down.time);
+    ASSERT_TRUE(snapshot != nullptr);
+    EXPECT_LT(snapshot->Time, down.time);
+    EXPECT_GT(snapshot->Time, 0.0);
+    auto actual = Simulate_FromSnapshot(m, *snapshot, baseline.Results);
+    ASSERT_EQ(actual.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+        EXPECT_EQ(actual[i].Time, expected[i].Time);
+        EXPECT_EQ(actual[i].StorageAmounts_J, expected[i].StorageAmounts_J);
+        ASSERT_EQ(actual[i].Flows.size(), expected[i].Flows.size());
+        for (size_t j = 0; j < expected[i].Flows.size(); ++j)
+        {
+            EXPECT_EQ(
+                actual[i].Flows[j].Actual_W, expected[i].Flows[j].Actual_W
+            );
+            EXPECT_EQ(
+                actual[i].Flows[j].Requested_W,
+                expected[i].Flows[j].Requested_W
+            );
+            EXPECT_EQ(
+                actual[i].Flows[j].Available_W,
+                expected[i].Flows[j].Available_W
+            );
+        }
+    }
+}
+
+TEST(Erin, TestProjectedCaptureKeepsFullStats)
+{
+    std::vector<TimeAndAmount> timesAndLoads = {};
+    for (size_t i = 0; i < 10; ++i)
+    {
+        timesAndLoads.push_back(
+            {static_cast<double>(i) * 10.0, static_cast<flow_t>(5 + (i % 3))}
+        );
+    }
+    Model m = {};
+    m.FinalTime = 100.0;
+    auto srcId = Model_AddConstantSource(m, 4);
+    auto storeId = Model_AddStore(m, 100, 10, 10, 0, 100);
+    auto convId = Model_AddConstantEfficiencyConverter(m, 1, 1);
+    auto loadId = Model_AddScheduleBasedLoad(m, timesAndLoads);
+    Model_AddConnection(m, srcId, 0, storeId, 0);
+    Model_AddConnection(m, storeId, 0, convId.Id, 0);
+    Model_AddConnection(m, convId.Id, 0, loadId, 0);
+    FlowDict flowDict{};
+    flowDict.Type = {"electricity"};
+    size_t loadConnId = m.Connections.size();
+    for (size_t connId = 0; connId < m.Connections.size(); ++connId)
+    {
+        if (m.Connections[connId].ToId == loadId)
+        {
+            loadConnId = connId;
+        }
+    }
+    ASSERT_LT(loadConnId, m.Connections.size());
+    auto full = Simulate(m, false);
+    auto expectedStats = ModelResults_CalculateScenarioOccurrenceStats(
+        0, 1, m, flowDict, full
+    );
+    ResultProjection projection{};
+    projection.ConnIds = {loadConnId};
+    OccurrenceStatsAccumulator stats{};
+    ResultCapture capture{};
+    capture.Projection = &projection;
+    capture.Stats = &stats;
+    auto projected = Simulate(m, false, true, Log{}, capture);
+    ASSERT_EQ(projected.size(), full.size());
+    for (size_t i = 0; i < full.size(); ++i)
+    {
+        EXPECT_EQ(projected[i].Time, full[i].Time);
+        ASSERT_EQ(projected[i].Flows.size(), 1);
+        EXPECT_EQ(
+            projected[i].Flows[0].Actual_W, full[i].Flows[loadConnId].Actual_W
+        );
+        EXPECT_TRUE(projected[i].StorageAmounts_J.empty());
+    }
+    auto actualStats =
+        OccurrenceStatsAccumulator_Finish(stats, 0, 1, m, flowDict);
+    EXPECT_EQ(actualStats.Duration_s, expectedStats.Duration_s);
+    EXPECT_EQ(actualStats.Inflow_kJ, expectedStats.Inflow_kJ);
+    EXPECT_EQ(actualStats.OutflowAchieved_kJ, expectedStats.OutflowAchieved_kJ);
+    EXPECT_EQ(actualStats.LoadNotServed_kJ, expectedStats.LoadNotServed_kJ);
+    EXPECT_EQ(actualStats.StorageCharge_kJ, expectedStats.StorageCharge_kJ);
+    EXPECT_EQ(
+        actualStats.StorageDischarge_kJ, expectedStats.StorageDischarge_kJ
+    );
+    EXPECT_EQ(actualStats.ChangeInStorage_kJ, expectedStats.ChangeInStorage_kJ);
+    EXPECT_EQ(actualStats.Uptime_s, expectedStats.Uptime_s);
+    EXPECT_EQ(actualStats.MaxSEDT_s, expectedStats.MaxSEDT_s);
+    EXPECT_GT(expectedStats.StorageDischarge_kJ, 0.0);
+    // resuming from a baseline snapshot picks up the statistics so far
+    BaselineSimulation baseline{};
+    baseline.SnapshotInterval_s = 25.0;
+    baseline.Projection = &projection;
+    BaselineSimulation_AdvanceTo(baseline, m, infinity);
+    SimulationSnapshot const* snapshot =
+        BaselineSimulation_FindSnapshot(baseline, 60.0);
+    ASSERT_TRUE(snapshot != nullptr);
+    OccurrenceStatsAccumulator resumedStats{};
+    capture.Stats = &resumedStats;
+    auto resumed = Simulate_FromSnapshot(
+        m, *snapshot, baseline.Results, false, true, Log{}, capture
+    );
+    ASSERT_EQ(resumed.size(), full.size());
+    auto resumedFinal =
+        OccurrenceStatsAccumulator_Finish(resumedStats, 0, 1, m, flowDict);
+    EXPECT_EQ(resumedFinal.Inflow_kJ, expectedStats.Inflow_kJ);
+    EXPECT_EQ(
+        resumedFinal.OutflowAchieved_kJ, expectedStats.OutflowAchieved_kJ
+    );
+    EXPECT_EQ(
+        resumedFinal.ChangeInStorage_kJ, expectedStats.ChangeInStorage_kJ
+    );
+}
+
+TEST(Erin, TestModelReduceKeepsFlows)
+{
+    Model m = {};
+    m.FinalTime = 100.0;
+    auto src = Model_AddScheduleBasedSource(
+        m, {{0.0, 100}, {20.0, 30}, {40.0, 5}, {60.0, 200}}
+    );
+    std::vector<size_t> pts{};
+    for (flow_t maxOutflow_W : {max_flow_W, flow_t{70}, max_flow_W})
+    {
+        size_t ptId = Model_AddPassThrough(m);
+        m.PassThroughs[m.ComponentMap.Idx[ptId]].MaxOutflow_W = maxOutflow_W;
+        pts.push_back(ptId);
+    }
+    std::vector<size_t> convs{};
+    for (double efficiency : {0.9, 0.73, 0.95})
+    {
+        convs.push_back(Model_AddConstantEfficiencyConverter(m, efficiency).Id);
+    }
+    m.ConstEffConvs[m.ComponentMap.Idx[convs[1]]].MaxOutflow_W = 45;
+    auto load = Model_AddScheduleBasedLoad(
+        m, {{0.0, 10}, {10.0, 37}, {30.0, 60}, {50.0, 3}, {70.0, 90}}
+    );
+    Model_AddConnection(m, src.Id, 0, pts[0], 0);
+    Model_AddConnection(m, pts[0], 0, pts[1], 0);
+    Model_AddConnection(m, pts[1], 0, pts[2], 0);
+    Model_AddConnection(m, pts[2], 0, convs[0], 0);
+    Model_AddConnection(m, convs[0], 0, convs[1], 0);
+    Model_AddConnection(m, convs[1], 0, convs[2], 0);
+    Model_AddConnection(m, convs[2], 0, load, 0);
+    Model reduced = m;
+    EXPECT_EQ(Model_Reduce(reduced, {}), 4);
+    EXPECT_EQ(reduced.ReducedChains.size(), 2);
+    Model failing = m;
+    EXPECT_EQ(Model_Reduce(failing, {pts[1], convs[2]}), 1);
+    auto expected = Simulate(m, false);
+    auto actual = Simulate(reduced, false);
+    ASSERT_EQ(actual.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+        EXPECT_EQ(actual[i].Time, expected[i].Time);
+        ASSERT_EQ(actual[i].Flows.size(), expected[i].Flows.size());
+        for (size_t j = 0; j < expected[i].Flows.size(); ++j)
+        {
+            EXPECT_EQ(
+                actual[i].Flows[j].Actual_W, expected[i].Flows[j].Actual_W
+            );
+            EXPECT_EQ(
+                actual[i].Flows[j].Requested_W,
+                expected[i].Flows[j].Requested_W
+            );
+            EXPECT_EQ(
+                actual[i].Flows[j].Available_W,
+                expected[i].Flows[j].Available_W
+            );
+        }
+    }
+}
+
+TEST(Erin, TestMergeLoadsKeepsFlows)
+{
+    Model m = {};
+    m.FinalTime = 60.0;
+    auto src = Model_AddScheduleBasedSource(
+        m, {{0.0, 100}, {15.0, 20}, {35.0, 60}, {50.0, 200}}
+    );
+    auto mux = Model_AddMux(m, 1, 5);
+    m.Muxes[m.ComponentMap.Idx[mux]].MaxOutflows_W[0] = 50;
+    std::vector<size_t> loads{};
+    loads.push_back(Model_AddScheduleBasedLoad(m, {{0.0, 20}, {45.0, 5}}));
+    loads.push_back(
+        Model_AddScheduleBasedLoad(m, {{0.0, 10}, {10.0, 20}, {30.0, 5}})
+    );
+    loads.push_back(
+        Model_AddScheduleBasedLoad(m, {{0.0, 15}, {20.0, 15}, {40.0, 0}})
+    );
+    loads.push_back(
+        Model_AddScheduleBasedLoad(m, {{0.0, 30}, {10.0, 0}, {25.0, 40}})
+    );
+    loads.push_back(Model_AddConstantLoad(m, 12));
+    Model_AddConnection(m, src.Id, 0, mux, 0);
+    for (size_t port = 0; port < loads.size(); ++port)
+    {
+        Model_AddConnection(m, mux, port, loads[port], 0);
+    }
+    Model merged = m;
+    EXPECT_EQ(Model_MergeLoads(merged, {}), 2);
+    ASSERT_EQ(merged.LoadMerges.size(), 1);
+    EXPECT_EQ(merged.Muxes[merged.ComponentMap.Idx[mux]].NumOutports, 3);
+    Model failing = m;
+    EXPECT_EQ(Model_MergeLoads(failing, {loads[2]}), 0);
+    auto expected = Simulate(m, false);
+    auto actual = Simulate(merged, false);
+    ASSERT_EQ(actual.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+        EXPECT_EQ(actual[i].Time, expected[i].Time);
+        ASSERT_EQ(actual[i].Flows.size(), expected[i].Flows.size());
+        for (size_t j = 0; j < expected[i].Flows.size(); ++j)
+        {
+            EXPECT_EQ(
+                actual[i].Flows[j].Actual_W, expected[i].Flows[j].Actual_W
+            );
+            EXPECT_EQ(
+                actual[i].Flows[j].Requested_W,
+                expected[i].Flows[j].Requested_W
+            );
+            EXPECT_EQ(
+                actual[i].Flows[j].Available_W,
+                expected[i].Flows[j].Available_W
+            );
+        }
+    }
+}
+
+TEST(Erin, TestTimeAndAmountCompact)
+{
+    std::vector<TimeAndAmount> series{
+        {0.0, 5}, {1.0, 5}, {2.0, 7}, {3.0, 7}, {4.0, 7}, {5.0, 0}, {6.0, 0}
+    };
+    EXPECT_EQ(TimeAndAmount_Compact(series), 4);
+    std::vector<TimeAndAmount> expected{{0.0, 5}, {2.0, 7}, {5.0, 0}};
+    EXPECT_EQ(series, expected);
+    EXPECT_EQ(TimeAndAmount_Compact(series), 0);
+    std::vector<TimeAndAmount> empty{};
+    EXPECT_EQ(TimeAndAmount_Compact(empty), 0);
+}
+
+TEST(Erin, TestCompactSchedulesKeepsLoadIds)
+{
+    Simulation s{};
+    std::vector<TimeAndAmount> irregular{{0.0, 5}, {1.0, 5}, {3.0, 0}};
+    size_t irregularId =
+        Simulation_RegisterLoadSchedule(s, "irregular", irregular);
+    std::vector<TimeAndAmount> mostlyFlat{};
+    for (size_t i = 0; i < 6; ++i)
+    {
+        flow_t amount_W = i < 5 ? 5 : 0;
+        mostlyFlat.push_back({static_cast<double>(i) * 3'600.0, amount_W});
+    }
+    size_t flatId = Simulation_RegisterLoadSchedule(s, "flat", mostlyFlat);
+    std::vector<TimeAndAmount> varied{
+        {0.0, 5}, {3'600.0, 5}, {7'200.0, 7}, {10'800.0, 0}
+    };
+    size_t variedId = Simulation_RegisterLoadSchedule(s, "varied", varied);
+    Model_AddScheduleBasedLoad(s.TheModel, irregular, {{0, irregularId}});
+    ScheduleCompaction compaction = Simulation_CompactSchedules(s);
+    EXPECT_EQ(compaction.NumEntries, 13);
+    EXPECT_EQ(compaction.NumEntriesRemoved, 5);
+    EXPECT_EQ(compaction.NumUniformSchedulesKept, 1);
+    EXPECT_EQ(
+        s.TheModel.ScheduledLoads[0].ScenarioIdToLoadId.at(0), irregularId
+    );
+    std::optional<size_t> maybeFlatId = Simulation_GetLoadIdByTag(s, "flat");
+    ASSERT_TRUE(maybeFlatId.has_value());
+    ASSERT_EQ(maybeFlatId.value(), flatId);
+    std::vector<TimeAndAmount> expectedIrregular{{0.0, 5}, {3.0, 0}};
+    EXPECT_EQ(
+        AmountSchedule_ToEntries(s.LoadMap.Loads[irregularId]),
+        expectedIrregular
+    );
+    std::vector<TimeAndAmount> expectedFlat{{0.0, 5}, {18'000.0, 0}};
+    EXPECT_EQ(AmountSchedule_ToEntries(s.LoadMap.Loads[flatId]), expectedFlat);
+    // NOTE: compacting would only remove one of four uniform entries
+    EXPECT_TRUE(AmountSchedule_IsUniform(s.LoadMap.Loads[variedId]));
+    EXPECT_EQ(AmountSchedule_ToEntries(s.LoadMap.Loads[variedId]), varied);
+}
+
+TEST(Erin, TestAmountScheduleUniformForm)
+{
+    std::vector<TimeAndAmount> hourly{
+        {0.0, 5}, {3600.0, 7}, {7200.0, 7}, {10800.0, 0}
+    };
+    AmountSchedule uniform = AmountSchedule_Make(hourly);
+    EXPECT_TRUE(AmountSchedule_IsUniform(uniform));
+    EXPECT_TRUE(uniform.Entries.empty());
+    EXPECT_EQ(AmountSchedule_Size(uniform), 4);
+    EXPECT_EQ(AmountSchedule_TimeAt(uniform, 3), 10800.0);
+    EXPECT_EQ(AmountSchedule_AmountAt(uniform, 1), 7);
+    EXPECT_EQ(AmountSchedule_ToEntries(uniform), hourly);
+    std::vector<TimeAndAmount> irregular{{0.0, 5}, {3600.0, 7}, {9000.0, 0}};
+    AmountSchedule other = AmountSchedule_Make(irregular);
+    EXPECT_FALSE(AmountSchedule_IsUniform(other));
+    EXPECT_EQ(AmountSchedule_Size(other), 3);
+    EXPECT_EQ(AmountSchedule_TimeAt(other, 2), 9000.0);
+    EXPECT_EQ(AmountSchedule_ToEntries(other), irregular);
+    EXPECT_FALSE(AmountSchedule_IsUniform(AmountSchedule_Make({{0.0, 1}})));
+}
+
+TEST(Erin, TestAmountScheduleCoarsen)
+{
+    AmountSchedule hourly = AmountSchedule_Make(
+        {{0.0, 10}, {3600.0, 20}, {7200.0, 30}, {10800.0, 0}, {14400.0, 0}}
+    );
+    std::vector<TimeAndAmount> mean =
+        AmountSchedule_Coarsen(hourly, 7200.0, ResampleMode::Mean);
+    std::vector<TimeAndAmount> expectedMean{
+        {0.0, 15}, {7200.0, 15}, {14400.0, 0}
+    };
+    EXPECT_EQ(mean, expectedMean);
+    std::vector<TimeAndAmount> max =
+        AmountSchedule_Coarsen(hourly, 7200.0, ResampleMode::Max);
+    std::vector<TimeAndAmount> expectedMax{
+        {0.0, 20}, {7200.0, 30}, {14400.0, 0}
+    };
+    EXPECT_EQ(max, expectedMax);
+}